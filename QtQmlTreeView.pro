@@ -1,34 +1,6 @@
-QT += quick
+TEMPLATE = subdirs
 
-CONFIG += c++11
-
-# You can make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-SOURCES += \
-        main.cpp \
-        model/TreeModel.cpp \
-        model/TreeNode.cpp
-
-RESOURCES += qml.qrc
-
-# Additional import path used to resolve QML modules in Qt Creator's code model
-QML_IMPORT_PATH =
-
-# Additional import path used to resolve QML modules just for Qt Quick Designer
-QML_DESIGNER_IMPORT_PATH =
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
-
-HEADERS += \
-    model/TreeModel.h \
-    model/TreeNode.h
-
-# Copying test.json JSON file to the build directory
-DISTFILES += data/test.json
-
-QMAKE_POST_LINK += cp $$PWD/data/test.json $$OUT_PWD/
+SUBDIRS += \
+    app \
+    benchmarks \
+    tests
@@ -0,0 +1,77 @@
+#include <QGuiApplication>
+#include <QQmlApplicationEngine>
+#include <QQmlContext>
+#include "TreeModel.h"
+#include "TreeFilterProxyModel.h"
+#include "TreeListModel.h"
+
+// dummy data of some fruits nested in categories, prices and attributes
+// used for initial testing of tree.
+// Later on, we will be populating tree with the data from JSON file.
+TreeNode* setupFruitsTreeModelData(TreeNodeArena &arena)
+{
+    TreeNode* rootNode = arena.create("Fruits", QVariant());
+
+    // adding citrus category with its child nodes
+    TreeNode *citrusCategory = arena.create("Citrus", 1, rootNode);
+    citrusCategory->appendChild(arena.create("Apple", 2, citrusCategory));
+    citrusCategory->appendChild(arena.create("Orange", 3, citrusCategory));
+
+    TreeNode* kiwiNode = arena.create("Kiwi", QVariant(), citrusCategory);
+    kiwiNode->appendChild(arena.create("Type 1", "Expensive", kiwiNode));
+    kiwiNode->appendChild(arena.create("Type 2", "Cool", kiwiNode));
+
+    citrusCategory->appendChild(kiwiNode);
+    rootNode->appendChild(citrusCategory);
+
+    // adding berries category with its child nodes
+    TreeNode *berryCategory = arena.create("Berries", QVariant(), rootNode);
+    berryCategory->appendChild(arena.create("Strawberry", 1.5, berryCategory));
+    berryCategory->appendChild(arena.create("Blueberry", "Detox", berryCategory));
+    berryCategory->appendChild(arena.create("Raspberry", "Smoothies", berryCategory));
+    rootNode->appendChild(berryCategory);
+
+    // adding drupes category with its child nodes
+    TreeNode *drupesCategory = arena.create("Drupes", QVariant(), rootNode);
+    drupesCategory->appendChild(arena.create("Plums", 12, drupesCategory));
+    drupesCategory->appendChild(arena.create("Peaches", "Hot", drupesCategory));
+    drupesCategory->appendChild(arena.create("Olives", "Subway", drupesCategory));
+    rootNode->appendChild(drupesCategory);
+
+    return rootNode;
+}
+
+int main(int argc, char *argv[])
+{
+#if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    QCoreApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
+#endif
+
+    QGuiApplication app(argc, argv);
+    QQmlApplicationEngine engine;
+
+    // loading on a worker thread, so that the window shows up right away
+    // even for large JSON files, and building child nodes only when expanded;
+    // the descendant count, size and type of every node are shown as columns
+    TreeModel treeModel("./test.json", TreeModel::Asynchronous | TreeModel::Lazy | TreeModel::Cached
+                                          | TreeModel::Watched | TreeModel::Aggregates);
+    engine.rootContext()->setContextProperty("treeModel", &treeModel);
+
+    // the TreeView shows the model through the search filter
+    TreeFilterProxyModel treeFilter(&treeModel);
+    engine.rootContext()->setContextProperty("treeFilter", &treeFilter);
+
+    // the same tree as a flat list of the visible rows, for the ListView
+    TreeListModel treeList(&treeModel);
+    engine.rootContext()->setContextProperty("treeList", &treeList);
+
+    const QUrl url(QStringLiteral("qrc:/main.qml"));
+    QObject::connect(&engine, &QQmlApplicationEngine::objectCreated,
+                     &app, [url](QObject *obj, const QUrl &objUrl) {
+        if (!obj && url == objUrl)
+            QCoreApplication::exit(-1);
+    }, Qt::QueuedConnection);
+    engine.load(url);
+
+    return app.exec();
+}
@@ -0,0 +1,346 @@
+import QtQuick
+import QtQuick.Controls
+
+ApplicationWindow {
+    visible: true
+    width: 1200
+    height: 800
+
+    property int margin: 10
+    property int _currentRow: -1
+    property int _currentCol: -1
+    property var _curValue
+
+    TextField {
+        id: tf
+        x: margin
+        y: margin
+        width: 200
+        height: 40
+        placeholderText: "Type name here"
+        font.pixelSize: 16
+        anchors.horizontalCenter: parent.horizontalCenter
+    }
+
+    // filters the tree down to matching nodes and their ancestors
+    TextField {
+        id: searchField
+        x: margin
+        y: margin
+        width: 200
+        height: 40
+        placeholderText: "Search"
+        font.pixelSize: 16
+        onTextChanged: treeFilter.filterText = text
+    }
+
+    Label {
+        anchors.left: searchField.right
+        anchors.leftMargin: margin
+        y: searchField.y
+        height: searchField.height
+        verticalAlignment: Text.AlignVCenter
+        visible: searchField.text.length > 0
+        text: treeFilter.matchCount + " matches"
+    }
+
+    Button
+    {
+        y: tf.y
+        x: tf.x + tf.width + margin
+
+        width: 60
+        height: 40
+        text: "Save"
+        enabled: !treeModel.readOnly
+        onClicked: {
+            if (_currentRow === -1 || _currentCol === -1) {
+                return;
+            }
+
+            // index of node to be edited
+            let editIndex = treeView.index(_currentRow, _currentCol)
+
+            if (typeof _curValue === "boolean") {
+                treeFilter.setData(editIndex, tf.text.toLowerCase() === 'true' ? true : false, 1)
+                return;
+            }
+
+            if (typeof _curValue === "number") {
+                // checking for floating point or interger type
+                // NOTE - in QML, we use modulus operator to differentiate between number and float
+                if (_curValue % 1 !== 0) { // its float
+                    treeFilter.setData(editIndex, parseFloat(tf.text), 1)
+                } else { // its number
+                    treeFilter.setData(editIndex, parseInt(tf.text), 1)
+                }
+                return;
+            }
+
+            // we are defaulting to string type, we will handle more types later, if needed
+            treeFilter.setData(editIndex, tf.text, 1)
+        }
+    }
+
+    // edits are written behind, this shows whether they reached the file yet
+    Label {
+        id: saveState
+        anchors.right: parent.right
+        anchors.rightMargin: margin
+        y: tf.y
+        height: tf.height
+        verticalAlignment: Text.AlignVCenter
+        text: treeModel.saving ? "Saving..." : (treeModel.dirty ? "Unsaved changes" : "")
+    }
+
+    // switches between the TreeView and a flat ListView of the same rows
+    Switch {
+        id: flatList
+        anchors.right: saveState.left
+        anchors.rightMargin: margin
+        y: tf.y
+        height: tf.height
+        text: "Flat list"
+    }
+
+    // shown while the JSON file is being loaded in the background
+    Row {
+        id: loadingBar
+        x: tf.x + tf.width + 60 + 2 * margin
+        y: tf.y
+        height: tf.height
+        spacing: margin
+        visible: treeModel.loading
+
+        ProgressBar {
+            anchors.verticalCenter: parent.verticalCenter
+            width: 200
+            from: 0
+            to: 100
+            value: treeModel.progress
+        }
+
+        Button {
+            width: 80
+            height: parent.height
+            text: "Cancel"
+            onClicked: treeModel.cancelLoading()
+        }
+    }
+
+    // debug overlay with the model's call stats and the frame time, toggled with F12
+    Shortcut {
+        sequence: "F12"
+        onActivated: statsOverlay.visible = !statsOverlay.visible
+    }
+
+    Rectangle {
+        id: statsOverlay
+        z: 1
+        visible: false
+        anchors.right: parent.right
+        anchors.bottom: parent.bottom
+        anchors.margins: margin
+        width: statsText.implicitWidth + 2 * margin
+        height: statsText.implicitHeight + 2 * margin
+        color: "#d0000000"
+        radius: 4
+
+        property real frameTime: 0
+
+        // smoothed, so that slow delegates show up next to slow model calls
+        FrameAnimation {
+            running: statsOverlay.visible
+            onTriggered: statsOverlay.frameTime = statsOverlay.frameTime * 0.9 + frameTime * 100
+        }
+
+        function describe(stats) {
+            let lines = ["frame: " + frameTime.toFixed(1) + " ms"]
+            for (let name in stats) {
+                let entry = stats[name]
+                if (name === "phases") {
+                    for (let phase in entry) {
+                        lines.push(phase + ": " + entry[phase] + " ms")
+                    }
+                } else if (entry.calls > 0) {
+                    lines.push(name + ": " + entry.calls + " calls, avg "
+                               + Math.round(entry.totalNs / entry.calls) + " ns, p99 < " + entry.p99Ns + " ns")
+                }
+            }
+            if (!("data" in stats)) {
+                lines.push("call stats: build with qmake CONFIG+=instrumentation")
+            }
+            return lines.join("\n")
+        }
+
+        Text {
+            id: statsText
+            x: margin
+            y: margin
+            color: "white"
+            font.family: "monospace"
+            text: statsOverlay.describe(treeModel.stats)
+        }
+
+        TapHandler {
+            onDoubleTapped: treeModel.resetStats()
+        }
+    }
+
+    TreeView {
+        id: treeView
+        visible: !flatList.checked
+        y: tf.y + tf.height + margin
+        x: margin
+        width: parent.width
+        height: parent.height - tf.height - tf.y - margin
+        anchors.margins: 10
+        clip: true
+
+        selectionModel: ItemSelectionModel {}
+
+        model: treeFilter
+
+        delegate: Item {
+            implicitWidth: padding + label.x + label.implicitWidth + padding
+            implicitHeight: label.implicitHeight * 1.5
+
+            readonly property real indentation: 20
+            readonly property real padding: 5
+
+            // Assigned to by TreeView:
+            required property TreeView treeView
+            required property bool isTreeNode
+            required property bool expanded
+            required property bool hasChildren
+            required property int depth
+            required property int row
+            required property int column
+            required property bool current
+
+            // Rotate indicator when expanded by the user
+            // (requires TreeView to have a selectionModel)
+            property Animation indicatorAnimation: NumberAnimation {
+                target: indicator
+                property: "rotation"
+                from: expanded ? 0 : 90
+                to: expanded ? 90 : 0
+                duration: 100
+                easing.type: Easing.OutQuart
+            }
+            TableView.onPooled: indicatorAnimation.complete()
+            TableView.onReused: if (current) indicatorAnimation.start()
+            onExpandedChanged: indicator.rotation = expanded ? 90 : 0
+
+            Rectangle {
+                id: background
+                anchors.fill: parent
+                color: row == treeView.currentRow ? palette.highlight : "black"
+                opacity: (treeView.alternatingRows && row % 2 !== 0) ? 0.3 : 0.1
+            }
+
+            Label {
+                id: indicator
+                x: padding + (depth * indentation)
+                anchors.verticalCenter: parent.verticalCenter
+                visible: isTreeNode && hasChildren
+                text: "▶"
+
+                TapHandler {
+                    onSingleTapped: {
+                        let index = treeView.index(row, column)
+                        treeView.selectionModel.setCurrentIndex(index, ItemSelectionModel.NoUpdate)
+                        treeView.toggleExpanded(row)
+                    }
+                }
+            }
+
+            Label {
+                id: label
+                x: padding + (isTreeNode ? (depth + 1) * indentation : 0)
+                anchors.verticalCenter: parent.verticalCenter
+                width: parent.width - padding - x
+                clip: true
+                // array elements have no name, containers among them show their index
+                // (taken from the source model, as filtering leaves gaps in the rows);
+                // the other columns show the descendant count, size and type
+                text: column > 0 ? model.value
+                                 : model.name ? model.name
+                                              : (hasChildren ? "[" + treeFilter.mapToSource(treeView.index(row, column)).row + "]"
+                                                             : model.value)
+
+                MouseArea {
+                    anchors.fill: parent
+                    onClicked: {
+                        // we will only set the text for leaf nodes for editing
+                        if(!hasChildren && column === 0) {
+                            tf.text = model.value
+                            _currentRow = row
+                            _currentCol = column
+                            _curValue = model.value
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // the visible rows of the tree as a plain list, expanding a node with
+    // many descendants inserts its rows in one step (see TreeListModel)
+    ListView {
+        id: listView
+        visible: flatList.checked
+        x: treeView.x
+        y: treeView.y
+        width: treeView.width
+        height: treeView.height
+        clip: true
+        reuseItems: true
+
+        model: flatList.checked ? treeList : null
+
+        delegate: Item {
+            width: ListView.view.width
+            implicitHeight: listLabel.implicitHeight * 1.5
+
+            readonly property real indentation: 20
+            readonly property real padding: 5
+
+            required property int index
+            required property string name
+            required property var value
+            required property int depth
+            required property bool expanded
+            required property bool hasChildren
+            required property int childIndex
+
+            Rectangle {
+                anchors.fill: parent
+                color: "black"
+                opacity: index % 2 !== 0 ? 0.3 : 0.1
+            }
+
+            Label {
+                id: listIndicator
+                x: padding + (depth * indentation)
+                anchors.verticalCenter: parent.verticalCenter
+                visible: hasChildren
+                rotation: expanded ? 90 : 0
+                text: "▶"
+
+                TapHandler {
+                    onSingleTapped: treeList.toggleExpanded(index)
+                }
+            }
+
+            Label {
+                id: listLabel
+                x: padding + (depth + 1) * indentation
+                anchors.verticalCenter: parent.verticalCenter
+                width: parent.width - padding - x
+                clip: true
+                text: name ? name : (hasChildren ? "[" + childIndex + "]" : value)
+            }
+        }
+    }
+}
@@ -0,0 +1,11 @@
+QT -= gui
+
+CONFIG += c++11 console
+CONFIG -= app_bundle
+
+TARGET = jsongen
+
+include(../shared/shared.pri)
+
+SOURCES += \
+        main.cpp
@@ -0,0 +1,78 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: main.cpp                                                          *
+ *                                                                             *
+ * Description:                                                                *
+ * Command line tool writing the synthetic JSON documents used by the          *
+ * benchmarks, e.g. to load them in the app.                                   *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include "JsonGenerator.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("jsongen");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes a deterministic synthetic JSON document.");
+    parser.addHelpOption();
+    parser.addOption({{"s", "shape"}, "Shape of the document: wide, deep or arrays.", "shape", "wide"});
+    parser.addOption({{"n", "nodes"}, "Approximate number of tree nodes.", "count", "100000"});
+    parser.addOption({"seed", "Seed of the generated values.", "seed", "1"});
+    parser.addPositionalArgument("file", "The JSON file to write.");
+    parser.process(app);
+
+    QTextStream err(stderr);
+    const QStringList files = parser.positionalArguments();
+    if (files.count() != 1) {
+        parser.showHelp(1);
+    }
+
+    bool ok = false;
+    const JsonGenerator::Shape shape = JsonGenerator::shapeFromName(parser.value("shape"), &ok);
+    if (!ok) {
+        err << "unknown shape: " << parser.value("shape") << Qt::endl;
+        return 1;
+    }
+
+    const qint64 nodes = parser.value("nodes").toLongLong(&ok);
+    if (!ok || nodes <= 0) {
+        err << "invalid node count: " << parser.value("nodes") << Qt::endl;
+        return 1;
+    }
+
+    JsonGenerator generator(shape, nodes, parser.value("seed").toUInt());
+    const qint64 written = generator.writeFile(files.first());
+    if (written < 0) {
+        err << "failed to write " << files.first() << Qt::endl;
+        return 1;
+    }
+
+    QTextStream(stdout) << written << " nodes written to " << files.first() << Qt::endl;
+    return 0;
+}
@@ -0,0 +1,319 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonGenerator.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the JsonGenerator class, which writes deterministic       *
+ * synthetic JSON documents for the benchmarks.                                *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cmath>
+#include <QFile>
+#include "JsonGenerator.h"
+
+// buffered output is written to the device in chunks of this size
+static const int FLUSH_SIZE = 1024 * 1024;
+
+// nesting depth of the chains in Deep documents
+static const int DEEP_DEPTH = 64;
+
+// nodes per record in ArrayOfObjects documents (the element, 6 members, 3 tags)
+static const int RECORD_NODES = 10;
+
+static const char *const WORDS[] = {
+    "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+    "india", "juliett", "kilo", "lima", "mike", "november", "oscar", "papa"
+};
+
+JsonGenerator::JsonGenerator(Shape shape, qint64 nodeCount, quint32 seed)
+    : _shape{shape},
+      _nodeCount{nodeCount},
+      _random{seed},
+      _device{nullptr},
+      _afterKey{false},
+      _written{0} {}
+
+qint64 JsonGenerator::write(QIODevice *device)
+{
+    _device = device;
+    _buffer.clear();
+    _buffer.reserve(FLUSH_SIZE + 4096);
+    _first.clear();
+    _afterKey = false;
+    _written = 0;
+
+    switch (_shape) {
+    case Wide:
+        writeWide();
+        break;
+    case Deep:
+        writeDeep();
+        break;
+    case ArrayOfObjects:
+        writeArrayOfObjects();
+        break;
+    }
+
+    flush();
+    _device = nullptr;
+    return _written;
+}
+
+qint64 JsonGenerator::writeFile(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return -1;
+    }
+
+    const qint64 written = write(&file);
+    return file.error() == QFile::NoError ? written : -1;
+}
+
+JsonGenerator::Shape JsonGenerator::shapeFromName(const QString &name, bool *ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+    if (name == QLatin1String("wide")) {
+        return Wide;
+    }
+    if (name == QLatin1String("deep")) {
+        return Deep;
+    }
+    if (name == QLatin1String("arrays")) {
+        return ArrayOfObjects;
+    }
+
+    if (ok) {
+        *ok = false;
+    }
+    return Wide;
+}
+
+QString JsonGenerator::shapeName(Shape shape)
+{
+    switch (shape) {
+    case Wide:
+        return QStringLiteral("wide");
+    case Deep:
+        return QStringLiteral("deep");
+    case ArrayOfObjects:
+        return QStringLiteral("arrays");
+    }
+    return QString();
+}
+
+void JsonGenerator::writeWide()
+{
+    const qint64 groups = qMax<qint64>(1, qint64(std::sqrt(double(_nodeCount))));
+    const qint64 members = qMax<qint64>(1, _nodeCount / groups - 1);
+
+    beginObject();
+    for (qint64 g = 0; g < groups; ++g) {
+        key("group" + QByteArray::number(g));
+        beginObject();
+        for (qint64 m = 0; m < members; ++m) {
+            key("key" + QByteArray::number(m));
+            switch (m % 4) {
+            case 0:
+                string(word());
+                break;
+            case 1:
+                number(qint64(_random.bounded(100000)));
+                break;
+            case 2:
+                boolean(_random.bounded(2) == 1);
+                break;
+            default:
+                number(_random.bounded(1000.0));
+                break;
+            }
+        }
+        endObject();
+    }
+    endObject();
+}
+
+void JsonGenerator::writeDeep()
+{
+    // chain key, then "id" and "name" on every level and "next" on all but the last
+    const qint64 chains = qMax<qint64>(1, _nodeCount / (3 * DEEP_DEPTH));
+
+    beginObject();
+    for (qint64 c = 0; c < chains; ++c) {
+        key("chain" + QByteArray::number(c));
+        beginObject();
+        for (int level = 0; level < DEEP_DEPTH; ++level) {
+            key("id");
+            number(qint64(level));
+            key("name");
+            string(word());
+            if (level < DEEP_DEPTH - 1) {
+                key("next");
+                beginObject();
+            }
+        }
+        for (int level = 0; level < DEEP_DEPTH; ++level) {
+            endObject();
+        }
+    }
+    endObject();
+}
+
+void JsonGenerator::writeArrayOfObjects()
+{
+    const qint64 records = qMax<qint64>(1, (_nodeCount - 1) / RECORD_NODES);
+
+    beginObject();
+    key("records");
+    beginArray();
+    for (qint64 r = 0; r < records; ++r) {
+        beginObject();
+        key("id");
+        number(r);
+        key("name");
+        string(word() + "-" + QByteArray::number(r));
+        key("active");
+        boolean(_random.bounded(2) == 1);
+        key("score");
+        number(_random.bounded(100.0));
+        key("tags");
+        beginArray();
+        for (int t = 0; t < 3; ++t) {
+            string(word());
+        }
+        endArray();
+        key("note");
+        null();
+        endObject();
+    }
+    endArray();
+    endObject();
+}
+
+void JsonGenerator::beginObject()
+{
+    separate();
+    _buffer.append('{');
+    _first.append(true);
+}
+
+void JsonGenerator::endObject()
+{
+    _first.removeLast();
+    _buffer.append('}');
+}
+
+void JsonGenerator::beginArray()
+{
+    separate();
+    _buffer.append('[');
+    _first.append(true);
+}
+
+void JsonGenerator::endArray()
+{
+    _first.removeLast();
+    _buffer.append(']');
+}
+
+void JsonGenerator::key(const QByteArray &name)
+{
+    if (!_first.last()) {
+        _buffer.append(',');
+    }
+    _first.last() = false;
+    _buffer.append('"').append(name).append("\":");
+    _afterKey = true;
+    ++_written;
+}
+
+void JsonGenerator::number(qint64 value)
+{
+    separate();
+    _buffer.append(QByteArray::number(value));
+}
+
+void JsonGenerator::number(double value)
+{
+    separate();
+    _buffer.append(QByteArray::number(value, 'f', 2));
+}
+
+void JsonGenerator::string(const QByteArray &value)
+{
+    // the vocabulary needs no escaping
+    separate();
+    _buffer.append('"').append(value).append('"');
+}
+
+void JsonGenerator::boolean(bool value)
+{
+    separate();
+    _buffer.append(value ? "true" : "false");
+}
+
+void JsonGenerator::null()
+{
+    separate();
+    _buffer.append("null");
+}
+
+void JsonGenerator::separate()
+{
+    if (_buffer.size() >= FLUSH_SIZE) {
+        flush();
+    }
+
+    // members were counted and separated by key()
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+
+    // the root value is not a node
+    if (_first.isEmpty()) {
+        return;
+    }
+
+    if (!_first.last()) {
+        _buffer.append(',');
+    }
+    _first.last() = false;
+    ++_written;
+}
+
+QByteArray JsonGenerator::word()
+{
+    return QByteArray(WORDS[_random.bounded(int(sizeof(WORDS) / sizeof(WORDS[0])))]);
+}
+
+void JsonGenerator::flush()
+{
+    if (!_buffer.isEmpty()) {
+        _device->write(_buffer);
+        _buffer.truncate(0);   // keeps the capacity for the next chunk
+    }
+}
@@ -0,0 +1,142 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonGenerator.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the JsonGenerator class, which writes deterministic         *
+ * synthetic JSON documents of a given shape and size for the benchmarks.      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __JSON_GENERATOR_H__
+#define __JSON_GENERATOR_H__
+
+#include <QVector>
+#include <QString>
+#include <QIODevice>
+#include <QByteArray>
+#include <QRandomGenerator>
+
+
+class JsonGenerator
+{
+public:
+    /**
+     * @brief Enum for the shapes of generated documents.
+     *
+     * - Wide: about sqrt(n) objects with about sqrt(n) scalar members each.
+     * - Deep: chains of nested objects, 64 levels deep.
+     * - ArrayOfObjects: one array of flat records, like a table export.
+     */
+    enum Shape {
+        Wide,
+        Deep,
+        ArrayOfObjects
+    };
+
+    /**
+     * @brief Constructs a generator for documents of the given shape.
+     *
+     * @param shape The shape of the document.
+     * @param nodeCount The number of tree nodes to generate, approximately.
+     * @param seed The seed; the same seed always generates the same document.
+     */
+    JsonGenerator(Shape shape, qint64 nodeCount, quint32 seed = 1);
+
+    /**
+     * @brief Writes the document to the device.
+     *
+     * The document is written in chunks as it is generated, so even documents
+     * with 1e7 nodes need little memory.
+     *
+     * @param device The device, opened for writing.
+     * @return The number of tree nodes written (members and array elements).
+     */
+    qint64 write(QIODevice *device);
+
+    /**
+     * @brief Writes the document to a file.
+     *
+     * @param filePath The path of the file, replaced if it exists.
+     * @return The number of tree nodes written, or -1 if the file could not be written.
+     */
+    qint64 writeFile(const QString &filePath);
+
+    /**
+     * @brief Returns the shape with the given name ("wide", "deep", "arrays").
+     *
+     * @param name The name.
+     * @param ok Set to false if the name is unknown, may be nullptr.
+     */
+    static Shape shapeFromName(const QString &name, bool *ok = nullptr);
+
+    /**
+     * @brief Returns the name of the shape.
+     *
+     * @param shape The shape.
+     */
+    static QString shapeName(Shape shape);
+
+private:
+    void writeWide();
+    void writeDeep();
+    void writeArrayOfObjects();
+
+    void beginObject();
+    void endObject();
+    void beginArray();
+    void endArray();
+    void key(const QByteArray &name);
+    void number(qint64 value);
+    void number(double value);
+    void string(const QByteArray &value);
+    void boolean(bool value);
+    void null();
+
+    /**
+     * @brief Writes the separator before a value and counts it as a node.
+     */
+    void separate();
+
+    /**
+     * @brief Returns a word from a small fixed vocabulary, so values repeat like in real configs.
+     */
+    QByteArray word();
+
+    /**
+     * @brief Writes the buffered output to the device.
+     */
+    void flush();
+
+    Shape _shape;
+    qint64 _nodeCount;
+    QRandomGenerator _random;
+
+    QIODevice *_device;
+    QByteArray _buffer;
+    QVector<bool> _first;   // per open container, true until it has a value
+    bool _afterKey;
+    qint64 _written;
+};
+
+#endif // __JSON_GENERATOR_H__
@@ -0,0 +1,9 @@
+# The synthetic JSON generator, shared by the generator tool and the benchmarks
+
+INCLUDEPATH += $$PWD
+
+SOURCES += \
+        $$PWD/JsonGenerator.cpp
+
+HEADERS += \
+    $$PWD/JsonGenerator.h
@@ -0,0 +1,12 @@
+QT += testlib gui concurrent
+
+CONFIG += c++11 testcase
+CONFIG -= app_bundle
+
+TARGET = tst_bench_treemodel
+
+include(../../model/model.pri)
+include(../shared/shared.pri)
+
+SOURCES += \
+        tst_bench_treemodel.cpp
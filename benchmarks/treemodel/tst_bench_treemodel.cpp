@@ -0,0 +1,898 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: tst_bench_treemodel.cpp                                           *
+ *                                                                             *
+ * Description:                                                                *
+ * Benchmarks for loading, walking, reading, editing and serializing           *
+ * TreeModel over generated JSON documents.                                    *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cmath>
+#include <QtTest>
+#include <QFile>
+#include <QBuffer>
+#include <QFileInfo>
+#include <QHash>
+#include <QVector>
+#include <QTemporaryDir>
+#include <QtConcurrent>
+#include <QGuiApplication>
+#include "JsonGenerator.h"
+#include "CompressedDevice.h"
+#include "TreeListModel.h"
+#include "TreeLoader.h"
+#include "TreeModel.h"
+
+// sizes above this are skipped unless TREEVIEW_BENCH_MAX_NODES raises it (up to 1e7)
+static const qint64 DEFAULT_MAX_NODES = 100000;
+
+// leaves edited per setData() iteration
+static const int EDITS_PER_ITERATION = 1000;
+
+Q_DECLARE_METATYPE(JsonGenerator::Shape)
+
+namespace {
+
+/**
+ * @brief Returns the largest document size to benchmark.
+ */
+qint64 maxNodes()
+{
+    bool ok = false;
+    const qint64 nodes = qEnvironmentVariable("TREEVIEW_BENCH_MAX_NODES").toLongLong(&ok);
+    return ok && nodes > 0 ? nodes : DEFAULT_MAX_NODES;
+}
+
+/**
+ * @brief Returns every index of the model in depth-first order.
+ */
+QVector<QModelIndex> allIndexes(const QAbstractItemModel &model)
+{
+    QVector<QModelIndex> indexes;
+    QVector<QModelIndex> stack{QModelIndex()};
+
+    while (!stack.isEmpty()) {
+        const QModelIndex parent = stack.takeLast();
+        for (int row = model.rowCount(parent) - 1; row >= 0; --row) {
+            const QModelIndex index = model.index(row, 0, parent);
+            indexes.append(index);
+            stack.append(index);
+        }
+    }
+    return indexes;
+}
+
+/**
+ * @brief Resets the peak resident set size of the process, if the platform allows it.
+ */
+bool resetPeakMemory()
+{
+#ifdef Q_OS_LINUX
+    QFile clearRefs("/proc/self/clear_refs");
+    return clearRefs.open(QIODevice::WriteOnly) && clearRefs.write("5") == 1;
+#else
+    return false;
+#endif
+}
+
+/**
+ * @brief Returns the peak resident set size of the process in bytes, or -1 if unknown.
+ */
+qint64 peakMemory()
+{
+#ifdef Q_OS_LINUX
+    QFile status("/proc/self/status");
+    if (status.open(QIODevice::ReadOnly)) {
+        for (const QByteArray &line : status.readAll().split('\n')) {
+            if (line.startsWith("VmHWM:")) {
+                return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+            }
+        }
+    }
+#endif
+    return -1;
+}
+
+} // namespace
+
+class tst_TreeModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void setupJsonModelData_data();
+    void setupJsonModelData();
+
+    void walk_data();
+    void walk();
+
+    void data_data();
+    void data();
+
+    void serializeTreeToJson_data();
+    void serializeTreeToJson();
+
+    void save_data();
+    void save();
+
+    void setData_data();
+    void setData();
+
+    void aggregates_data();
+    void aggregates();
+
+    void parentByWidth_data();
+    void parentByWidth();
+
+    void parser_data();
+    void parser();
+
+    void formats_data();
+    void formats();
+
+    void compression_data();
+    void compression();
+
+    void snapshot_data();
+    void snapshot();
+
+    void namePoolMemory_data();
+    void namePoolMemory();
+
+    void insertValues_data();
+    void insertValues();
+
+    void jsonLines_data();
+    void jsonLines();
+
+    void listExpand_data();
+    void listExpand();
+
+private:
+    /**
+     * @brief Adds a row per shape and size up to `maxNodes()`.
+     */
+    void addDocumentRows();
+
+    /**
+     * @brief Returns the path of the generated document, generating it on first use.
+     */
+    QString document(JsonGenerator::Shape shape, qint64 nodes);
+
+    /**
+     * @brief Returns the path of the generated document saved in the given format and compression, saving it on first use.
+     */
+    QString encodedDocument(JsonGenerator::Shape shape, qint64 nodes, DocumentFormat::Format format,
+                            DocumentFormat::Compression compression = DocumentFormat::Uncompressed);
+
+    QTemporaryDir _dir;
+    QHash<QString, QString> _documents;
+};
+
+void tst_TreeModel::initTestCase()
+{
+    QVERIFY(_dir.isValid());
+}
+
+void tst_TreeModel::addDocumentRows()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::Deep, JsonGenerator::ArrayOfObjects};
+    for (JsonGenerator::Shape shape : shapes) {
+        for (qint64 nodes = 1000; nodes <= maxNodes(); nodes *= 10) {
+            const QByteArray name = JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes);
+            QTest::newRow(name.constData()) << shape << nodes;
+        }
+    }
+}
+
+QString tst_TreeModel::document(JsonGenerator::Shape shape, qint64 nodes)
+{
+    const QString name = QStringLiteral("%1-%2.json").arg(JsonGenerator::shapeName(shape)).arg(nodes);
+    auto it = _documents.constFind(name);
+    if (it != _documents.constEnd()) {
+        return *it;
+    }
+
+    const QString path = _dir.filePath(name);
+    JsonGenerator generator(shape, nodes);
+    if (generator.writeFile(path) < 0) {
+        return QString();
+    }
+    _documents.insert(name, path);
+    return path;
+}
+
+QString tst_TreeModel::encodedDocument(JsonGenerator::Shape shape, qint64 nodes, DocumentFormat::Format format,
+                                       DocumentFormat::Compression compression)
+{
+    const QString source = document(shape, nodes);
+    if ((format == DocumentFormat::Json && compression == DocumentFormat::Uncompressed) || source.isEmpty()) {
+        return source;
+    }
+
+    QString name = QStringLiteral("%1-%2").arg(JsonGenerator::shapeName(shape)).arg(nodes);
+    switch (format) {
+    case DocumentFormat::Cbor:
+        name += QStringLiteral(".cbor");
+        break;
+    case DocumentFormat::MessagePack:
+        name += QStringLiteral(".msgpack");
+        break;
+    case DocumentFormat::Json:
+        name += QStringLiteral(".json");
+        break;
+    }
+    if (compression == DocumentFormat::Gzip) {
+        name += QStringLiteral(".gz");
+    } else if (compression == DocumentFormat::Zstd) {
+        name += QStringLiteral(".zst");
+    }
+
+    auto it = _documents.constFind(name);
+    if (it != _documents.constEnd()) {
+        return *it;
+    }
+
+    // the file name picks the format and compression the tree is saved in
+    const QString path = _dir.filePath(name);
+    TreeModel model(source);
+    model.saveToJsonFile(path);
+    if (!QFile::exists(path)) {
+        return QString();
+    }
+    _documents.insert(name, path);
+    return path;
+}
+
+void tst_TreeModel::setupJsonModelData_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::setupJsonModelData()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    const QString path = document(shape, nodes);
+    QVERIFY(!path.isEmpty());
+
+    // a synchronous TreeModel builds its tree through setupJsonModelData(), the arena frees it again
+    QBENCHMARK {
+        TreeModel model(path);
+        QVERIFY(model.rowCount() > 0);
+    }
+}
+
+void tst_TreeModel::walk_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::walk()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    TreeModel model(document(shape, nodes));
+
+    // what a view does: rowCount() per node, index() per row and parent() back up
+    QBENCHMARK {
+        qint64 visited = 0;
+        QVector<QModelIndex> stack{QModelIndex()};
+        while (!stack.isEmpty()) {
+            const QModelIndex parent = stack.takeLast();
+            const int rows = model.rowCount(parent);
+            for (int row = 0; row < rows; ++row) {
+                const QModelIndex index = model.index(row, 0, parent);
+                if (model.parent(index) != parent) {
+                    QFAIL("parent() does not match index()");
+                }
+                stack.append(index);
+                ++visited;
+            }
+        }
+        QVERIFY(visited > 0);
+    }
+}
+
+void tst_TreeModel::data_data()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<int>("role");
+
+    const qint64 nodes = qMin<qint64>(maxNodes(), 100000);
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::ArrayOfObjects};
+    for (JsonGenerator::Shape shape : shapes) {
+        const QByteArray name = JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes);
+        QTest::newRow((name + "-name").constData()) << shape << nodes << int(TreeModel::NameRole);
+        QTest::newRow((name + "-value").constData()) << shape << nodes << int(TreeModel::ValueRole);
+    }
+}
+
+void tst_TreeModel::data()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    QFETCH(int, role);
+    TreeModel model(document(shape, nodes));
+    const QVector<QModelIndex> indexes = allIndexes(model);
+
+    QBENCHMARK {
+        int valid = 0;
+        for (const QModelIndex &index : indexes) {
+            valid += model.data(index, role).isValid() ? 1 : 0;
+        }
+        QVERIFY(valid > 0);
+    }
+}
+
+void tst_TreeModel::serializeTreeToJson_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::serializeTreeToJson()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    TreeModel model(document(shape, nodes));
+
+    QBENCHMARK {
+        const QJsonDocument doc = model.serializeTreeToJson();
+        QVERIFY(!doc.isEmpty());
+    }
+}
+
+void tst_TreeModel::save_data()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<bool>("streaming");
+
+    // the DOM rows are the old save path: serializeTreeToJson() and toJson()
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::Deep, JsonGenerator::ArrayOfObjects};
+    for (JsonGenerator::Shape shape : shapes) {
+        for (qint64 nodes = 1000; nodes <= maxNodes(); nodes *= 10) {
+            const QByteArray name = JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes);
+            QTest::newRow((name + "-dom").constData()) << shape << nodes << false;
+            QTest::newRow((name + "-stream").constData()) << shape << nodes << true;
+        }
+    }
+}
+
+void tst_TreeModel::save()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    QFETCH(bool, streaming);
+    TreeModel model(document(shape, nodes));
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+
+    // both paths must produce the same document
+    QVERIFY(model.writeTree(&buffer));
+    QCOMPARE(QJsonDocument::fromJson(data), model.serializeTreeToJson());
+
+    QBENCHMARK {
+        data.resize(0);
+        buffer.seek(0);
+        if (streaming) {
+            QVERIFY(model.writeTree(&buffer));
+        } else {
+            QVERIFY(buffer.write(model.serializeTreeToJson().toJson()) > 0);
+        }
+    }
+}
+
+void tst_TreeModel::setData_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::setData()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+
+    // the model writes its edits back, so it works on a copy of the shared document
+    const QString path = _dir.filePath(QStringLiteral("edited-%1").arg(QTest::currentDataTag()));
+    QFile::remove(path);
+    QVERIFY(QFile::copy(document(shape, nodes), path));
+
+    TreeModel model(path);
+    QVector<QModelIndex> leaves;
+    for (const QModelIndex &index : allIndexes(model)) {
+        if (!model.hasChildren(index)) {
+            leaves.append(index);
+            if (leaves.count() == EDITS_PER_ITERATION) {
+                break;
+            }
+        }
+    }
+
+    // the save is written behind by a timer, which does not fire without an event loop
+    int value = 0;
+    QBENCHMARK {
+        for (const QModelIndex &index : leaves) {
+            model.setData(index, ++value, Qt::EditRole);
+        }
+    }
+}
+
+void tst_TreeModel::aggregates_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::aggregates()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+
+    const QString path = _dir.filePath(QStringLiteral("aggregated-%1").arg(QTest::currentDataTag()));
+    QFile::remove(path);
+    QVERIFY(QFile::copy(document(shape, nodes), path));
+
+    TreeModel model(path, TreeModel::Aggregates);
+    const TreeNode *root = model.nodeAt(QModelIndex());
+    const QVector<QModelIndex> indexes = allIndexes(model);
+    QCOMPARE(root->descendantCount(), indexes.count());
+
+    QVector<QModelIndex> leaves;
+    for (const QModelIndex &index : indexes) {
+        if (!model.hasChildren(index)) {
+            leaves.append(index);
+            if (leaves.count() == EDITS_PER_ITERATION) {
+                break;
+            }
+        }
+    }
+
+    // the same edits as setData(), plus the size updates along the ancestors
+    int value = 0;
+    QBENCHMARK {
+        for (const QModelIndex &index : leaves) {
+            model.setData(index, ++value, Qt::EditRole);
+        }
+    }
+
+    // the root's size is that of the whole document written compactly
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(model.writeTree(&buffer, QJsonDocument::Compact));
+    QCOMPARE(root->jsonSize(), qint64(data.size()));
+}
+
+void tst_TreeModel::parentByWidth_data()
+{
+    QTest::addColumn<qint64>("nodes");
+
+    // wide documents have about sqrt(nodes) children per object
+    for (qint64 nodes = 1000; nodes <= maxNodes(); nodes *= 10) {
+        QTest::newRow(QByteArray("width-" + QByteArray::number(qint64(std::sqrt(double(nodes))))).constData()) << nodes;
+    }
+}
+
+void tst_TreeModel::parentByWidth()
+{
+    QFETCH(qint64, nodes);
+    TreeModel model(document(JsonGenerator::Wide, nodes));
+
+    const QModelIndex group = model.index(0, 0);
+    QVector<QModelIndex> children;
+    for (int row = 0; row < model.rowCount(group); ++row) {
+        children.append(model.index(row, 0, group));
+    }
+
+    // constant per call, however wide the parent's parent is
+    QBENCHMARK {
+        for (const QModelIndex &child : children) {
+            if (model.parent(child) != group) {
+                QFAIL("parent() does not match index()");
+            }
+        }
+    }
+}
+
+void tst_TreeModel::parser_data()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<int>("parser");
+    QTest::addColumn<bool>("parallel");
+
+    const qint64 nodes = maxNodes();
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::Deep, JsonGenerator::ArrayOfObjects};
+    for (JsonGenerator::Shape shape : shapes) {
+        const QByteArray name = JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes);
+        QTest::newRow((name + "-stream").constData()) << shape << nodes << int(TreeLoader::StreamParser) << false;
+        QTest::newRow((name + "-dom").constData()) << shape << nodes << int(TreeLoader::DomParser) << false;
+        QTest::newRow((name + "-parallel").constData()) << shape << nodes << int(TreeLoader::DomParser) << true;
+    }
+}
+
+void tst_TreeModel::parser()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    QFETCH(int, parser);
+    QFETCH(bool, parallel);
+    const QString path = document(shape, nodes);
+
+    TreeLoader loader(path);
+    loader.setParser(TreeLoader::Parser(parser));
+    loader.setParallel(parallel);
+
+    // one load outside the benchmark for the peak memory, which is reported per row
+    const bool peakReset = resetPeakMemory();
+    const qint64 before = peakMemory();
+    QVERIFY(loader.load());
+    if (peakReset && before >= 0) {
+        qInfo("peak memory: %lld KiB above the baseline, file size %lld KiB",
+              (peakMemory() - before) / 1024, QFileInfo(path).size() / 1024);
+    }
+
+    QBENCHMARK {
+        QVERIFY(loader.load());
+    }
+}
+
+void tst_TreeModel::formats_data()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<int>("format");
+    QTest::addColumn<bool>("saving");
+
+    const qint64 nodes = maxNodes();
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::Deep, JsonGenerator::ArrayOfObjects};
+    const DocumentFormat::Format formats[] = {DocumentFormat::Json, DocumentFormat::Cbor, DocumentFormat::MessagePack};
+    for (JsonGenerator::Shape shape : shapes) {
+        const QByteArray name = JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes);
+        for (DocumentFormat::Format format : formats) {
+            const QByteArray row = name + "-" + DocumentFormat::name(format).toLower().toLatin1();
+            QTest::newRow((row + "-load").constData()) << shape << nodes << int(format) << false;
+            QTest::newRow((row + "-save").constData()) << shape << nodes << int(format) << true;
+        }
+    }
+}
+
+void tst_TreeModel::formats()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    QFETCH(int, format);
+    QFETCH(bool, saving);
+    const DocumentFormat::Format documentFormat = DocumentFormat::Format(format);
+    const QString path = encodedDocument(shape, nodes, documentFormat);
+    QVERIFY(!path.isEmpty());
+
+    // every format must load back into the same tree as the JSON it was made from
+    TreeModel model(path);
+    QCOMPARE(model.documentFormat(), documentFormat);
+    QByteArray data;
+    QBuffer buffer(&data);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(model.writeTree(&buffer, QJsonDocument::Compact));
+    const qint64 compactSize = data.size();
+    QCOMPARE(QJsonDocument::fromJson(data), TreeModel(document(shape, nodes)).serializeTreeToJson());
+    qInfo("file size %lld KiB, %lld%% of compact JSON",
+          QFileInfo(path).size() / 1024, QFileInfo(path).size() * 100 / qMax<qint64>(1, compactSize));
+
+    if (saving) {
+        QBENCHMARK {
+            data.resize(0);
+            buffer.seek(0);
+            QVERIFY(model.writeTree(&buffer, documentFormat));
+        }
+        return;
+    }
+
+    QBENCHMARK {
+        TreeModel loaded(path);
+        QVERIFY(loaded.rowCount() > 0);
+    }
+}
+
+void tst_TreeModel::compression_data()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+    QTest::addColumn<int>("compression");
+    QTest::addColumn<bool>("saving");
+
+    const qint64 nodes = maxNodes();
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::ArrayOfObjects};
+    const QPair<DocumentFormat::Compression, QByteArray> compressions[] = {
+        {DocumentFormat::Uncompressed, "plain"}, {DocumentFormat::Gzip, "gzip"}, {DocumentFormat::Zstd, "zstd"}};
+    for (JsonGenerator::Shape shape : shapes) {
+        const QByteArray name = JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes);
+        for (const auto &compression : compressions) {
+            if (compression.first != DocumentFormat::Uncompressed && !CompressedDevice::isSupported(compression.first)) {
+                continue;
+            }
+            const QByteArray row = name + "-" + compression.second;
+            QTest::newRow((row + "-load").constData()) << shape << nodes << int(compression.first) << false;
+            QTest::newRow((row + "-save").constData()) << shape << nodes << int(compression.first) << true;
+        }
+    }
+}
+
+void tst_TreeModel::compression()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    QFETCH(int, compression);
+    QFETCH(bool, saving);
+    const DocumentFormat::Compression documentCompression = DocumentFormat::Compression(compression);
+    const QString path = encodedDocument(shape, nodes, DocumentFormat::Json, documentCompression);
+    QVERIFY(!path.isEmpty());
+
+    // saving overwrites the model's own file, the generated documents are shared with other benchmarks
+    QString modelPath = path;
+    if (saving) {
+        modelPath = _dir.filePath(QStringLiteral("saved-") + QFileInfo(path).fileName());
+        QFile::remove(modelPath);
+        QVERIFY(QFile::copy(path, modelPath));
+    }
+
+    // decompressing while parsing must give the same tree as the plain file
+    TreeModel model(modelPath);
+    QCOMPARE(model.compression(), documentCompression);
+    QCOMPARE(model.serializeTreeToJson(), TreeModel(document(shape, nodes)).serializeTreeToJson());
+    qInfo("file size %lld KiB, %lld%% of the plain file", QFileInfo(path).size() / 1024,
+          QFileInfo(path).size() * 100 / qMax<qint64>(1, QFileInfo(document(shape, nodes)).size()));
+
+    if (saving) {
+        // saving to the model's own file keeps its compression
+        QBENCHMARK {
+            model.saveToJsonFile(modelPath);
+        }
+        QCOMPARE(DocumentFormat::detectCompression(modelPath), documentCompression);
+        return;
+    }
+
+    QBENCHMARK {
+        TreeModel loaded(path);
+        QVERIFY(loaded.rowCount() > 0);
+    }
+}
+
+void tst_TreeModel::snapshot_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::snapshot()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+
+    const QString path = _dir.filePath(QStringLiteral("versioned-%1").arg(QTest::currentDataTag()));
+    QFile::remove(path);
+    QVERIFY(QFile::copy(document(shape, nodes), path));
+
+    TreeModel model(path);
+    QVector<QModelIndex> leaves;
+    for (const QModelIndex &index : allIndexes(model)) {
+        if (!model.hasChildren(index)) {
+            leaves.append(index);
+            if (leaves.count() == EDITS_PER_ITERATION) {
+                break;
+            }
+        }
+    }
+
+    // the first call freezes the tree, a version without edits is the root's copy
+    QCOMPARE(model.memoryStats()["frozenNodes"].toInt(), 0);
+    const TreeVersion first = model.snapshot();
+    QVERIFY(!first.isNull());
+    QVERIFY(model.snapshot() == first);
+    qInfo("%lld nodes, %d bytes per frozen copy", model.memoryStats()["nodes"].toLongLong(),
+          model.memoryStats()["frozenNodeSize"].toInt());
+
+    QByteArray expected;
+    QBuffer tree(&expected);
+    QVERIFY(tree.open(QIODevice::WriteOnly));
+    QVERIFY(model.writeTree(&tree, QJsonDocument::Compact));
+
+    // a worker writes the first version while the tree is being edited
+    QFuture<QByteArray> written = QtConcurrent::run([first]() {
+        QByteArray data;
+        QBuffer buffer(&data);
+        buffer.open(QIODevice::WriteOnly);
+        first.write(&buffer, DocumentFormat::Json, QJsonDocument::Compact);
+        return data;
+    });
+
+    int value = 0;
+    QBENCHMARK {
+        for (const QModelIndex &index : leaves) {
+            model.setData(index, ++value, Qt::EditRole);
+        }
+        QVERIFY(model.snapshot() != first);
+    }
+    QCOMPARE(written.result(), expected);
+}
+
+void tst_TreeModel::namePoolMemory_data()
+{
+    QTest::addColumn<JsonGenerator::Shape>("shape");
+    QTest::addColumn<qint64>("nodes");
+
+    const qint64 nodes = maxNodes();
+    const JsonGenerator::Shape shapes[] = {JsonGenerator::Wide, JsonGenerator::Deep, JsonGenerator::ArrayOfObjects};
+    for (JsonGenerator::Shape shape : shapes) {
+        QTest::newRow(QByteArray(JsonGenerator::shapeName(shape).toLatin1() + "-" + QByteArray::number(nodes)).constData())
+            << shape << nodes;
+    }
+}
+
+void tst_TreeModel::namePoolMemory()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    TreeModel model(document(shape, nodes));
+
+    // a report rather than a timing, the numbers only change with the data
+    const QVariantMap stats = model.memoryStats();
+    qInfo("%lld nodes in %lld bytes, %d unique names of %lld lookups, %lld name bytes stored, %lld saved",
+          stats["nodes"].toLongLong(), stats["nodeBytes"].toLongLong(), stats["uniqueNames"].toInt(),
+          stats["nameLookups"].toLongLong(), stats["nameBytes"].toLongLong(), stats["nameBytesSaved"].toLongLong());
+    QVERIFY(stats["nameBytesSaved"].toLongLong() > 0);
+
+    // scalars are stored in the node, only strings take an extra slot
+    const qint64 nodeCount = stats["nodes"].toLongLong();
+    qInfo("%d bytes per node, %.1f bytes per node including string value slots",
+          stats["nodeSize"].toInt(),
+          double(stats["nodeBytes"].toLongLong() + stats["stringValueBytes"].toLongLong()) / qMax<qint64>(nodeCount, 1));
+}
+
+void tst_TreeModel::insertValues_data()
+{
+    QTest::addColumn<int>("count");
+
+    for (qint64 count = 1000; count <= maxNodes(); count *= 10) {
+        QTest::newRow(QByteArray("elements-" + QByteArray::number(count)).constData()) << int(count);
+    }
+}
+
+void tst_TreeModel::insertValues()
+{
+    QFETCH(int, count);
+
+    const QString path = _dir.filePath(QStringLiteral("inserted-%1.json").arg(count));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write("{\"items\": []}");
+    file.close();
+
+    TreeModel model(path);
+    const QModelIndex items = model.indexForPath(QStringLiteral("/items"));
+    QVERIFY(items.isValid());
+
+    QVariantList values;
+    values.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        values.append(QVariantMap{{QStringLiteral("id"), i}, {QStringLiteral("name"), QStringLiteral("item")}});
+    }
+
+    // one signal pair per batch, however many elements it holds
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QBENCHMARK {
+        QVERIFY(model.insertValues(QStringLiteral("/items"), -1, values));
+        QVERIFY(model.removeRows(0, count, items));
+    }
+    QCOMPARE(inserted.count(), removed.count());
+    QCOMPARE(model.rowCount(items), 0);
+}
+
+void tst_TreeModel::jsonLines_data()
+{
+    QTest::addColumn<int>("records");
+
+    for (qint64 records = 1000; records <= maxNodes(); records *= 10) {
+        QTest::newRow(QByteArray("records-" + QByteArray::number(records)).constData()) << int(records);
+    }
+}
+
+void tst_TreeModel::jsonLines()
+{
+    QFETCH(int, records);
+
+    const QString path = _dir.filePath(QStringLiteral("records-%1.jsonl").arg(records));
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    for (int i = 0; i < records; ++i) {
+        file.write("{\"id\": " + QByteArray::number(i) + ", \"name\": \"record-" + QByteArray::number(i)
+                   + "\", \"values\": [1, 2.5, true, null]}\n");
+    }
+    file.close();
+
+    // the scan and one node per record; expanding a record parses just that line
+    QBENCHMARK {
+        TreeModel model(path);
+        QCOMPARE(model.rowCount(), records);
+        const QModelIndex last = model.index(records - 1, 0);
+        QVERIFY(model.canFetchMore(last));
+        model.fetchMore(last);
+        QCOMPARE(model.rowCount(last), 3);
+    }
+}
+
+void tst_TreeModel::listExpand_data()
+{
+    addDocumentRows();
+}
+
+void tst_TreeModel::listExpand()
+{
+    QFETCH(JsonGenerator::Shape, shape);
+    QFETCH(qint64, nodes);
+    TreeModel model(document(shape, nodes));
+    TreeListModel list(&model);
+
+    list.expandRecursively();
+    const int rows = list.rowCount();
+    QCOMPARE(rows, allIndexes(model).count());
+
+    // collapsing and expanding the first node hides and shows most of the
+    // rows, then rows are mapped to nodes and back across the whole list
+    QBENCHMARK {
+        list.collapse(0);
+        QVERIFY(list.rowCount() < rows || model.rowCount(model.index(0, 0)) == 0);
+        list.expand(0);
+        QCOMPARE(list.rowCount(), rows);
+
+        for (int row = 0; row < rows; row += qMax(1, rows / 1000)) {
+            if (list.rowOf(list.nodeAt(row)) != row) {
+                QFAIL("rowOf() does not match nodeAt()");
+            }
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    // the model needs no display, so the benchmarks also run on machines without one
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    tst_TreeModel benchmark;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&benchmark, argc, argv);
+}
+
+#include "tst_bench_treemodel.moc"
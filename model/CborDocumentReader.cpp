@@ -0,0 +1,228 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: CborDocumentReader.cpp                                            *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the CborDocumentReader class, which reads a CBOR          *
+ * document with QCborStreamReader and reports it as the events of a           *
+ * JsonStreamHandler.                                                          *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <limits>
+#include <QVector>
+#include <QByteArray>
+#include "CborDocumentReader.h"
+
+// default number of bytes read between two calls of the chunk callback
+static const qint64 DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+CborDocumentReader::CborDocumentReader(JsonStreamHandler *handler)
+    : _handler{handler},
+      _chunkSize{DEFAULT_CHUNK_SIZE},
+      _aborted{false},
+      _errorOffset{-1} {}
+
+void CborDocumentReader::setChunkCallback(const JsonStreamReader::ChunkCallback &callback)
+{
+    _chunkCallback = callback;
+}
+
+bool CborDocumentReader::parse(QIODevice *device)
+{
+    struct Frame {
+        bool isMap;
+        bool expectKey;
+    };
+
+    _aborted = false;
+    _errorString.clear();
+    _errorOffset = -1;
+
+    QCborStreamReader reader(device);
+    QVector<Frame> frames;
+    qint64 nextCallback = _chunkSize;
+    QString text;
+    QVariant scalar;
+
+    // containers are entered and left in place, the frames only track what
+    // the handler has been told
+    do {
+        if (reader.lastError() != QCborError::NoError) {
+            return setError(reader, reader.lastError().toString());
+        }
+
+        if (_chunkCallback && reader.currentOffset() >= nextCallback) {
+            if (!_chunkCallback(reader.currentOffset())) {
+                _aborted = true;
+                return false;
+            }
+            nextCallback = reader.currentOffset() + _chunkSize;
+        }
+
+        if (!frames.isEmpty() && !reader.hasNext()) {
+            if (!reader.leaveContainer()) {
+                return setError(reader, QStringLiteral("unterminated container"));
+            }
+            if (frames.takeLast().isMap) {
+                _handler->endObject();
+            } else {
+                _handler->endArray();
+            }
+            continue;
+        }
+
+        // a tag only qualifies the item that follows it
+        if (reader.isTag()) {
+            reader.next();
+            continue;
+        }
+
+        Frame *parent = frames.isEmpty() ? nullptr : &frames.last();
+        if (parent && parent->isMap && parent->expectKey) {
+            if (reader.isString()) {
+                if (!readString(reader, text)) {
+                    return false;
+                }
+            } else if (reader.isMap() || reader.isArray()) {
+                return setError(reader, QStringLiteral("unsupported map key"));
+            } else {
+                if (!readScalar(reader, scalar)) {
+                    return false;
+                }
+                text = scalar.isNull() ? QStringLiteral("null") : scalar.toString();
+            }
+            _handler->key(text);
+            parent->expectKey = false;
+            continue;
+        }
+        if (parent && parent->isMap) {
+            parent->expectKey = true;
+        }
+
+        if (reader.isMap()) {
+            _handler->startObject();
+            reader.enterContainer();
+            frames.append({true, true});
+            continue;
+        }
+        if (reader.isArray()) {
+            _handler->startArray();
+            reader.enterContainer();
+            frames.append({false, false});
+            continue;
+        }
+
+        if (!readScalar(reader, scalar)) {
+            return false;
+        }
+        _handler->value(scalar);
+    } while (!frames.isEmpty());
+
+    return true;
+}
+
+bool CborDocumentReader::readScalar(QCborStreamReader &reader, QVariant &result)
+{
+    switch (reader.type()) {
+    case QCborStreamReader::UnsignedInteger: {
+        const quint64 value = reader.toUnsignedInteger();
+        result = value <= quint64(std::numeric_limits<qint64>::max()) ? QVariant(qlonglong(value))
+                                                                       : QVariant(double(value));
+        break;
+    }
+    case QCborStreamReader::NegativeInteger: {
+        // holds the absolute value, 0 stands for -2^64
+        const quint64 value = quint64(reader.toNegativeInteger());
+        if (value != 0 && value - 1 <= quint64(std::numeric_limits<qint64>::max())) {
+            result = qlonglong(-qint64(value - 1) - 1);
+        } else {
+            result = value == 0 ? -18446744073709551616.0 : -double(value);
+        }
+        break;
+    }
+    case QCborStreamReader::ByteArray: {
+        QByteArray bytes;
+        auto chunk = reader.readByteArray();
+        while (chunk.status == QCborStreamReader::Ok) {
+            bytes += chunk.data;
+            chunk = reader.readByteArray();
+        }
+        if (chunk.status == QCborStreamReader::Error) {
+            return setError(reader, QStringLiteral("malformed byte string"));
+        }
+        result = QString::fromLatin1(bytes.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+        return true;
+    }
+    case QCborStreamReader::String: {
+        QString text;
+        if (!readString(reader, text)) {
+            return false;
+        }
+        result = text;
+        return true;
+    }
+    case QCborStreamReader::SimpleType:
+        result = reader.isBool() ? QVariant(reader.toBool()) : QVariant();
+        break;
+    case QCborStreamReader::Float16:
+        result = double(reader.toFloat16());
+        break;
+    case QCborStreamReader::Float:
+        result = double(reader.toFloat());
+        break;
+    case QCborStreamReader::Double:
+        result = reader.toDouble();
+        break;
+    default:
+        return setError(reader, QStringLiteral("unexpected item"));
+    }
+
+    if (!reader.next()) {
+        return setError(reader, reader.lastError().toString());
+    }
+    return true;
+}
+
+bool CborDocumentReader::readString(QCborStreamReader &reader, QString &result)
+{
+    result.clear();
+    auto chunk = reader.readString();
+    while (chunk.status == QCborStreamReader::Ok) {
+        result += chunk.data;
+        chunk = reader.readString();
+    }
+    if (chunk.status == QCborStreamReader::Error) {
+        return setError(reader, QStringLiteral("malformed text string"));
+    }
+    return true;
+}
+
+bool CborDocumentReader::setError(QCborStreamReader &reader, const QString &message)
+{
+    if (_errorString.isEmpty()) {
+        _errorString = message;
+        _errorOffset = reader.currentOffset();
+    }
+    return false;
+}
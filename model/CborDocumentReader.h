@@ -0,0 +1,131 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: CborDocumentReader.h                                              *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the CborDocumentReader class, which reads a CBOR document   *
+ * with QCborStreamReader and reports it as the events of a                    *
+ * JsonStreamHandler.                                                          *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __CBOR_DOCUMENT_READER_H__
+#define __CBOR_DOCUMENT_READER_H__
+
+#include <QString>
+#include <QVariant>
+#include <QIODevice>
+#include <QCborStreamReader>
+
+#include "JsonStreamReader.h"
+
+
+class CborDocumentReader
+{
+public:
+    /**
+     * @brief Constructs a CborDocumentReader reporting to the given handler.
+     *
+     * @param handler The handler receiving the parse events, not owned.
+     */
+    explicit CborDocumentReader(JsonStreamHandler *handler);
+
+    /**
+     * @brief Parses one CBOR document from the device.
+     *
+     * The device is read incrementally by `QCborStreamReader` and nothing but
+     * the current item is held in memory. Items are mapped the way
+     * `QCborValue::toJsonValue()` maps them: integers that do not fit in 64
+     * bits become doubles, byte strings become base64url strings, undefined
+     * and other simple types become null, non-string keys are converted to
+     * strings and tags are skipped in favor of the item they tag.
+     *
+     * @param device The device to read from, must be open for reading.
+     * @return True if a complete, well-formed document was read.
+     */
+    bool parse(QIODevice *device);
+
+    /**
+     * @brief Sets the callback invoked every `chunkSize()` bytes.
+     *
+     * @param callback The callback, see `JsonStreamReader::ChunkCallback`.
+     */
+    void setChunkCallback(const JsonStreamReader::ChunkCallback &callback);
+
+    /**
+     * @brief Sets the number of bytes read between two calls of the chunk callback.
+     *
+     * @param chunkSize The chunk size in bytes (default 1 MiB).
+     */
+    inline void setChunkSize(qint64 chunkSize) { _chunkSize = chunkSize; }
+
+    /**
+     * @brief Returns true if parsing was aborted by the chunk callback.
+     */
+    inline bool isAborted() const { return _aborted; }
+
+    /**
+     * @brief Returns a description of the last parse error.
+     */
+    inline QString errorString() const { return _errorString; }
+
+    /**
+     * @brief Returns the byte offset at which the last parse error occurred.
+     */
+    inline qint64 errorOffset() const { return _errorOffset; }
+
+private:
+    /**
+     * @brief Reads a scalar item and advances past it.
+     *
+     * @param reader The reader, positioned on a scalar.
+     * @param result Receives the value, a QString, qlonglong, double or bool, or a null QVariant.
+     * @return False on malformed input.
+     */
+    bool readScalar(QCborStreamReader &reader, QVariant &result);
+
+    /**
+     * @brief Reads a text string in as many pieces as the reader hands out.
+     *
+     * @return False on malformed input.
+     */
+    bool readString(QCborStreamReader &reader, QString &result);
+
+    /**
+     * @brief Records a parse error at the reader's current offset.
+     *
+     * @param message The error description.
+     * @return Always false, for use in return statements.
+     */
+    bool setError(QCborStreamReader &reader, const QString &message);
+
+    JsonStreamHandler *_handler;
+    JsonStreamReader::ChunkCallback _chunkCallback;
+    qint64 _chunkSize;
+
+    bool _aborted;
+    QString _errorString;
+    qint64 _errorOffset;
+};
+
+#endif // __CBOR_DOCUMENT_READER_H__
@@ -0,0 +1,133 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: CborDocumentWriter.cpp                                            *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the CborDocumentWriter class, which writes CBOR with      *
+ * QCborStreamWriter and hands it to a QIODevice in buffered chunks.           *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QCborValue>
+#include "CborDocumentWriter.h"
+
+// bytes collected before a write to the device
+static const int DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+CborDocumentWriter::CborDocumentWriter(QIODevice *device)
+    : _device{device},
+      _bufferDevice{&_buffer},
+      _writer{&_bufferDevice},
+      _bufferSize{DEFAULT_BUFFER_SIZE},
+      _error{false}
+{
+    // unbuffered, so that every item lands in _buffer right away
+    _bufferDevice.open(QIODevice::WriteOnly | QIODevice::Unbuffered);
+}
+
+CborDocumentWriter::~CborDocumentWriter()
+{
+    flushBuffer();
+}
+
+void CborDocumentWriter::startObject(qsizetype size)
+{
+    _writer.startMap(quint64(size));
+}
+
+void CborDocumentWriter::endObject()
+{
+    _writer.endMap();
+    flushIfFull();
+}
+
+void CborDocumentWriter::startArray(qsizetype size)
+{
+    _writer.startArray(quint64(size));
+}
+
+void CborDocumentWriter::endArray()
+{
+    _writer.endArray();
+    flushIfFull();
+}
+
+void CborDocumentWriter::key(const QString &name)
+{
+    _writer.append(QStringView(name));
+}
+
+void CborDocumentWriter::nullValue()
+{
+    _writer.append(nullptr);
+    flushIfFull();
+}
+
+void CborDocumentWriter::boolValue(bool value)
+{
+    _writer.append(value);
+    flushIfFull();
+}
+
+void CborDocumentWriter::integerValue(qint64 value)
+{
+    _writer.append(value);
+    flushIfFull();
+}
+
+void CborDocumentWriter::doubleValue(double value)
+{
+    _writer.append(value);
+    flushIfFull();
+}
+
+void CborDocumentWriter::stringValue(const QString &value)
+{
+    _writer.append(QStringView(value));
+    flushIfFull();
+}
+
+void CborDocumentWriter::jsonValue(const QJsonValue &value)
+{
+    QCborValue::fromJsonValue(value).toCbor(_writer);
+    flushIfFull();
+}
+
+bool CborDocumentWriter::finish()
+{
+    flushBuffer();
+    return !_error;
+}
+
+void CborDocumentWriter::flushBuffer()
+{
+    if (_buffer.isEmpty()) {
+        return;
+    }
+    if (!_error && _device->write(_buffer) != _buffer.size()) {
+        _error = true;
+    }
+    // clear() would drop the reserved capacity, the QBuffer starts over at the front
+    _buffer.resize(0);
+    _bufferDevice.seek(0);
+}
@@ -0,0 +1,158 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: CborDocumentWriter.h                                              *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the CborDocumentWriter class, which writes CBOR with        *
+ * QCborStreamWriter and hands it to a QIODevice in buffered chunks.           *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __CBOR_DOCUMENT_WRITER_H__
+#define __CBOR_DOCUMENT_WRITER_H__
+
+#include <QBuffer>
+#include <QString>
+#include <QIODevice>
+#include <QByteArray>
+#include <QJsonValue>
+#include <QCborStreamWriter>
+
+
+class CborDocumentWriter
+{
+public:
+    /**
+     * @brief Constructs a CborDocumentWriter writing to the given device.
+     *
+     * @param device The device to write to, must be open for writing; not owned.
+     */
+    explicit CborDocumentWriter(QIODevice *device);
+
+    /**
+     * @brief Destructor for the CborDocumentWriter class, writes out what is still buffered.
+     */
+    ~CborDocumentWriter();
+
+    /**
+     * @brief Sets the number of bytes collected before they are written to the device.
+     *
+     * @param bufferSize The buffer size in bytes (default 64 KiB).
+     */
+    inline void setBufferSize(int bufferSize) { _bufferSize = qMax(1, bufferSize); }
+
+    /**
+     * @brief Starts a map of `size` entries, as a value or as the document.
+     */
+    void startObject(qsizetype size);
+
+    /**
+     * @brief Ends the innermost map.
+     */
+    void endObject();
+
+    /**
+     * @brief Starts an array of `size` elements, as a value or as the document.
+     */
+    void startArray(qsizetype size);
+
+    /**
+     * @brief Ends the innermost array.
+     */
+    void endArray();
+
+    /**
+     * @brief Writes the key of the next map entry as a text string.
+     */
+    void key(const QString &name);
+
+    /**
+     * @brief Writes null.
+     */
+    void nullValue();
+
+    /**
+     * @brief Writes true or false.
+     */
+    void boolValue(bool value);
+
+    /**
+     * @brief Writes an integer in the smallest encoding that holds it.
+     */
+    void integerValue(qint64 value);
+
+    /**
+     * @brief Writes a double as a 64-bit float, so that it reads back as a double.
+     */
+    void doubleValue(double value);
+
+    /**
+     * @brief Writes a text string.
+     */
+    void stringValue(const QString &value);
+
+    /**
+     * @brief Writes a JSON value through `QCborValue::fromJsonValue()`.
+     *
+     * Used for subtrees that only exist as JSON, e.g. children that were never built.
+     *
+     * @param value The value to write.
+     */
+    void jsonValue(const QJsonValue &value);
+
+    /**
+     * @brief Writes out the buffer.
+     *
+     * @return False if the device refused any of the data.
+     */
+    bool finish();
+
+    /**
+     * @brief Returns true if the device refused any of the data.
+     */
+    inline bool hasError() const { return _error; }
+
+private:
+    /**
+     * @brief Writes the buffer out once it is full.
+     */
+    inline void flushIfFull() {
+        if (_buffer.size() >= _bufferSize) {
+            flushBuffer();
+        }
+    }
+
+    /**
+     * @brief Writes the buffer to the device and empties it.
+     */
+    void flushBuffer();
+
+    QIODevice *_device;
+    QByteArray _buffer;
+    QBuffer _bufferDevice;      // what the QCborStreamWriter writes to, backed by _buffer
+    QCborStreamWriter _writer;
+    int _bufferSize;
+    bool _error;
+};
+
+#endif // __CBOR_DOCUMENT_WRITER_H__
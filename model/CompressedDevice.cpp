@@ -0,0 +1,362 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: CompressedDevice.cpp                                              *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the CompressedDevice class, a sequential QIODevice that   *
+ * decompresses or compresses gzip and Zstandard streams in chunks on top of   *
+ * another device.                                                             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <climits>
+#include <zlib.h>
+#ifdef TREEVIEW_ZSTD
+#include <zstd.h>
+#endif
+#include "CompressedDevice.h"
+
+// compressed bytes read from or written to the underlying device at a time
+static const int CHUNK_SIZE = 256 * 1024;
+
+// zlib counts in unsigned ints, larger requests are split
+static const qint64 MAX_ZLIB_CHUNK = INT_MAX;
+
+struct CompressedDevice::Stream
+{
+    z_stream zlib;
+    bool zlibInitialized = false;
+    bool deflating = false;
+#ifdef TREEVIEW_ZSTD
+    ZSTD_DCtx *zstdReader = nullptr;
+    ZSTD_CCtx *zstdWriter = nullptr;
+    ZSTD_inBuffer zstdInput{nullptr, 0, 0};
+#endif
+};
+
+CompressedDevice::CompressedDevice(QIODevice *device, DocumentFormat::Compression compression, QObject *parent)
+    : QIODevice(parent),
+      _device{device},
+      _compression{compression},
+      _level{-1},
+      _stream{new Stream},
+      _memberEnded{false},
+      _finished{false},
+      _failed{false} {}
+
+CompressedDevice::~CompressedDevice()
+{
+    if (isOpen()) {
+        close();
+    }
+}
+
+bool CompressedDevice::isSupported(DocumentFormat::Compression compression)
+{
+    switch (compression) {
+    case DocumentFormat::Gzip:
+        return true;
+    case DocumentFormat::Zstd:
+#ifdef TREEVIEW_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    case DocumentFormat::Uncompressed:
+        break;
+    }
+    return false;
+}
+
+bool CompressedDevice::open(OpenMode mode)
+{
+    const OpenMode access = mode & ReadWrite;
+    if (access != ReadOnly && access != WriteOnly) {
+        setErrorString(QStringLiteral("a compressed stream is either read or written"));
+        return false;
+    }
+    if (!isSupported(_compression)) {
+        setErrorString(_compression == DocumentFormat::Zstd ? QStringLiteral("built without Zstandard support")
+                                                            : QStringLiteral("no compression"));
+        return false;
+    }
+
+    _input.resize(0);
+    _output.resize(access == WriteOnly ? CHUNK_SIZE : 0);
+    _memberEnded = false;
+    _finished = false;
+    _failed = false;
+
+    if (_compression == DocumentFormat::Gzip) {
+        z_stream &zlib = _stream->zlib;
+        zlib = z_stream();
+        int result;
+        if (access == ReadOnly) {
+            // 32 added to the window bits detects gzip and zlib headers
+            result = inflateInit2(&zlib, 15 + 32);
+        } else {
+            // 16 added to the window bits writes a gzip header and trailer
+            const int level = _level < 0 ? Z_DEFAULT_COMPRESSION : qBound(1, _level, 9);
+            result = deflateInit2(&zlib, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY);
+        }
+        if (result != Z_OK) {
+            setErrorString(QString::fromLatin1(zlib.msg ? zlib.msg : "zlib initialization failed"));
+            return false;
+        }
+        _stream->zlibInitialized = true;
+        _stream->deflating = access == WriteOnly;
+    }
+
+#ifdef TREEVIEW_ZSTD
+    if (_compression == DocumentFormat::Zstd) {
+        if (access == ReadOnly) {
+            _stream->zstdReader = ZSTD_createDCtx();
+            _stream->zstdInput = {nullptr, 0, 0};
+        } else {
+            _stream->zstdWriter = ZSTD_createCCtx();
+            const int level = _level < 0 ? ZSTD_CLEVEL_DEFAULT : qBound(1, _level, ZSTD_maxCLevel());
+            if (_stream->zstdWriter) {
+                ZSTD_CCtx_setParameter(_stream->zstdWriter, ZSTD_c_compressionLevel, level);
+            }
+        }
+        if (!_stream->zstdReader && !_stream->zstdWriter) {
+            setErrorString(QStringLiteral("Zstandard initialization failed"));
+            return false;
+        }
+    }
+#endif
+
+    return QIODevice::open(mode);
+}
+
+void CompressedDevice::close()
+{
+    if (!isOpen()) {
+        return;
+    }
+    if (openMode() & WriteOnly) {
+        finish();
+    }
+    endStream();
+    QIODevice::close();
+}
+
+bool CompressedDevice::finish()
+{
+    if (!(openMode() & WriteOnly)) {
+        return false;
+    }
+    if (!_finished) {
+        _finished = true;
+        compress(nullptr, 0, true);
+    }
+    return !_failed;
+}
+
+bool CompressedDevice::atEnd() const
+{
+    if (openMode() & WriteOnly) {
+        return true;
+    }
+    return (_finished || _failed) && QIODevice::atEnd();
+}
+
+qint64 CompressedDevice::readData(char *data, qint64 maxSize)
+{
+    if (_failed) {
+        return -1;
+    }
+
+    qint64 produced = 0;
+    while (produced < maxSize && !_finished) {
+        bool inputLeft;
+#ifdef TREEVIEW_ZSTD
+        if (_compression == DocumentFormat::Zstd) {
+            inputLeft = _stream->zstdInput.pos < _stream->zstdInput.size;
+        } else
+#endif
+        {
+            inputLeft = _stream->zlib.avail_in > 0;
+        }
+
+        if (!inputLeft && !fillInput()) {
+            // a stream cut off in the middle of a member is an error, not the end
+            _finished = true;
+            if (!_memberEnded) {
+                fail(QStringLiteral("unexpected end of compressed data"));
+                return produced > 0 ? produced : -1;
+            }
+            break;
+        }
+
+#ifdef TREEVIEW_ZSTD
+        if (_compression == DocumentFormat::Zstd) {
+            ZSTD_outBuffer output{data + produced, size_t(maxSize - produced), 0};
+            const size_t result = ZSTD_decompressStream(_stream->zstdReader, &output, &_stream->zstdInput);
+            if (ZSTD_isError(result)) {
+                fail(QString::fromLatin1(ZSTD_getErrorName(result)));
+                return produced > 0 ? produced : -1;
+            }
+            produced += qint64(output.pos);
+            // 0 means a frame was completed and flushed, another one may follow
+            _memberEnded = result == 0;
+        } else
+#endif
+        {
+            z_stream &zlib = _stream->zlib;
+            const uInt available = uInt(qMin(maxSize - produced, MAX_ZLIB_CHUNK));
+            zlib.next_out = reinterpret_cast<Bytef *>(data + produced);
+            zlib.avail_out = available;
+            const uInt inputBefore = zlib.avail_in;
+            const int result = inflate(&zlib, Z_NO_FLUSH);
+            produced += available - zlib.avail_out;
+
+            if (result == Z_STREAM_END) {
+                // concatenated gzip members are read as one stream, like gunzip does
+                _memberEnded = true;
+                inflateReset(&zlib);
+            } else if (result == Z_OK || result == Z_BUF_ERROR) {
+                if (zlib.avail_in != inputBefore) {
+                    _memberEnded = false;
+                }
+            } else {
+                fail(QString::fromLatin1(zlib.msg ? zlib.msg : "corrupt gzip data"));
+                return produced > 0 ? produced : -1;
+            }
+        }
+
+        // what is decompressed so far is handed out rather than waiting for a full request
+        if (produced > 0) {
+            break;
+        }
+    }
+    return produced;
+}
+
+qint64 CompressedDevice::writeData(const char *data, qint64 maxSize)
+{
+    if (_failed || _finished) {
+        return -1;
+    }
+    return compress(data, maxSize, false) ? maxSize : -1;
+}
+
+bool CompressedDevice::fillInput()
+{
+    _input.resize(CHUNK_SIZE);
+    const qint64 count = _device->read(_input.data(), CHUNK_SIZE);
+    _input.resize(count > 0 ? count : 0);
+    if (count <= 0) {
+        return false;
+    }
+
+#ifdef TREEVIEW_ZSTD
+    if (_compression == DocumentFormat::Zstd) {
+        _stream->zstdInput = {_input.constData(), size_t(count), 0};
+        return true;
+    }
+#endif
+    _stream->zlib.next_in = reinterpret_cast<Bytef *>(_input.data());
+    _stream->zlib.avail_in = uInt(count);
+    return true;
+}
+
+bool CompressedDevice::compress(const char *data, qint64 size, bool end)
+{
+    if (_failed) {
+        return false;
+    }
+
+#ifdef TREEVIEW_ZSTD
+    if (_compression == DocumentFormat::Zstd) {
+        ZSTD_inBuffer input{data, size_t(size), 0};
+        while (true) {
+            ZSTD_outBuffer output{_output.data(), size_t(_output.size()), 0};
+            const size_t remaining = ZSTD_compressStream2(_stream->zstdWriter, &output, &input,
+                                                          end ? ZSTD_e_end : ZSTD_e_continue);
+            if (ZSTD_isError(remaining)) {
+                return fail(QString::fromLatin1(ZSTD_getErrorName(remaining)));
+            }
+            if (output.pos > 0 && _device->write(_output.constData(), qint64(output.pos)) != qint64(output.pos)) {
+                return fail(_device->errorString());
+            }
+            if (end ? remaining == 0 : input.pos == input.size) {
+                return true;
+            }
+        }
+    }
+#endif
+
+    z_stream &zlib = _stream->zlib;
+    qint64 offset = 0;
+    do {
+        const qint64 piece = qMin(size - offset, MAX_ZLIB_CHUNK);
+        zlib.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data + offset));
+        zlib.avail_in = uInt(piece);
+        offset += piece;
+        const bool last = end && offset == size;
+
+        // the output buffer is drained until the compressor has taken all input
+        int result;
+        do {
+            zlib.next_out = reinterpret_cast<Bytef *>(_output.data());
+            zlib.avail_out = uInt(_output.size());
+            result = deflate(&zlib, last ? Z_FINISH : Z_NO_FLUSH);
+            if (result == Z_STREAM_ERROR) {
+                return fail(QStringLiteral("gzip compression failed"));
+            }
+            const qint64 have = _output.size() - qint64(zlib.avail_out);
+            if (have > 0 && _device->write(_output.constData(), have) != have) {
+                return fail(_device->errorString());
+            }
+        } while (last ? result != Z_STREAM_END : zlib.avail_out == 0);
+    } while (offset < size);
+    return true;
+}
+
+void CompressedDevice::endStream()
+{
+    if (_stream->zlibInitialized) {
+        if (_stream->deflating) {
+            deflateEnd(&_stream->zlib);
+        } else {
+            inflateEnd(&_stream->zlib);
+        }
+        _stream->zlibInitialized = false;
+    }
+#ifdef TREEVIEW_ZSTD
+    ZSTD_freeDCtx(_stream->zstdReader);
+    ZSTD_freeCCtx(_stream->zstdWriter);
+    _stream->zstdReader = nullptr;
+    _stream->zstdWriter = nullptr;
+#endif
+}
+
+bool CompressedDevice::fail(const QString &message)
+{
+    if (!_failed) {
+        _failed = true;
+        setErrorString(message);
+    }
+    return false;
+}
@@ -0,0 +1,172 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: CompressedDevice.h                                                *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the CompressedDevice class, a sequential QIODevice that     *
+ * decompresses or compresses gzip and Zstandard streams in chunks on top of   *
+ * another device.                                                             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __COMPRESSED_DEVICE_H__
+#define __COMPRESSED_DEVICE_H__
+
+#include <QIODevice>
+#include <QByteArray>
+#include <QScopedPointer>
+
+#include "DocumentFormat.h"
+
+
+class CompressedDevice : public QIODevice
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Constructs a CompressedDevice on top of the given device.
+     *
+     * @param device The device holding the compressed data, opened for
+     *               reading or writing like this device will be; not owned.
+     * @param compression Gzip or Zstd.
+     * @param parent The parent object.
+     */
+    CompressedDevice(QIODevice *device, DocumentFormat::Compression compression, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor for the CompressedDevice class, finishes the stream if it is open for writing.
+     */
+    ~CompressedDevice() override;
+
+    /**
+     * @brief Returns true if the build supports the compression.
+     *
+     * Gzip always is, Zstandard if libzstd was found when the project was
+     * configured (see `model.pri`).
+     */
+    static bool isSupported(DocumentFormat::Compression compression);
+
+    /**
+     * @brief Returns the compression of the stream.
+     */
+    inline DocumentFormat::Compression compression() const { return _compression; }
+
+    /**
+     * @brief Sets the compression level used when writing.
+     *
+     * Gzip takes 1 (fastest) to 9 (smallest), Zstandard 1 to 19; values out of
+     * range are clamped. Must be set before `open()`.
+     *
+     * @param level The level, or -1 for the library default (gzip 6, Zstandard 3).
+     */
+    inline void setLevel(int level) { _level = level; }
+
+    /**
+     * @brief Returns the compression level used when writing.
+     */
+    inline int level() const { return _level; }
+
+    /**
+     * @brief Opens the device for reading (decompressing) or writing (compressing).
+     *
+     * @param mode ReadOnly or WriteOnly.
+     * @return False if the mode or the compression is not supported.
+     */
+    bool open(OpenMode mode) override;
+
+    /**
+     * @brief Finishes the stream if it is open for writing and closes the device.
+     *
+     * The underlying device is left open.
+     */
+    void close() override;
+
+    /**
+     * @brief Writes what the compressor still holds and the end of the stream.
+     *
+     * Called by `close()`; call it explicitly to learn whether the underlying
+     * device accepted everything.
+     *
+     * @return False if compressing failed or the underlying device refused any of the data.
+     */
+    bool finish();
+
+    /**
+     * @brief Returns true, the stream can only be read or written front to back.
+     */
+    bool isSequential() const override { return true; }
+
+    /**
+     * @brief Returns true once the whole stream has been decompressed and read.
+     */
+    bool atEnd() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    /**
+     * @brief Reads the next chunk of compressed data from the underlying device.
+     *
+     * @return False at the end of the underlying device.
+     */
+    bool fillInput();
+
+    /**
+     * @brief Feeds data to the compressor and writes what it produces.
+     *
+     * @param data The uncompressed data.
+     * @param size The number of bytes.
+     * @param end True to end the stream after the data.
+     * @return False if compressing or writing failed.
+     */
+    bool compress(const char *data, qint64 size, bool end);
+
+    /**
+     * @brief Releases the codec state.
+     */
+    void endStream();
+
+    /**
+     * @brief Records an error, which makes reads and writes fail from then on.
+     *
+     * @return Always false, for use in return statements.
+     */
+    bool fail(const QString &message);
+
+    struct Stream;
+
+    QIODevice *_device;
+    DocumentFormat::Compression _compression;
+    int _level;
+    QScopedPointer<Stream> _stream;
+    QByteArray _input;      // compressed data read from the device
+    QByteArray _output;     // compressed data to be written to the device
+    bool _memberEnded;      // the last gzip member or Zstandard frame is complete
+    bool _finished;
+    bool _failed;
+};
+
+#endif // __COMPRESSED_DEVICE_H__
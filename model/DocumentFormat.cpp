@@ -0,0 +1,137 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: DocumentFormat.cpp                                                *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the DocumentFormat functions, which tell JSON, CBOR and   *
+ * MessagePack documents, plain or compressed, apart by file name and content. *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QFile>
+#include <QFileInfo>
+#include "DocumentFormat.h"
+#include "CompressedDevice.h"
+
+DocumentFormat::Format DocumentFormat::fromFileName(const QString &filePath)
+{
+    QString fileName = QFileInfo(filePath).fileName();
+    if (compressionFromFileName(fileName) != Uncompressed) {
+        fileName = QFileInfo(fileName).completeBaseName();
+    }
+
+    const QString suffix = QFileInfo(fileName).suffix().toLower();
+    if (suffix == QLatin1String("cbor")) {
+        return Cbor;
+    }
+    if (suffix == QLatin1String("msgpack") || suffix == QLatin1String("mpk")) {
+        return MessagePack;
+    }
+    return Json;
+}
+
+DocumentFormat::Format DocumentFormat::detect(const QString &filePath)
+{
+    const Format format = fromFileName(filePath);
+    if (format != Json) {
+        return format;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Json;
+    }
+
+    // the document starts after what the compression adds in front
+    CompressedDevice decompressed(&file, detectCompression(filePath));
+    QIODevice *device = &file;
+    if (decompressed.compression() != Uncompressed) {
+        if (!decompressed.open(QIODevice::ReadOnly)) {
+            return Json;
+        }
+        device = &decompressed;
+    }
+    const QByteArray head = device->read(3);
+    if (head.isEmpty()) {
+        return Json;
+    }
+
+    const uchar first = uchar(head.at(0));
+
+    // CBOR maps of any length (0xa0 - 0xbf) and the self-describe tag 55799 (0xd9d9f7)
+    if ((first >= 0xa0 && first <= 0xbf) || head == QByteArray("\xd9\xd9\xf7", 3)) {
+        return Cbor;
+    }
+
+    // MessagePack fixmap (0x80 - 0x8f), map 16 and map 32
+    if ((first >= 0x80 && first <= 0x8f) || first == 0xde || first == 0xdf) {
+        return MessagePack;
+    }
+    return Json;
+}
+
+DocumentFormat::Compression DocumentFormat::compressionFromFileName(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    if (suffix == QLatin1String("gz")) {
+        return Gzip;
+    }
+    if (suffix == QLatin1String("zst")) {
+        return Zstd;
+    }
+    return Uncompressed;
+}
+
+DocumentFormat::Compression DocumentFormat::detectCompression(const QString &filePath)
+{
+    const Compression compression = compressionFromFileName(filePath);
+    if (compression != Uncompressed) {
+        return compression;
+    }
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return Uncompressed;
+    }
+    const QByteArray head = file.read(4);
+    if (head.startsWith("\x1f\x8b")) {
+        return Gzip;
+    }
+    if (head == QByteArray("\x28\xb5\x2f\xfd", 4)) {
+        return Zstd;
+    }
+    return Uncompressed;
+}
+
+QString DocumentFormat::name(Format format)
+{
+    switch (format) {
+    case Cbor:
+        return QStringLiteral("CBOR");
+    case MessagePack:
+        return QStringLiteral("MessagePack");
+    case Json:
+        break;
+    }
+    return QStringLiteral("JSON");
+}
@@ -0,0 +1,110 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: DocumentFormat.h                                                  *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the DocumentFormat functions, which tell JSON, CBOR and     *
+ * MessagePack documents apart by file name and content.                       *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __DOCUMENT_FORMAT_H__
+#define __DOCUMENT_FORMAT_H__
+
+#include <QString>
+
+
+namespace DocumentFormat
+{
+    /**
+     * @brief The encodings a tree can be loaded from and saved to.
+     *
+     * - Json: JSON text.
+     * - Cbor: CBOR (RFC 8949), read with `CborDocumentReader` and written with `CborDocumentWriter`.
+     * - MessagePack: MessagePack, read with `MsgPackReader` and written with `MsgPackWriter`.
+     */
+    enum Format {
+        Json,
+        Cbor,
+        MessagePack
+    };
+
+    /**
+     * @brief The compressions a document can be stored with, see `CompressedDevice`.
+     */
+    enum Compression {
+        Uncompressed,
+        Gzip,
+        Zstd
+    };
+
+    /**
+     * @brief Returns the format the file name says the file holds.
+     *
+     * `.cbor` is CBOR, `.msgpack` and `.mpk` are MessagePack, everything else is
+     * JSON. A compression suffix is skipped, so `test.cbor.zst` is CBOR.
+     *
+     * @param filePath The path of the file.
+     */
+    Format fromFileName(const QString &filePath);
+
+    /**
+     * @brief Returns the format of an existing file.
+     *
+     * The file name decides if it names a binary format. Otherwise the first
+     * bytes are checked, after decompressing them if the file is compressed:
+     * the root of the tree is a map, so a CBOR map (or the CBOR self-describe
+     * tag) and a MessagePack map cannot be mistaken for each other or for JSON text.
+     *
+     * @param filePath The path of the file.
+     * @return The format, Json if the file cannot be read.
+     */
+    Format detect(const QString &filePath);
+
+    /**
+     * @brief Returns the compression the file name says the file is stored with.
+     *
+     * `.gz` is gzip and `.zst` is Zstandard.
+     *
+     * @param filePath The path of the file.
+     */
+    Compression compressionFromFileName(const QString &filePath);
+
+    /**
+     * @brief Returns the compression of an existing file.
+     *
+     * The file name decides if it names a compression, otherwise the gzip and
+     * Zstandard magic numbers are checked.
+     *
+     * @param filePath The path of the file.
+     * @return The compression, Uncompressed if the file cannot be read.
+     */
+    Compression detectCompression(const QString &filePath);
+
+    /**
+     * @brief Returns the name of a format, e.g. for log messages.
+     */
+    QString name(Format format);
+}
+
+#endif // __DOCUMENT_FORMAT_H__
@@ -0,0 +1,153 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonLinesFile.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the JsonLinesFile class, a byte-offset index over the     *
+ * records of a JSON Lines file.                                               *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cstring>
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include "JsonLinesFile.h"
+
+// bytes read from the file at a time while scanning
+static const qint64 SCAN_CHUNK_SIZE = 1024 * 1024;
+
+JsonLinesFile::JsonLinesFile(const QString &filePath)
+    : _file{filePath},
+      _cachedRecord{-1} {}
+
+bool JsonLinesFile::isJsonLinesFile(const QString &filePath)
+{
+    const QString suffix = QFileInfo(filePath).suffix().toLower();
+    return suffix == QLatin1String("jsonl") || suffix == QLatin1String("ndjson");
+}
+
+bool JsonLinesFile::scan(const ChunkCallback &callback)
+{
+    _offsets.clear();
+    _kinds.clear();
+    _cachedRecord = -1;
+    _cachedValue = QJsonValue();
+    _errorString.clear();
+
+    if (!_file.isOpen() && !_file.open(QIODevice::ReadOnly)) {
+        _errorString = _file.errorString();
+        return false;
+    }
+    _file.seek(0);
+
+    QByteArray buffer(SCAN_CHUNK_SIZE, Qt::Uninitialized);
+    qint64 offset = 0;
+    bool inRecord = false;
+
+    while (true) {
+        const qint64 count = _file.read(buffer.data(), buffer.size());
+        if (count < 0) {
+            _errorString = _file.errorString();
+            return false;
+        }
+        if (count == 0) {
+            break;
+        }
+
+        const char *data = buffer.constData();
+        const char *end = data + count;
+        const char *c = data;
+
+        // a UTF-8 byte order mark is not part of the first record
+        if (offset == 0 && count >= 3 && memcmp(data, "\xef\xbb\xbf", 3) == 0) {
+            c += 3;
+        }
+
+        while (c < end) {
+            if (inRecord) {
+                // the rest of a record is skipped without looking at it
+                const char *newline = static_cast<const char *>(memchr(c, '\n', size_t(end - c)));
+                if (!newline) {
+                    break;
+                }
+                inRecord = false;
+                c = newline + 1;
+                continue;
+            }
+
+            if (*c == ' ' || *c == '\t' || *c == '\r' || *c == '\n') {
+                ++c;
+                continue;
+            }
+
+            _offsets.append(offset + (c - data));
+            _kinds.append(char(*c == '{' ? ObjectRecord : (*c == '[' ? ArrayRecord : ScalarRecord)));
+            inRecord = true;
+        }
+
+        offset += count;
+        if (callback && !callback(offset)) {
+            return false;
+        }
+    }
+
+    // the end of the last record
+    _offsets.append(offset);
+    return true;
+}
+
+QJsonValue JsonLinesFile::record(int record)
+{
+    if (record == _cachedRecord) {
+        return _cachedValue;
+    }
+    if (record < 0 || record >= recordCount()) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    const qint64 begin = _offsets.at(record);
+    const qint64 size = _offsets.at(record + 1) - begin;
+
+    // wrapped in an array, so that scalar records parse as well
+    QByteArray text;
+    text.reserve(size + 2);
+    text.append('[');
+    if (_file.seek(begin)) {
+        text.append(_file.read(size));
+    }
+    text.append(']');
+
+    QJsonParseError error;
+    const QJsonDocument doc = QJsonDocument::fromJson(text, &error);
+    if (error.error != QJsonParseError::NoError) {
+        qWarning() << "[WARNING] :: failed to parse record" << record + 1 << "of" << _file.fileName()
+                   << ":" << error.errorString();
+        _cachedValue = QJsonValue(QJsonValue::Null);
+    } else {
+        _cachedValue = doc.array().first();
+    }
+    _cachedRecord = record;
+    return _cachedValue;
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonLinesFile.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the JsonLinesFile class, which indexes the records of a     *
+ * newline-delimited JSON (JSON Lines / NDJSON) file by byte offset in one     *
+ * pass and parses single records on demand.                                   *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __JSON_LINES_FILE_H__
+#define __JSON_LINES_FILE_H__
+
+#include <functional>
+
+#include <QFile>
+#include <QVector>
+#include <QString>
+#include <QByteArray>
+#include <QJsonValue>
+
+
+class JsonLinesFile
+{
+    Q_DISABLE_COPY(JsonLinesFile)
+
+public:
+    /**
+     * @brief Callback invoked after every chunk read while scanning.
+     *
+     * Receives the total number of bytes read so far. Returning false aborts
+     * the scan, which is how callers implement cancellation.
+     */
+    using ChunkCallback = std::function<bool(qint64)>;
+
+    /**
+     * @brief Enum for what a record holds, told from its first character.
+     */
+    enum RecordKind : quint8 {
+        ObjectRecord,
+        ArrayRecord,
+        ScalarRecord
+    };
+
+    /**
+     * @brief Constructs a JsonLinesFile for the given file, nothing is read yet.
+     *
+     * @param filePath The path of the newline-delimited JSON file.
+     */
+    explicit JsonLinesFile(const QString &filePath);
+
+    /**
+     * @brief Returns true if the file name says the file holds JSON Lines (`.jsonl`, `.ndjson`).
+     *
+     * @param filePath The path of the file.
+     */
+    static bool isJsonLinesFile(const QString &filePath);
+
+    /**
+     * @brief Reads the whole file once and records where every record starts.
+     *
+     * Every line that is not blank is a record. The file is read in chunks of
+     * 1 MiB and only the offsets (8 bytes per record) and kinds (1 byte per
+     * record) are kept, so the file itself can be far larger than memory.
+     *
+     * @param callback The callback invoked after every chunk, see `ChunkCallback`.
+     * @return False if the file could not be read or the scan was aborted.
+     */
+    bool scan(const ChunkCallback &callback = ChunkCallback());
+
+    /**
+     * @brief Returns the number of records found by `scan()`.
+     */
+    inline int recordCount() const { return qMax(0, int(_offsets.count()) - 1); }
+
+    /**
+     * @brief Returns what the given record holds.
+     *
+     * @param record The record number, starting at 0.
+     */
+    inline RecordKind kind(int record) const { return RecordKind(_kinds.at(record)); }
+
+    /**
+     * @brief Reads and parses a single record.
+     *
+     * Only the bytes of the record are read. The last parsed record is kept, so
+     * asking for its size and then for its contents parses it once.
+     *
+     * @param record The record number, starting at 0.
+     * @return The record, null if it is malformed (a warning is logged), or
+     *         undefined if there is no such record.
+     */
+    QJsonValue record(int record);
+
+    /**
+     * @brief Returns why the last `scan()` could not read the file.
+     */
+    inline QString errorString() const { return _errorString; }
+
+private:
+    QFile _file;
+    QVector<qint64> _offsets;   // start of every record, followed by the file size
+    QByteArray _kinds;          // RecordKind of every record
+    int _cachedRecord;
+    QJsonValue _cachedValue;
+    QString _errorString;
+};
+
+#endif // __JSON_LINES_FILE_H__
@@ -0,0 +1,140 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonPointer.cpp                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the JsonPointer helpers, which convert between TreeNodes  *
+ * and JSON Pointer (RFC 6901) paths.                                          *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include "JsonPointer.h"
+
+QString JsonPointer::escape(const QString &name)
+{
+    if (!name.contains(QLatin1Char('~')) && !name.contains(QLatin1Char('/'))) {
+        return name;
+    }
+
+    QString segment = name;
+    // the order matters, "~" has to be escaped before "~1" is introduced
+    segment.replace(QLatin1String("~"), QLatin1String("~0"));
+    segment.replace(QLatin1String("/"), QLatin1String("~1"));
+    return segment;
+}
+
+QString JsonPointer::unescape(const QString &segment)
+{
+    if (!segment.contains(QLatin1Char('~'))) {
+        return segment;
+    }
+
+    QString name = segment;
+    // the reverse order of escape(), so "~01" becomes "~1" and not "/"
+    name.replace(QLatin1String("~1"), QLatin1String("/"));
+    name.replace(QLatin1String("~0"), QLatin1String("~"));
+    return name;
+}
+
+QStringList JsonPointer::split(const QString &path, bool *ok)
+{
+    if (ok) {
+        *ok = true;
+    }
+
+    if (path.isEmpty()) {
+        return QStringList();
+    }
+
+    if (!path.startsWith(QLatin1Char('/'))) {
+        if (ok) {
+            *ok = false;
+        }
+        return QStringList();
+    }
+
+    QStringList segments = path.mid(1).split(QLatin1Char('/'));
+    for (QString &segment : segments) {
+        segment = unescape(segment);
+    }
+    return segments;
+}
+
+QString JsonPointer::segment(const TreeNode *node)
+{
+    if (node->parentNode() && node->parentNode()->type() == TreeNode::Array) {
+        return QString::number(node->row());
+    }
+    return escape(node->name());
+}
+
+QString JsonPointer::pathFor(const TreeNode *node)
+{
+    QStringList segments;
+    for (const TreeNode *current = node; current->parentNode(); current = current->parentNode()) {
+        segments.prepend(segment(current));
+    }
+
+    if (segments.isEmpty()) {
+        return QString();
+    }
+    return QStringLiteral("/") + segments.join(QLatin1Char('/'));
+}
+
+TreeNode *JsonPointer::child(TreeNode *parent, const QString &name)
+{
+    if (parent->type() == TreeNode::Array) {
+        bool ok = false;
+        const int row = name.toInt(&ok);
+        return ok ? parent->child(row) : nullptr;
+    }
+
+    for (TreeNode *node : parent->children()) {
+        if (node->name() == name) {
+            return node;
+        }
+    }
+    return nullptr;
+}
+
+TreeNode *JsonPointer::resolve(TreeNode *root, const QString &path, const FetchFunction &fetch)
+{
+    bool ok = false;
+    const QStringList segments = split(path, &ok);
+    if (!ok) {
+        return nullptr;
+    }
+
+    TreeNode *node = root;
+    for (const QString &name : segments) {
+        if (fetch) {
+            fetch(node);
+        }
+
+        node = child(node, name);
+        if (!node) {
+            return nullptr;
+        }
+    }
+    return node;
+}
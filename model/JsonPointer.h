@@ -0,0 +1,119 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonPointer.h                                                     *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the JsonPointer helpers, which convert between TreeNodes    *
+ * and JSON Pointer (RFC 6901) paths such as /config/options/option3/2. Object *
+ * members are addressed by name and array elements by index.                  *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __JSON_POINTER_H__
+#define __JSON_POINTER_H__
+
+#include <functional>
+
+#include <QString>
+#include <QStringList>
+
+#include "TreeNode.h"
+
+
+namespace JsonPointer
+{
+    /**
+     * @brief Function called on a node before its children are looked at.
+     *
+     * Used by callers with lazily built trees to materialize pending children.
+     */
+    using FetchFunction = std::function<void(TreeNode *)>;
+
+    /**
+     * @brief Escapes a name for use as a path segment ("~" -> "~0", "/" -> "~1").
+     *
+     * @param name The object member name.
+     * @return The escaped segment.
+     */
+    QString escape(const QString &name);
+
+    /**
+     * @brief Reverses `escape()`.
+     *
+     * @param segment The escaped segment.
+     * @return The object member name.
+     */
+    QString unescape(const QString &segment);
+
+    /**
+     * @brief Splits a path into its unescaped segments.
+     *
+     * @param path The path, either empty (the root) or starting with '/'.
+     * @param ok Set to false if the path is malformed, may be nullptr.
+     * @return The unescaped segments.
+     */
+    QStringList split(const QString &path, bool *ok = nullptr);
+
+    /**
+     * @brief Returns the path segment addressing the node within its parent.
+     *
+     * This is the node's row for elements of an array and its escaped name otherwise.
+     *
+     * @param node The node, must have a parent.
+     */
+    QString segment(const TreeNode *node);
+
+    /**
+     * @brief Returns the path of the node, relative to the root of its tree.
+     *
+     * Costs O(depth).
+     *
+     * @param node The node.
+     * @return The path, empty for the root node.
+     */
+    QString pathFor(const TreeNode *node);
+
+    /**
+     * @brief Returns the child of `parent` addressed by the unescaped segment.
+     *
+     * Array elements are looked up by index, object members by name (the first
+     * match wins). Costs O(siblings) for objects.
+     *
+     * @param parent The parent node.
+     * @param name The unescaped segment.
+     * @return The child, or nullptr if there is none.
+     */
+    TreeNode *child(TreeNode *parent, const QString &name);
+
+    /**
+     * @brief Returns the node addressed by the path.
+     *
+     * @param root The root node of the tree.
+     * @param path The path.
+     * @param fetch Called on every node before its children are looked at, may be empty.
+     * @return The node, or nullptr if the path does not resolve.
+     */
+    TreeNode *resolve(TreeNode *root, const QString &path, const FetchFunction &fetch = FetchFunction());
+}
+
+#endif // __JSON_POINTER_H__
@@ -0,0 +1,470 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonStreamReader.cpp                                              *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the JsonStreamReader class, a single pass, SAX style JSON *
+ * reader that pulls the input from a QIODevice in chunks.                     *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QVarLengthArray>
+#include "JsonStreamReader.h"
+
+// default number of bytes requested from the device at a time
+static const qint64 DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+// checks the number grammar of RFC 8259: -? (0 | [1-9][0-9]*) (.[0-9]+)? ([eE][+-]?[0-9]+)?
+static bool isJsonNumber(const QByteArray &text)
+{
+    const char *c = text.constData();
+    const char *end = c + text.size();
+    const auto digits = [&c, end]() {
+        const char *start = c;
+        while (c != end && *c >= '0' && *c <= '9') {
+            ++c;
+        }
+        return c != start;
+    };
+
+    if (c != end && *c == '-') {
+        ++c;
+    }
+    if (c != end && *c == '0') {
+        // a zero is never followed by more digits, e.g. `01` is rejected
+        ++c;
+    } else if (!digits()) {
+        return false;
+    }
+    if (c != end && *c == '.') {
+        ++c;
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (c != end && (*c == 'e' || *c == 'E')) {
+        ++c;
+        if (c != end && (*c == '+' || *c == '-')) {
+            ++c;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+    return c == end;
+}
+
+JsonStreamReader::JsonStreamReader(JsonStreamHandler *handler)
+    : _handler{handler},
+      _chunkSize{DEFAULT_CHUNK_SIZE},
+      _device{nullptr},
+      _pos{0},
+      _bufferOffset{0},
+      _bytesRead{0},
+      _aborted{false},
+      _errorOffset{-1} {}
+
+void JsonStreamReader::setChunkCallback(const ChunkCallback &callback)
+{
+    _chunkCallback = callback;
+}
+
+bool JsonStreamReader::parse(QIODevice *device)
+{
+    enum Expect {
+        ExpectValue,        // any value
+        ExpectValueOrEnd,   // right after '[': a value or ']'
+        ExpectKeyOrEnd,     // right after '{': a key or '}'
+        ExpectKey,          // after ',' in an object
+        ExpectColon,        // after a key
+        ExpectCommaOrEnd,   // after a value inside a container
+        ExpectEnd           // after the top-level value, only whitespace may follow
+    };
+
+    _device = device;
+    _buffer.resize(0);
+    _pos = 0;
+    _bufferOffset = 0;
+    _bytesRead = 0;
+    _stack.clear();
+    _aborted = false;
+    _errorString.clear();
+    _errorOffset = -1;
+
+    Expect expect = ExpectValue;
+    QString text;
+
+    while (true) {
+        skipWhitespace();
+        const int c = peek();
+
+        if (c < 0) {
+            if (_aborted) {
+                return false;
+            }
+            if (expect == ExpectEnd) {
+                return true;
+            }
+            return setError(QStringLiteral("unexpected end of input"));
+        }
+
+        // closing brackets are valid right after an opening bracket or a value
+        if ((c == '}' || c == ']')
+            && (expect == ExpectKeyOrEnd || expect == ExpectValueOrEnd || expect == ExpectCommaOrEnd)) {
+            const Container container = (c == '}') ? ObjectContainer : ArrayContainer;
+            if (_stack.isEmpty() || _stack.last() != container) {
+                return setError(QStringLiteral("mismatched '%1'").arg(QChar(c)));
+            }
+            ++_pos;
+            _stack.removeLast();
+            if (container == ObjectContainer) {
+                _handler->endObject();
+            } else {
+                _handler->endArray();
+            }
+            expect = _stack.isEmpty() ? ExpectEnd : ExpectCommaOrEnd;
+            continue;
+        }
+
+        switch (expect) {
+        case ExpectEnd:
+            return setError(QStringLiteral("unexpected data after the document"));
+
+        case ExpectColon:
+            if (c != ':') {
+                return setError(QStringLiteral("':' expected"));
+            }
+            ++_pos;
+            expect = ExpectValue;
+            continue;
+
+        case ExpectCommaOrEnd:
+            if (c != ',') {
+                return setError(QStringLiteral("',' expected"));
+            }
+            ++_pos;
+            expect = (_stack.last() == ObjectContainer) ? ExpectKey : ExpectValue;
+            continue;
+
+        case ExpectKeyOrEnd:
+        case ExpectKey:
+            if (c != '"') {
+                return setError(QStringLiteral("key expected"));
+            }
+            if (!readString(text)) {
+                return false;
+            }
+            _handler->key(text);
+            expect = ExpectColon;
+            continue;
+
+        case ExpectValueOrEnd:
+        case ExpectValue:
+            break;
+        }
+
+        if (c == '{') {
+            ++_pos;
+            _stack.append(ObjectContainer);
+            _handler->startObject();
+            expect = ExpectKeyOrEnd;
+            continue;
+        }
+
+        if (c == '[') {
+            ++_pos;
+            _stack.append(ArrayContainer);
+            _handler->startArray();
+            expect = ExpectValueOrEnd;
+            continue;
+        }
+
+        if (c == '"') {
+            if (!readString(text)) {
+                return false;
+            }
+            _handler->value(text);
+        } else if (c == 't') {
+            if (!readLiteral("true")) {
+                return false;
+            }
+            _handler->value(true);
+        } else if (c == 'f') {
+            if (!readLiteral("false")) {
+                return false;
+            }
+            _handler->value(false);
+        } else if (c == 'n') {
+            if (!readLiteral("null")) {
+                return false;
+            }
+            _handler->value(QVariant());
+        } else if (c == '-' || (c >= '0' && c <= '9')) {
+            QVariant number;
+            if (!readNumber(number)) {
+                return false;
+            }
+            _handler->value(number);
+        } else {
+            return setError(QStringLiteral("unexpected character '%1'").arg(QChar(c)));
+        }
+
+        expect = _stack.isEmpty() ? ExpectEnd : ExpectCommaOrEnd;
+    }
+}
+
+bool JsonStreamReader::fill()
+{
+    if (_pos < _buffer.size()) {
+        return true;
+    }
+    if (_aborted) {
+        return false;
+    }
+
+    // reusing the buffer, so that reading does not allocate per chunk
+    _bufferOffset += _buffer.size();
+    _buffer.resize(_chunkSize);
+    const qint64 count = _device->read(_buffer.data(), _chunkSize);
+    _buffer.resize(count > 0 ? int(count) : 0);
+    _pos = 0;
+
+    if (_buffer.isEmpty()) {
+        return false;
+    }
+
+    _bytesRead += _buffer.size();
+    if (_chunkCallback && !_chunkCallback(_bytesRead)) {
+        _aborted = true;
+        _buffer.resize(0);
+        return false;
+    }
+    return true;
+}
+
+int JsonStreamReader::peek()
+{
+    if (!fill()) {
+        return -1;
+    }
+    return static_cast<uchar>(_buffer.at(_pos));
+}
+
+void JsonStreamReader::skipWhitespace()
+{
+    while (true) {
+        const int c = peek();
+        if (c != ' ' && c != '\n' && c != '\r' && c != '\t') {
+            return;
+        }
+        ++_pos;
+    }
+}
+
+bool JsonStreamReader::readString(QString &result)
+{
+    // skipping the opening quote
+    ++_pos;
+    result.clear();
+
+    // plain bytes are collected and decoded in one go, so UTF-8 sequences
+    // split across chunks come out right
+    QByteArray raw;
+
+    while (true) {
+        if (!fill()) {
+            return setError(QStringLiteral("unterminated string"));
+        }
+
+        const char *data = _buffer.constData();
+        const int size = _buffer.size();
+        const int start = _pos;
+        while (_pos < size) {
+            const uchar ch = static_cast<uchar>(data[_pos]);
+            if (ch == '"' || ch == '\\' || ch < 0x20) {
+                break;
+            }
+            ++_pos;
+        }
+        raw.append(data + start, _pos - start);
+
+        if (_pos >= size) {
+            continue;
+        }
+
+        const uchar ch = static_cast<uchar>(data[_pos]);
+        if (ch == '"') {
+            ++_pos;
+            result += QString::fromUtf8(raw);
+            return true;
+        }
+
+        if (ch < 0x20) {
+            return setError(QStringLiteral("control character in string"));
+        }
+
+        // escape sequence
+        ++_pos;
+        if (!fill()) {
+            return setError(QStringLiteral("unterminated escape sequence"));
+        }
+
+        const char escape = _buffer.at(_pos++);
+        switch (escape) {
+        case '"':  raw.append('"'); break;
+        case '\\': raw.append('\\'); break;
+        case '/':  raw.append('/'); break;
+        case 'b':  raw.append('\b'); break;
+        case 'f':  raw.append('\f'); break;
+        case 'n':  raw.append('\n'); break;
+        case 'r':  raw.append('\r'); break;
+        case 't':  raw.append('\t'); break;
+        case 'u':
+            result += QString::fromUtf8(raw);
+            raw.resize(0);
+            if (!readUnicodeEscape(result)) {
+                return false;
+            }
+            break;
+        default:
+            return setError(QStringLiteral("invalid escape sequence"));
+        }
+    }
+}
+
+bool JsonStreamReader::readHex4(char16_t &codeUnit)
+{
+    codeUnit = 0;
+    for (int i = 0; i < 4; ++i) {
+        const int c = peek();
+        int digit;
+        if (c >= '0' && c <= '9') {
+            digit = c - '0';
+        } else if (c >= 'a' && c <= 'f') {
+            digit = c - 'a' + 10;
+        } else if (c >= 'A' && c <= 'F') {
+            digit = c - 'A' + 10;
+        } else {
+            return setError(QStringLiteral("invalid unicode escape"));
+        }
+        codeUnit = char16_t((codeUnit << 4) | digit);
+        ++_pos;
+    }
+    return true;
+}
+
+bool JsonStreamReader::readUnicodeEscape(QString &result)
+{
+    char16_t high;
+    if (!readHex4(high)) {
+        return false;
+    }
+
+    if (!QChar::isHighSurrogate(high)) {
+        result += QChar(high);
+        return true;
+    }
+
+    // a high surrogate has to be followed by an escaped low surrogate
+    if (peek() != '\\') {
+        return setError(QStringLiteral("unpaired surrogate in unicode escape"));
+    }
+    ++_pos;
+    if (peek() != 'u') {
+        return setError(QStringLiteral("unpaired surrogate in unicode escape"));
+    }
+    ++_pos;
+
+    char16_t low;
+    if (!readHex4(low)) {
+        return false;
+    }
+    if (!QChar::isLowSurrogate(low)) {
+        return setError(QStringLiteral("unpaired surrogate in unicode escape"));
+    }
+
+    result += QChar(high);
+    result += QChar(low);
+    return true;
+}
+
+bool JsonStreamReader::readNumber(QVariant &result)
+{
+    QVarLengthArray<char, 64> number;
+    bool integral = true;
+
+    while (true) {
+        const int c = peek();
+        if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) {
+            break;
+        }
+        if (c == '.' || c == 'e' || c == 'E') {
+            integral = false;
+        }
+        number.append(char(c));
+        ++_pos;
+    }
+
+    const QByteArray text = QByteArray::fromRawData(number.constData(), int(number.size()));
+    if (!isJsonNumber(text)) {
+        return setError(QStringLiteral("invalid number"));
+    }
+    bool ok = false;
+
+    // integer literals stay exact as long as they fit in 64 bits, which goes beyond
+    // QJsonDocument: it keeps integers exact only up to 2^53
+    if (integral) {
+        const qlonglong integer = text.toLongLong(&ok);
+        if (ok) {
+            result = QVariant(integer);
+            return true;
+        }
+    }
+
+    const double real = text.toDouble(&ok);
+    if (!ok) {
+        return setError(QStringLiteral("invalid number"));
+    }
+    result = QVariant(real);
+    return true;
+}
+
+bool JsonStreamReader::readLiteral(const char *word)
+{
+    for (const char *c = word; *c; ++c) {
+        if (peek() != *c) {
+            return setError(QStringLiteral("invalid literal"));
+        }
+        ++_pos;
+    }
+    return true;
+}
+
+bool JsonStreamReader::setError(const QString &message)
+{
+    if (_errorString.isEmpty()) {
+        _errorString = message;
+        _errorOffset = _bufferOffset + _pos;
+    }
+    return false;
+}
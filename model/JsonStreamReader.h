@@ -0,0 +1,241 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonStreamReader.h                                                *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the JsonStreamReader class, a single pass, SAX style JSON   *
+ * reader. It pulls the input from a QIODevice in chunks and reports objects,  *
+ * arrays, keys and values to a JsonStreamHandler, so a tree can be built      *
+ * without holding the raw bytes or a QJsonDocument in memory.                 *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __JSON_STREAM_READER_H__
+#define __JSON_STREAM_READER_H__
+
+#include <functional>
+
+#include <QVector>
+#include <QString>
+#include <QVariant>
+#include <QIODevice>
+#include <QByteArray>
+
+
+class JsonStreamHandler
+{
+public:
+    virtual ~JsonStreamHandler() = default;
+
+    /**
+     * @brief Called when an object (`{`) starts.
+     */
+    virtual void startObject() = 0;
+
+    /**
+     * @brief Called when the innermost open object (`}`) ends.
+     */
+    virtual void endObject() = 0;
+
+    /**
+     * @brief Called when an array (`[`) starts.
+     */
+    virtual void startArray() = 0;
+
+    /**
+     * @brief Called when the innermost open array (`]`) ends.
+     */
+    virtual void endArray() = 0;
+
+    /**
+     * @brief Called for every key of an object, right before its value.
+     *
+     * @param name The decoded key.
+     */
+    virtual void key(const QString &name) = 0;
+
+    /**
+     * @brief Called for every scalar value.
+     *
+     * @param value A QString, qlonglong, double or bool, or a null QVariant for JSON null.
+     */
+    virtual void value(const QVariant &value) = 0;
+};
+
+
+class JsonStreamReader
+{
+public:
+    /**
+     * @brief Callback invoked after every chunk read from the device.
+     *
+     * Receives the total number of bytes read so far. Returning false aborts
+     * parsing, which is how callers implement cancellation.
+     */
+    using ChunkCallback = std::function<bool(qint64)>;
+
+    /**
+     * @brief Constructs a JsonStreamReader reporting to the given handler.
+     *
+     * @param handler The handler receiving the parse events, not owned.
+     */
+    explicit JsonStreamReader(JsonStreamHandler *handler);
+
+    /**
+     * @brief Parses one JSON document from the device.
+     *
+     * The device is read in chunks of `chunkSize()` bytes and only the current
+     * chunk is held in memory. Events are delivered to the handler as soon as
+     * they are recognized, so on failure the handler may have seen a prefix of
+     * the document.
+     *
+     * @param device The device to read from, must be open for reading.
+     * @return True if a complete, well-formed document was read.
+     */
+    bool parse(QIODevice *device);
+
+    /**
+     * @brief Sets the callback invoked after every chunk.
+     *
+     * @param callback The callback, see `ChunkCallback`.
+     */
+    void setChunkCallback(const ChunkCallback &callback);
+
+    /**
+     * @brief Sets the number of bytes requested from the device at a time.
+     *
+     * @param chunkSize The chunk size in bytes (default 1 MiB).
+     */
+    inline void setChunkSize(qint64 chunkSize) { _chunkSize = chunkSize; }
+
+    /**
+     * @brief Returns the number of bytes requested from the device at a time.
+     */
+    inline qint64 chunkSize() const { return _chunkSize; }
+
+    /**
+     * @brief Returns true if parsing was aborted by the chunk callback.
+     */
+    inline bool isAborted() const { return _aborted; }
+
+    /**
+     * @brief Returns a description of the last parse error.
+     */
+    inline QString errorString() const { return _errorString; }
+
+    /**
+     * @brief Returns the byte offset at which the last parse error occurred.
+     */
+    inline qint64 errorOffset() const { return _errorOffset; }
+
+private:
+    /**
+     * @brief Makes sure at least one unread byte is buffered.
+     *
+     * @return False at the end of the input or if parsing was aborted.
+     */
+    bool fill();
+
+    /**
+     * @brief Returns the next byte without consuming it, or -1 at the end of the input.
+     */
+    int peek();
+
+    /**
+     * @brief Skips JSON whitespace.
+     */
+    void skipWhitespace();
+
+    /**
+     * @brief Reads a string token, the opening quote must be the next byte.
+     *
+     * @param result Receives the decoded string.
+     * @return False on malformed input.
+     */
+    bool readString(QString &result);
+
+    /**
+     * @brief Reads a `\u` escape (without the backslash and `u`) and appends it to `result`.
+     *
+     * Surrogate pairs spanning two escapes are combined.
+     *
+     * @param result The string to append the decoded code point to.
+     * @return False on malformed input.
+     */
+    bool readUnicodeEscape(QString &result);
+
+    /**
+     * @brief Reads four hex digits.
+     *
+     * @param codeUnit Receives the decoded UTF-16 code unit.
+     * @return False on malformed input.
+     */
+    bool readHex4(char16_t &codeUnit);
+
+    /**
+     * @brief Reads a number token.
+     *
+     * @param result Receives the number, a qlonglong for integer literals that
+     *               fit in 64 bits, a double otherwise.
+     * @return False on malformed input.
+     */
+    bool readNumber(QVariant &result);
+
+    /**
+     * @brief Reads the literal `word` (true, false or null).
+     *
+     * @return False if the input does not match.
+     */
+    bool readLiteral(const char *word);
+
+    /**
+     * @brief Records a parse error at the current offset.
+     *
+     * @param message The error description.
+     * @return Always false, for use in return statements.
+     */
+    bool setError(const QString &message);
+
+private:
+    enum Container {
+        ObjectContainer,
+        ArrayContainer
+    };
+
+    JsonStreamHandler *_handler;
+    ChunkCallback _chunkCallback;
+    qint64 _chunkSize;
+
+    QIODevice *_device;
+    QByteArray _buffer;
+    int _pos;
+    qint64 _bufferOffset;
+    qint64 _bytesRead;
+
+    QVector<Container> _stack;
+    bool _aborted;
+    QString _errorString;
+    qint64 _errorOffset;
+};
+
+#endif // __JSON_STREAM_READER_H__
@@ -0,0 +1,370 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonStreamWriter.cpp                                              *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the JsonStreamWriter class, a buffered writer of JSON     *
+ * text to a QIODevice.                                                        *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cmath>
+#include <QLocale>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "JsonStreamWriter.h"
+
+// bytes collected before a write to the device
+static const int DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+static const int INDENT_WIDTH = 4;
+
+JsonStreamWriter::JsonStreamWriter(QIODevice *device, QJsonDocument::JsonFormat format)
+    : _device{device},
+      _bufferSize{DEFAULT_BUFFER_SIZE},
+      _compact{format == QJsonDocument::Compact},
+      _afterKey{false},
+      _error{false}
+{
+    _buffer.reserve(_bufferSize);
+}
+
+JsonStreamWriter::~JsonStreamWriter()
+{
+    flushBuffer();
+}
+
+void JsonStreamWriter::setBufferSize(int bufferSize)
+{
+    _bufferSize = qMax(1, bufferSize);
+    _buffer.reserve(_bufferSize);
+}
+
+void JsonStreamWriter::startObject()
+{
+    startContainer('{');
+}
+
+void JsonStreamWriter::endObject()
+{
+    endContainer('}');
+}
+
+void JsonStreamWriter::startArray()
+{
+    startContainer('[');
+}
+
+void JsonStreamWriter::endArray()
+{
+    endContainer(']');
+}
+
+void JsonStreamWriter::key(const QString &name)
+{
+    prepareValue();
+
+    // the key itself takes no separator
+    _afterKey = true;
+    stringValue(name);
+
+    if (_compact) {
+        append(':');
+    } else {
+        append(": ", 2);
+    }
+    _afterKey = true;
+}
+
+void JsonStreamWriter::nullValue()
+{
+    prepareValue();
+    append("null", 4);
+}
+
+void JsonStreamWriter::boolValue(bool value)
+{
+    prepareValue();
+    if (value) {
+        append("true", 4);
+    } else {
+        append("false", 5);
+    }
+}
+
+void JsonStreamWriter::integerValue(qint64 value)
+{
+    prepareValue();
+    const QByteArray number = QByteArray::number(value);
+    append(number.constData(), int(number.size()));
+}
+
+void JsonStreamWriter::doubleValue(double value)
+{
+    if (!std::isfinite(value)) {
+        nullValue();
+        return;
+    }
+
+    prepareValue();
+    const QByteArray number = formatDouble(value);
+    append(number.constData(), int(number.size()));
+}
+
+void JsonStreamWriter::stringValue(const QString &value)
+{
+    static const char HEX[] = "0123456789abcdef";
+
+    prepareValue();
+    append('"');
+
+    const QChar *c = value.constData();
+    const QChar *end = c + value.size();
+    for (; c < end; ++c) {
+        const char16_t unit = c->unicode();
+
+        if (unit >= 0x20 && unit < 0x80) {
+            if (unit == '"' || unit == '\\') {
+                append('\\');
+            }
+            append(char(unit));
+            continue;
+        }
+
+        if (unit < 0x20) {
+            switch (unit) {
+            case '\b': append("\\b", 2); break;
+            case '\f': append("\\f", 2); break;
+            case '\n': append("\\n", 2); break;
+            case '\r': append("\\r", 2); break;
+            case '\t': append("\\t", 2); break;
+            default: {
+                const char escape[] = {'\\', 'u', '0', '0', HEX[unit >> 4], HEX[unit & 0xf]};
+                append(escape, 6);
+                break;
+            }
+            }
+            continue;
+        }
+
+        // everything else is written as UTF-8, like QJsonDocument does
+        char32_t codePoint = unit;
+        if (QChar::isHighSurrogate(unit) && c + 1 < end && c[1].isLowSurrogate()) {
+            codePoint = QChar::surrogateToUcs4(unit, c[1].unicode());
+            ++c;
+        } else if (QChar::isSurrogate(unit)) {
+            codePoint = QChar::ReplacementCharacter;
+        }
+
+        char utf8[4];
+        int size = 0;
+        if (codePoint < 0x800) {
+            utf8[size++] = char(0xc0 | (codePoint >> 6));
+        } else if (codePoint < 0x10000) {
+            utf8[size++] = char(0xe0 | (codePoint >> 12));
+            utf8[size++] = char(0x80 | ((codePoint >> 6) & 0x3f));
+        } else {
+            utf8[size++] = char(0xf0 | (codePoint >> 18));
+            utf8[size++] = char(0x80 | ((codePoint >> 12) & 0x3f));
+            utf8[size++] = char(0x80 | ((codePoint >> 6) & 0x3f));
+        }
+        utf8[size++] = char(0x80 | (codePoint & 0x3f));
+        append(utf8, size);
+    }
+
+    append('"');
+}
+
+void JsonStreamWriter::jsonValue(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        boolValue(value.toBool());
+        break;
+    case QJsonValue::Double:
+        // toVariant() tells the integers QJsonDocument read from the doubles
+        if (value.toVariant().userType() == QMetaType::LongLong) {
+            integerValue(value.toInteger());
+        } else {
+            doubleValue(value.toDouble());
+        }
+        break;
+    case QJsonValue::String:
+        stringValue(value.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray jsonArray = value.toArray();
+        startArray();
+        for (const QJsonValue &element : jsonArray) {
+            jsonValue(element);
+        }
+        endArray();
+        break;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject jsonObject = value.toObject();
+        startObject();
+        for (auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); ++it) {
+            key(it.key());
+            jsonValue(it.value());
+        }
+        endObject();
+        break;
+    }
+    default:
+        nullValue();
+        break;
+    }
+}
+
+int JsonStreamWriter::integerSize(qint64 value)
+{
+    // the sign, then one byte per digit
+    int size = value < 0 ? 2 : 1;
+    quint64 magnitude = value < 0 ? 0 - quint64(value) : quint64(value);
+    while (magnitude >= 10) {
+        magnitude /= 10;
+        ++size;
+    }
+    return size;
+}
+
+int JsonStreamWriter::doubleSize(double value)
+{
+    if (!std::isfinite(value)) {
+        return 4;
+    }
+    return int(formatDouble(value).size());
+}
+
+qint64 JsonStreamWriter::stringSize(const QString &value)
+{
+    // mirrors stringValue()
+    qint64 size = 2;
+
+    const QChar *c = value.constData();
+    const QChar *end = c + value.size();
+    for (; c < end; ++c) {
+        const char16_t unit = c->unicode();
+
+        if (unit >= 0x20 && unit < 0x80) {
+            size += (unit == '"' || unit == '\\') ? 2 : 1;
+        } else if (unit < 0x20) {
+            const bool shortEscape = unit == '\b' || unit == '\f' || unit == '\n' || unit == '\r' || unit == '\t';
+            size += shortEscape ? 2 : 6;
+        } else if (unit < 0x800) {
+            size += 2;
+        } else if (QChar::isHighSurrogate(unit) && c + 1 < end && c[1].isLowSurrogate()) {
+            size += 4;
+            ++c;
+        } else {
+            // lone surrogates are written as U+FFFD, three bytes as well
+            size += 3;
+        }
+    }
+    return size;
+}
+
+QByteArray JsonStreamWriter::formatDouble(double value)
+{
+    QByteArray number = QByteArray::number(value, 'g', QLocale::FloatingPointShortest);
+
+    // "3" would be read back as an integer
+    if (number.indexOf('.') < 0 && number.indexOf('e') < 0) {
+        number.append(".0", 2);
+    }
+    return number;
+}
+
+bool JsonStreamWriter::finish()
+{
+    if (!_compact) {
+        append('\n');
+    }
+    flushBuffer();
+    return !_error;
+}
+
+void JsonStreamWriter::prepareValue()
+{
+    if (_afterKey) {
+        _afterKey = false;
+        return;
+    }
+    if (_hasMembers.isEmpty()) {
+        return;
+    }
+
+    if (_hasMembers.last()) {
+        append(',');
+    }
+    _hasMembers.last() = true;
+    newLine();
+}
+
+void JsonStreamWriter::startContainer(char bracket)
+{
+    prepareValue();
+    append(bracket);
+    _hasMembers.append(false);
+}
+
+void JsonStreamWriter::endContainer(char bracket)
+{
+    const bool hasMembers = _hasMembers.takeLast();
+    if (hasMembers) {
+        newLine();
+    }
+    append(bracket);
+}
+
+void JsonStreamWriter::newLine()
+{
+    if (_compact) {
+        return;
+    }
+    append('\n');
+    for (int i = _hasMembers.count() * INDENT_WIDTH; i > 0; --i) {
+        append(' ');
+    }
+}
+
+void JsonStreamWriter::append(const char *data, int size)
+{
+    _buffer.append(data, size);
+    if (_buffer.size() >= _bufferSize) {
+        flushBuffer();
+    }
+}
+
+void JsonStreamWriter::flushBuffer()
+{
+    if (_buffer.isEmpty()) {
+        return;
+    }
+    if (!_error && _device->write(_buffer) != _buffer.size()) {
+        _error = true;
+    }
+    // clear() would drop the reserved capacity
+    _buffer.resize(0);
+}
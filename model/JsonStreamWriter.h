@@ -0,0 +1,213 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: JsonStreamWriter.h                                                *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the JsonStreamWriter class, which writes JSON text to a     *
+ * QIODevice through a fixed-size buffer, one token at a time, without         *
+ * building a QJsonDocument first.                                             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __JSON_STREAM_WRITER_H__
+#define __JSON_STREAM_WRITER_H__
+
+#include <QVector>
+#include <QString>
+#include <QIODevice>
+#include <QByteArray>
+#include <QJsonValue>
+#include <QJsonDocument>
+
+
+class JsonStreamWriter
+{
+public:
+    /**
+     * @brief Constructs a JsonStreamWriter writing to the given device.
+     *
+     * @param device The device to write to, must be open for writing; not owned.
+     * @param format Compact output, or indented by four spaces like `QJsonDocument::toJson()`.
+     */
+    explicit JsonStreamWriter(QIODevice *device, QJsonDocument::JsonFormat format = QJsonDocument::Indented);
+
+    /**
+     * @brief Destructor for the JsonStreamWriter class, writes out what is still buffered.
+     */
+    ~JsonStreamWriter();
+
+    /**
+     * @brief Sets the number of bytes collected before they are written to the device.
+     *
+     * @param bufferSize The buffer size in bytes (default 64 KiB).
+     */
+    void setBufferSize(int bufferSize);
+
+    /**
+     * @brief Returns the number of bytes collected before they are written to the device.
+     */
+    inline int bufferSize() const { return _bufferSize; }
+
+    /**
+     * @brief Starts an object (`{`), as a value or as the document.
+     */
+    void startObject();
+
+    /**
+     * @brief Ends the innermost open object (`}`).
+     */
+    void endObject();
+
+    /**
+     * @brief Starts an array (`[`), as a value or as the document.
+     */
+    void startArray();
+
+    /**
+     * @brief Ends the innermost open array (`]`).
+     */
+    void endArray();
+
+    /**
+     * @brief Writes the key of the next member of the innermost open object.
+     *
+     * @param name The key.
+     */
+    void key(const QString &name);
+
+    /**
+     * @brief Writes `null`.
+     */
+    void nullValue();
+
+    /**
+     * @brief Writes `true` or `false`.
+     */
+    void boolValue(bool value);
+
+    /**
+     * @brief Writes an integer, so that it is read back as an integer.
+     */
+    void integerValue(qint64 value);
+
+    /**
+     * @brief Writes a double in its shortest exact form, so that it is read back as a double.
+     *
+     * Integral doubles get a `.0` suffix to keep them apart from integers. JSON
+     * has no infinities or NaN, they are written as `null` like `QJsonDocument` does.
+     */
+    void doubleValue(double value);
+
+    /**
+     * @brief Writes a string, escaping quotes, backslashes and control characters.
+     */
+    void stringValue(const QString &value);
+
+    /**
+     * @brief Writes a JSON value; objects and arrays are written member by member.
+     *
+     * Used for subtrees that only exist as JSON, e.g. children that were never built.
+     *
+     * @param value The value to write.
+     */
+    void jsonValue(const QJsonValue &value);
+
+    /**
+     * @brief Ends the document and writes out the buffer.
+     *
+     * @return False if the device refused any of the data.
+     */
+    bool finish();
+
+    /**
+     * @brief Returns true if the device refused any of the data.
+     */
+    inline bool hasError() const { return _error; }
+
+    /**
+     * @brief Returns the number of bytes `integerValue()` writes for a value.
+     */
+    static int integerSize(qint64 value);
+
+    /**
+     * @brief Returns the number of bytes `doubleValue()` writes for a value.
+     */
+    static int doubleSize(double value);
+
+    /**
+     * @brief Returns the number of bytes `stringValue()` writes for a value, quotes included.
+     */
+    static qint64 stringSize(const QString &value);
+
+private:
+    static QByteArray formatDouble(double value);
+    /**
+     * @brief Writes the separator and indentation that go before a value or key.
+     */
+    void prepareValue();
+
+    /**
+     * @brief Opens a container with the given bracket.
+     */
+    void startContainer(char bracket);
+
+    /**
+     * @brief Closes the innermost container with the given bracket.
+     */
+    void endContainer(char bracket);
+
+    /**
+     * @brief Writes a line break and the indentation of the current depth.
+     */
+    void newLine();
+
+    /**
+     * @brief Appends raw bytes, writing the buffer out once it is full.
+     */
+    void append(const char *data, int size);
+
+    /**
+     * @brief Appends a single byte, writing the buffer out once it is full.
+     */
+    inline void append(char c) {
+        _buffer.append(c);
+        if (_buffer.size() >= _bufferSize) {
+            flushBuffer();
+        }
+    }
+
+    /**
+     * @brief Writes the buffer to the device.
+     */
+    void flushBuffer();
+
+    QIODevice *_device;
+    QByteArray _buffer;
+    int _bufferSize;
+    bool _compact;
+    bool _afterKey;         // the next value belongs to the key just written
+    bool _error;
+    QVector<bool> _hasMembers;  // per open container, whether a value was written into it
+};
+
+#endif // __JSON_STREAM_WRITER_H__
@@ -0,0 +1,340 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: MsgPackReader.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the MsgPackReader class, a chunked MessagePack reader     *
+ * that reports the document as the events of a JsonStreamHandler.             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cstring>
+#include <limits>
+#include <QVector>
+#include <QtEndian>
+#include "MsgPackReader.h"
+
+// default number of bytes requested from the device at a time
+static const qint64 DEFAULT_CHUNK_SIZE = 1024 * 1024;
+
+MsgPackReader::MsgPackReader(JsonStreamHandler *handler)
+    : _handler{handler},
+      _chunkSize{DEFAULT_CHUNK_SIZE},
+      _device{nullptr},
+      _pos{0},
+      _bufferOffset{0},
+      _bytesRead{0},
+      _aborted{false},
+      _errorOffset{-1} {}
+
+void MsgPackReader::setChunkCallback(const JsonStreamReader::ChunkCallback &callback)
+{
+    _chunkCallback = callback;
+}
+
+bool MsgPackReader::parse(QIODevice *device)
+{
+    // containers carry their size up front, so a frame counts down the items
+    // still to come: two per map entry, one per array element
+    struct Frame {
+        quint64 remaining;
+        bool isMap;
+    };
+
+    _device = device;
+    _buffer.resize(0);
+    _pos = 0;
+    _bufferOffset = 0;
+    _bytesRead = 0;
+    _aborted = false;
+    _errorString.clear();
+    _errorOffset = -1;
+
+    QVector<Frame> frames;
+    QVariant scalar;
+
+    do {
+        if (!frames.isEmpty() && frames.last().remaining == 0) {
+            if (frames.takeLast().isMap) {
+                _handler->endObject();
+            } else {
+                _handler->endArray();
+            }
+            continue;
+        }
+
+        if (!ensure(1)) {
+            return _aborted ? false : setError(QStringLiteral("unexpected end of input"));
+        }
+        const uchar type = uchar(_buffer.at(_pos++));
+
+        Frame *parent = frames.isEmpty() ? nullptr : &frames.last();
+        const bool isKey = parent && parent->isMap && parent->remaining % 2 == 0;
+        if (parent) {
+            --parent->remaining;
+        }
+
+        quint64 size = 0;
+        bool isMap = false;
+        bool isContainer = true;
+        if (type >= 0x80 && type <= 0x8f) {
+            size = type & 0x0f;
+            isMap = true;
+        } else if (type >= 0x90 && type <= 0x9f) {
+            size = type & 0x0f;
+        } else if (type == 0xdc || type == 0xdd) {
+            if (!readUnsigned(type == 0xdc ? 2 : 4, size)) {
+                return _aborted ? false : setError(QStringLiteral("unexpected end of input"));
+            }
+        } else if (type == 0xde || type == 0xdf) {
+            if (!readUnsigned(type == 0xde ? 2 : 4, size)) {
+                return _aborted ? false : setError(QStringLiteral("unexpected end of input"));
+            }
+            isMap = true;
+        } else {
+            isContainer = false;
+        }
+
+        if (isContainer) {
+            if (isKey) {
+                return setError(QStringLiteral("unsupported map key"));
+            }
+            if (isMap) {
+                _handler->startObject();
+                frames.append({size * 2, true});
+            } else {
+                _handler->startArray();
+                frames.append({size, false});
+            }
+            continue;
+        }
+
+        if (!readScalar(type, scalar)) {
+            return false;
+        }
+        if (isKey) {
+            _handler->key(scalar.isNull() ? QStringLiteral("null") : scalar.toString());
+        } else {
+            _handler->value(scalar);
+        }
+    } while (!frames.isEmpty());
+
+    return true;
+}
+
+bool MsgPackReader::readScalar(uchar type, QVariant &result)
+{
+    // positive and negative fixint
+    if (type <= 0x7f) {
+        result = qlonglong(type);
+        return true;
+    }
+    if (type >= 0xe0) {
+        result = qlonglong(qint8(type));
+        return true;
+    }
+
+    quint64 value = 0;
+    quint64 extType = 0;
+    bool ok = true;
+
+    if (type >= 0xa0 && type <= 0xbf) {
+        // fixstr
+        ok = readString(type & 0x1f, result);
+    } else {
+        switch (type) {
+        case 0xc0:
+            result = QVariant();
+            break;
+        case 0xc2:
+        case 0xc3:
+            result = type == 0xc3;
+            break;
+        case 0xc4:
+        case 0xc5:
+        case 0xc6:
+            // bin 8, 16 and 32
+            ok = readUnsigned(1 << (type - 0xc4), value) && readBinary(qint64(value), result);
+            break;
+        case 0xc7:
+        case 0xc8:
+        case 0xc9:
+            // ext 8, 16 and 32, the type byte between length and data is dropped
+            ok = readUnsigned(1 << (type - 0xc7), value) && readUnsigned(1, extType)
+                 && readBinary(qint64(value), result);
+            break;
+        case 0xca:
+            ok = readUnsigned(4, value);
+            if (ok) {
+                const quint32 bits = quint32(value);
+                float number;
+                memcpy(&number, &bits, sizeof(number));
+                result = double(number);
+            }
+            break;
+        case 0xcb:
+            ok = readUnsigned(8, value);
+            if (ok) {
+                double number;
+                memcpy(&number, &value, sizeof(number));
+                result = number;
+            }
+            break;
+        case 0xcc:
+        case 0xcd:
+        case 0xce:
+        case 0xcf:
+            // uint 8, 16, 32 and 64
+            ok = readUnsigned(1 << (type - 0xcc), value);
+            result = value <= quint64(std::numeric_limits<qint64>::max()) ? QVariant(qlonglong(value))
+                                                                           : QVariant(double(value));
+            break;
+        case 0xd0:
+            ok = readUnsigned(1, value);
+            result = qlonglong(qint8(value));
+            break;
+        case 0xd1:
+            ok = readUnsigned(2, value);
+            result = qlonglong(qint16(value));
+            break;
+        case 0xd2:
+            ok = readUnsigned(4, value);
+            result = qlonglong(qint32(value));
+            break;
+        case 0xd3:
+            ok = readUnsigned(8, value);
+            result = qlonglong(qint64(value));
+            break;
+        case 0xd4:
+        case 0xd5:
+        case 0xd6:
+        case 0xd7:
+        case 0xd8:
+            // fixext 1, 2, 4, 8 and 16, the type byte in front of the data is dropped
+            ok = readUnsigned(1, extType) && readBinary(1 << (type - 0xd4), result);
+            break;
+        case 0xd9:
+        case 0xda:
+        case 0xdb:
+            // str 8, 16 and 32
+            ok = readUnsigned(1 << (type - 0xd9), value) && readString(qint64(value), result);
+            break;
+        default:
+            return setError(QStringLiteral("invalid type byte 0x%1").arg(type, 2, 16, QLatin1Char('0')));
+        }
+    }
+
+    if (!ok && !_aborted) {
+        return setError(QStringLiteral("unexpected end of input"));
+    }
+    return ok;
+}
+
+bool MsgPackReader::readUnsigned(int size, quint64 &result)
+{
+    if (!ensure(size)) {
+        return false;
+    }
+    const uchar *data = reinterpret_cast<const uchar *>(_buffer.constData() + _pos);
+    switch (size) {
+    case 1:
+        result = data[0];
+        break;
+    case 2:
+        result = qFromBigEndian<quint16>(data);
+        break;
+    case 4:
+        result = qFromBigEndian<quint32>(data);
+        break;
+    default:
+        result = qFromBigEndian<quint64>(data);
+        break;
+    }
+    _pos += size;
+    return true;
+}
+
+bool MsgPackReader::readString(qint64 length, QVariant &result)
+{
+    if (!ensure(length)) {
+        return false;
+    }
+    result = QString::fromUtf8(_buffer.constData() + _pos, length);
+    _pos += length;
+    return true;
+}
+
+bool MsgPackReader::readBinary(qint64 length, QVariant &result)
+{
+    if (!ensure(length)) {
+        return false;
+    }
+    const QByteArray data = QByteArray::fromRawData(_buffer.constData() + _pos, length);
+    result = QString::fromLatin1(data.toBase64(QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals));
+    _pos += length;
+    return true;
+}
+
+bool MsgPackReader::ensure(qint64 count)
+{
+    while (_buffer.size() - _pos < count) {
+        if (_aborted) {
+            return false;
+        }
+
+        // what is left of the chunk moves to the front, a value longer than a
+        // chunk grows the buffer until it fits
+        if (_pos > 0) {
+            _bufferOffset += _pos;
+            _buffer.remove(0, _pos);
+            _pos = 0;
+        }
+        const qsizetype buffered = _buffer.size();
+        const qint64 wanted = qMax(_chunkSize, count - buffered);
+        _buffer.resize(buffered + wanted);
+        const qint64 read = _device->read(_buffer.data() + buffered, wanted);
+        _buffer.resize(buffered + (read > 0 ? read : 0));
+
+        if (read <= 0) {
+            return false;
+        }
+
+        _bytesRead += read;
+        if (_chunkCallback && !_chunkCallback(_bytesRead)) {
+            _aborted = true;
+            _buffer.resize(0);
+            _pos = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool MsgPackReader::setError(const QString &message)
+{
+    if (_errorString.isEmpty()) {
+        _errorString = message;
+        _errorOffset = _bufferOffset + _pos;
+    }
+    return false;
+}
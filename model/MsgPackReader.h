@@ -0,0 +1,156 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: MsgPackReader.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the MsgPackReader class, a chunked MessagePack reader that  *
+ * reports the document as the events of a JsonStreamHandler.                  *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __MSGPACK_READER_H__
+#define __MSGPACK_READER_H__
+
+#include <QString>
+#include <QVariant>
+#include <QIODevice>
+#include <QByteArray>
+
+#include "JsonStreamReader.h"
+
+
+class MsgPackReader
+{
+public:
+    /**
+     * @brief Constructs a MsgPackReader reporting to the given handler.
+     *
+     * @param handler The handler receiving the parse events, not owned.
+     */
+    explicit MsgPackReader(JsonStreamHandler *handler);
+
+    /**
+     * @brief Parses one MessagePack document from the device.
+     *
+     * The device is read in chunks of `chunkSize()` bytes and only the current
+     * chunk (or a single string longer than that) is held in memory. Integers
+     * that do not fit in 64 bits become doubles, binary and extension data
+     * become base64url strings, and non-string map keys are converted to
+     * strings, like `CborDocumentReader` does.
+     *
+     * @param device The device to read from, must be open for reading.
+     * @return True if a complete, well-formed document was read.
+     */
+    bool parse(QIODevice *device);
+
+    /**
+     * @brief Sets the callback invoked after every chunk.
+     *
+     * @param callback The callback, see `JsonStreamReader::ChunkCallback`.
+     */
+    void setChunkCallback(const JsonStreamReader::ChunkCallback &callback);
+
+    /**
+     * @brief Sets the number of bytes requested from the device at a time.
+     *
+     * @param chunkSize The chunk size in bytes (default 1 MiB).
+     */
+    inline void setChunkSize(qint64 chunkSize) { _chunkSize = chunkSize; }
+
+    /**
+     * @brief Returns true if parsing was aborted by the chunk callback.
+     */
+    inline bool isAborted() const { return _aborted; }
+
+    /**
+     * @brief Returns a description of the last parse error.
+     */
+    inline QString errorString() const { return _errorString; }
+
+    /**
+     * @brief Returns the byte offset at which the last parse error occurred.
+     */
+    inline qint64 errorOffset() const { return _errorOffset; }
+
+private:
+    /**
+     * @brief Makes sure at least `count` unread bytes are buffered.
+     *
+     * @return False at the end of the input or if parsing was aborted.
+     */
+    bool ensure(qint64 count);
+
+    /**
+     * @brief Reads a big-endian unsigned integer of `size` bytes (1, 2, 4 or 8).
+     *
+     * @return False at the end of the input.
+     */
+    bool readUnsigned(int size, quint64 &result);
+
+    /**
+     * @brief Reads the scalar whose type byte has just been consumed.
+     *
+     * @param type The type byte.
+     * @param result Receives the value, a QString, qlonglong, double or bool, or a null QVariant.
+     * @return False on malformed input.
+     */
+    bool readScalar(uchar type, QVariant &result);
+
+    /**
+     * @brief Reads `length` bytes of UTF-8 as a string.
+     *
+     * @return False at the end of the input.
+     */
+    bool readString(qint64 length, QVariant &result);
+
+    /**
+     * @brief Reads `length` bytes of binary data as a base64url string.
+     *
+     * @return False at the end of the input.
+     */
+    bool readBinary(qint64 length, QVariant &result);
+
+    /**
+     * @brief Records a parse error at the current offset.
+     *
+     * @param message The error description.
+     * @return Always false, for use in return statements.
+     */
+    bool setError(const QString &message);
+
+    JsonStreamHandler *_handler;
+    JsonStreamReader::ChunkCallback _chunkCallback;
+    qint64 _chunkSize;
+
+    QIODevice *_device;
+    QByteArray _buffer;
+    qsizetype _pos;
+    qint64 _bufferOffset;
+    qint64 _bytesRead;
+
+    bool _aborted;
+    QString _errorString;
+    qint64 _errorOffset;
+};
+
+#endif // __MSGPACK_READER_H__
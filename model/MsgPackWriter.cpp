@@ -0,0 +1,223 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: MsgPackWriter.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the MsgPackWriter class, which writes MessagePack to a    *
+ * QIODevice through a fixed-size buffer.                                      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cstring>
+#include <QtEndian>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "MsgPackWriter.h"
+
+// bytes collected before a write to the device
+static const int DEFAULT_BUFFER_SIZE = 64 * 1024;
+
+MsgPackWriter::MsgPackWriter(QIODevice *device)
+    : _device{device},
+      _bufferSize{DEFAULT_BUFFER_SIZE},
+      _error{false}
+{
+    _buffer.reserve(_bufferSize);
+}
+
+MsgPackWriter::~MsgPackWriter()
+{
+    flushBuffer();
+}
+
+void MsgPackWriter::setBufferSize(int bufferSize)
+{
+    _bufferSize = qMax(1, bufferSize);
+    _buffer.reserve(_bufferSize);
+}
+
+void MsgPackWriter::startObject(qsizetype size)
+{
+    containerHeader(size, 0x80, 0xde);
+}
+
+void MsgPackWriter::startArray(qsizetype size)
+{
+    containerHeader(size, 0x90, 0xdc);
+}
+
+void MsgPackWriter::key(const QString &name)
+{
+    stringValue(name);
+}
+
+void MsgPackWriter::nullValue()
+{
+    append(uchar(0xc0));
+}
+
+void MsgPackWriter::boolValue(bool value)
+{
+    append(uchar(value ? 0xc3 : 0xc2));
+}
+
+void MsgPackWriter::integerValue(qint64 value)
+{
+    if (value >= 0) {
+        if (value <= 0x7f) {
+            append(uchar(value));
+        } else if (value <= 0xff) {
+            appendTyped(0xcc, quint64(value), 1);
+        } else if (value <= 0xffff) {
+            appendTyped(0xcd, quint64(value), 2);
+        } else if (value <= 0xffffffffLL) {
+            appendTyped(0xce, quint64(value), 4);
+        } else {
+            appendTyped(0xcf, quint64(value), 8);
+        }
+        return;
+    }
+
+    // negative values are written in two's complement, truncated to the size
+    if (value >= -32) {
+        append(uchar(qint8(value)));
+    } else if (value >= -128) {
+        appendTyped(0xd0, quint64(value), 1);
+    } else if (value >= -32768) {
+        appendTyped(0xd1, quint64(value), 2);
+    } else if (value >= -2147483648LL) {
+        appendTyped(0xd2, quint64(value), 4);
+    } else {
+        appendTyped(0xd3, quint64(value), 8);
+    }
+}
+
+void MsgPackWriter::doubleValue(double value)
+{
+    quint64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    appendTyped(0xcb, bits, 8);
+}
+
+void MsgPackWriter::stringValue(const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    const qsizetype size = utf8.size();
+    if (size < 32) {
+        append(uchar(0xa0 | size));
+    } else if (size <= 0xff) {
+        appendTyped(0xd9, quint64(size), 1);
+    } else if (size <= 0xffff) {
+        appendTyped(0xda, quint64(size), 2);
+    } else {
+        appendTyped(0xdb, quint64(size), 4);
+    }
+    append(utf8.constData(), size);
+}
+
+void MsgPackWriter::jsonValue(const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        boolValue(value.toBool());
+        break;
+    case QJsonValue::Double:
+        // toVariant() tells the integers QJsonDocument read from the doubles
+        if (value.toVariant().userType() == QMetaType::LongLong) {
+            integerValue(value.toInteger());
+        } else {
+            doubleValue(value.toDouble());
+        }
+        break;
+    case QJsonValue::String:
+        stringValue(value.toString());
+        break;
+    case QJsonValue::Array: {
+        const QJsonArray jsonArray = value.toArray();
+        startArray(jsonArray.size());
+        for (const QJsonValue &element : jsonArray) {
+            jsonValue(element);
+        }
+        break;
+    }
+    case QJsonValue::Object: {
+        const QJsonObject jsonObject = value.toObject();
+        startObject(jsonObject.size());
+        for (auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); ++it) {
+            key(it.key());
+            jsonValue(it.value());
+        }
+        break;
+    }
+    default:
+        nullValue();
+        break;
+    }
+}
+
+bool MsgPackWriter::finish()
+{
+    flushBuffer();
+    return !_error;
+}
+
+void MsgPackWriter::containerHeader(qsizetype size, uchar fixType, uchar type16)
+{
+    if (size < 16) {
+        append(uchar(fixType | size));
+    } else if (size <= 0xffff) {
+        appendTyped(type16, quint64(size), 2);
+    } else {
+        appendTyped(type16 + 1, quint64(size), 4);
+    }
+}
+
+void MsgPackWriter::appendTyped(uchar type, quint64 value, int size)
+{
+    char data[1 + sizeof(quint64)];
+    data[0] = char(type);
+    qToBigEndian<quint64>(value, data + 1);
+    // the low bytes of a big-endian value are its last ones
+    memmove(data + 1, data + 1 + sizeof(quint64) - size, size);
+    append(data, 1 + size);
+}
+
+void MsgPackWriter::append(const char *data, qsizetype size)
+{
+    _buffer.append(data, size);
+    if (_buffer.size() >= _bufferSize) {
+        flushBuffer();
+    }
+}
+
+void MsgPackWriter::flushBuffer()
+{
+    if (_buffer.isEmpty()) {
+        return;
+    }
+    if (!_error && _device->write(_buffer) != _buffer.size()) {
+        _error = true;
+    }
+    // clear() would drop the reserved capacity
+    _buffer.resize(0);
+}
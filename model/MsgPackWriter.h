@@ -0,0 +1,172 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: MsgPackWriter.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the MsgPackWriter class, which writes MessagePack to a      *
+ * QIODevice through a fixed-size buffer.                                      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __MSGPACK_WRITER_H__
+#define __MSGPACK_WRITER_H__
+
+#include <QString>
+#include <QIODevice>
+#include <QByteArray>
+#include <QJsonValue>
+
+
+class MsgPackWriter
+{
+public:
+    /**
+     * @brief Constructs a MsgPackWriter writing to the given device.
+     *
+     * @param device The device to write to, must be open for writing; not owned.
+     */
+    explicit MsgPackWriter(QIODevice *device);
+
+    /**
+     * @brief Destructor for the MsgPackWriter class, writes out what is still buffered.
+     */
+    ~MsgPackWriter();
+
+    /**
+     * @brief Sets the number of bytes collected before they are written to the device.
+     *
+     * @param bufferSize The buffer size in bytes (default 64 KiB).
+     */
+    void setBufferSize(int bufferSize);
+
+    /**
+     * @brief Starts a map of `size` entries, as a value or as the document.
+     *
+     * MessagePack has no end markers, exactly `size` keys and values must follow.
+     */
+    void startObject(qsizetype size);
+
+    /**
+     * @brief Ends the innermost map, writes nothing.
+     */
+    inline void endObject() {}
+
+    /**
+     * @brief Starts an array of `size` elements, as a value or as the document.
+     */
+    void startArray(qsizetype size);
+
+    /**
+     * @brief Ends the innermost array, writes nothing.
+     */
+    inline void endArray() {}
+
+    /**
+     * @brief Writes the key of the next map entry.
+     */
+    void key(const QString &name);
+
+    /**
+     * @brief Writes nil.
+     */
+    void nullValue();
+
+    /**
+     * @brief Writes true or false.
+     */
+    void boolValue(bool value);
+
+    /**
+     * @brief Writes an integer in the smallest encoding that holds it.
+     */
+    void integerValue(qint64 value);
+
+    /**
+     * @brief Writes a double as a 64-bit float, so that it reads back as a double.
+     */
+    void doubleValue(double value);
+
+    /**
+     * @brief Writes a string as UTF-8.
+     */
+    void stringValue(const QString &value);
+
+    /**
+     * @brief Writes a JSON value; objects and arrays are written member by member.
+     *
+     * Used for subtrees that only exist as JSON, e.g. children that were never built.
+     *
+     * @param value The value to write.
+     */
+    void jsonValue(const QJsonValue &value);
+
+    /**
+     * @brief Writes out the buffer.
+     *
+     * @return False if the device refused any of the data.
+     */
+    bool finish();
+
+    /**
+     * @brief Returns true if the device refused any of the data.
+     */
+    inline bool hasError() const { return _error; }
+
+private:
+    /**
+     * @brief Writes a map or array header, `fixType` for up to 15 entries, `type16` or the type after it otherwise.
+     */
+    void containerHeader(qsizetype size, uchar fixType, uchar type16);
+
+    /**
+     * @brief Appends a type byte followed by the `size` low bytes of `value`, big-endian.
+     */
+    void appendTyped(uchar type, quint64 value, int size);
+
+    /**
+     * @brief Appends raw bytes to the buffer, writing it out once it is full.
+     */
+    void append(const char *data, qsizetype size);
+
+    /**
+     * @brief Appends a single byte to the buffer.
+     */
+    inline void append(uchar c) {
+        _buffer.append(char(c));
+        if (_buffer.size() >= _bufferSize) {
+            flushBuffer();
+        }
+    }
+
+    /**
+     * @brief Writes the buffer to the device and empties it.
+     */
+    void flushBuffer();
+
+    QIODevice *_device;
+    QByteArray _buffer;
+    int _bufferSize;
+    bool _error;
+};
+
+#endif // __MSGPACK_WRITER_H__
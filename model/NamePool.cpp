@@ -0,0 +1,71 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: NamePool.cpp                                                      *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the NamePool class, a string interning table for node     *
+ * names.                                                                      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include "NamePool.h"
+
+NamePool::NamePool()
+    : _lookups{0},
+      _bytesStored{0},
+      _bytesSaved{0} {}
+
+QString NamePool::intern(const QString &name)
+{
+    ++_lookups;
+
+    // empty names (array elements) share Qt's static empty data anyway
+    if (name.isEmpty()) {
+        return QString();
+    }
+
+    auto it = _names.constFind(name);
+    if (it != _names.constEnd()) {
+        _bytesSaved += allocationSize(name);
+        return *it;
+    }
+
+    _bytesStored += allocationSize(name);
+    return *_names.insert(name);
+}
+
+void NamePool::merge(const NamePool &other)
+{
+    for (const QString &name : other._names) {
+        _names.insert(name);
+    }
+    _lookups += other._lookups;
+    _bytesStored += other._bytesStored;
+    _bytesSaved += other._bytesSaved;
+}
+
+qint64 NamePool::allocationSize(const QString &name)
+{
+    // allocation header plus the UTF-16 characters and the terminating null
+    return qint64(sizeof(QArrayData)) + (name.size() + 1) * qint64(sizeof(QChar));
+}
@@ -0,0 +1,107 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: NamePool.h                                                        *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the NamePool class, a string interning table for node       *
+ * names. Repeated JSON keys are stored once and every node holding that key   *
+ * shares the same implicitly shared QString data.                             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __NAME_POOL_H__
+#define __NAME_POOL_H__
+
+#include <QSet>
+#include <QString>
+
+
+class NamePool
+{
+public:
+    /**
+     * @brief Constructs an empty pool.
+     */
+    NamePool();
+
+    /**
+     * @brief Returns the pooled copy of the given name.
+     *
+     * The first occurrence of a name is stored in the pool; later occurrences
+     * get a copy of the stored QString, which shares its data, so no further
+     * memory is allocated for them.
+     *
+     * @param name The name to intern.
+     * @return The shared copy of the name.
+     */
+    QString intern(const QString &name);
+
+    /**
+     * @brief Adds the names and counters of another pool to this one.
+     *
+     * Names interned later are shared with the first pool that stored them.
+     * Nodes that already hold the other pool's copies keep them, so the bytes
+     * that pool stored are counted as stored here too.
+     *
+     * @param other The pool to merge.
+     */
+    void merge(const NamePool &other);
+
+    /**
+     * @brief Returns the number of distinct names in the pool.
+     */
+    inline int uniqueNames() const { return _names.size(); }
+
+    /**
+     * @brief Returns the number of names passed to `intern()`.
+     */
+    inline qint64 lookups() const { return _lookups; }
+
+    /**
+     * @brief Returns the bytes used by the character data of the pooled names.
+     */
+    inline qint64 bytesStored() const { return _bytesStored; }
+
+    /**
+     * @brief Returns the bytes that separately allocated copies of the names would have used on top.
+     *
+     * Counts the character data and allocation header of every repeated name
+     * that was served from the pool.
+     */
+    inline qint64 bytesSaved() const { return _bytesSaved; }
+
+private:
+    /**
+     * @brief Returns the heap bytes a separately allocated copy of the name takes.
+     *
+     * @param name The name.
+     */
+    static qint64 allocationSize(const QString &name);
+
+    QSet<QString> _names;
+    qint64 _lookups;
+    qint64 _bytesStored;
+    qint64 _bytesSaved;
+};
+
+#endif // __NAME_POOL_H__
@@ -0,0 +1,272 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeAggregates.cpp                                                *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeAggregates functions, which maintain the subtree  *
+ * aggregates cached on the nodes of a tree.                                   *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QVector>
+#include <QPair>
+#include <QJsonArray>
+#include <QJsonObject>
+#include "TreeAggregates.h"
+#include "JsonStreamWriter.h"
+
+namespace {
+
+/**
+ * @brief Returns what a child adds to its parent's JSON, its key and colon included.
+ */
+qint64 memberSize(const TreeNode *parentNode, const TreeNode *child)
+{
+    if (parentNode->type() == TreeNode::Array) {
+        return child->jsonSize();
+    }
+    return JsonStreamWriter::stringSize(child->name()) + 1 + child->jsonSize();
+}
+
+/**
+ * @brief Returns the commas between `count` members.
+ */
+inline qint64 separators(int count)
+{
+    return count > 1 ? count - 1 : 0;
+}
+
+/**
+ * @brief Returns the size of a scalar JSON value written as compact JSON, the
+ * same as `TreeAggregates::valueSize()` of a node holding it.
+ *
+ * @param value A string, number, bool or null.
+ * @param kind Receives the kind of node the value is stored as.
+ */
+qint64 scalarSize(const QJsonValue &value, TreeNode::ValueKind *kind)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        *kind = TreeNode::BoolValue;
+        return value.toBool() ? 4 : 5;
+    case QJsonValue::Double:
+        // toVariant() tells the integers QJsonDocument read from the doubles, as in TreeNodeArena
+        if (value.toVariant().userType() == QMetaType::LongLong) {
+            *kind = TreeNode::IntegerValue;
+            return JsonStreamWriter::integerSize(value.toInteger());
+        }
+        *kind = TreeNode::DoubleValue;
+        return JsonStreamWriter::doubleSize(value.toDouble());
+    case QJsonValue::String:
+        *kind = TreeNode::StringValue;
+        return JsonStreamWriter::stringSize(value.toString());
+    default:
+        break;
+    }
+    *kind = TreeNode::NullValue;
+    return 4;
+}
+
+/**
+ * @brief Adds the leaves a child contributes to its parent: itself if it is a
+ * leaf, the leaves below it otherwise.
+ */
+void addLeaves(TreeNode::LeafCounts &leaves, const TreeNode *child)
+{
+    if (child->type() == TreeNode::Value) {
+        ++leaves[child->valueKind()];
+        return;
+    }
+    for (std::size_t kind = 0; kind < leaves.size(); ++kind) {
+        leaves[kind] += child->leafCounts()[kind];
+    }
+}
+
+/**
+ * @brief Adds the changes to a node and every ancestor.
+ *
+ * The leaf counts of each node grow by `leavesAdded` and shrink by `leavesRemoved`.
+ */
+void addToAncestors(TreeNodeArena &arena, TreeNode *node, int countDelta, qint64 sizeDelta,
+                    const TreeNode::LeafCounts &leavesAdded = {}, const TreeNode::LeafCounts &leavesRemoved = {})
+{
+    for (TreeNode *current = node; current; current = current->parentNode()) {
+        TreeNode::Aggregates &aggregates = arena.aggregates(current);
+        aggregates.descendantCount += countDelta;
+        aggregates.jsonSize += sizeDelta;
+        for (std::size_t kind = 0; kind < aggregates.leafCounts.size(); ++kind) {
+            aggregates.leafCounts[kind] = aggregates.leafCounts[kind] + leavesAdded[kind] - leavesRemoved[kind];
+        }
+    }
+}
+
+} // namespace
+
+qint64 TreeAggregates::valueSize(const TreeNode *node)
+{
+    switch (node->valueKind()) {
+    case TreeNode::BoolValue:
+        return node->boolValue() ? 4 : 5;
+    case TreeNode::IntegerValue:
+        return JsonStreamWriter::integerSize(node->integerValue());
+    case TreeNode::DoubleValue:
+        return JsonStreamWriter::doubleSize(node->doubleValue());
+    case TreeNode::StringValue:
+        return JsonStreamWriter::stringSize(node->stringValue());
+    case TreeNode::NullValue:
+        break;
+    }
+    return 4;
+}
+
+TreeNode::Aggregates TreeAggregates::ofJson(const QJsonValue &value)
+{
+    // every value adds its own brackets, keys and separators, so a flat walk sums up the subtree
+    TreeNode::Aggregates aggregates;
+    QVector<QJsonValue> stack{value};
+    bool isRoot = true;
+    while (!stack.isEmpty()) {
+        const QJsonValue current = stack.takeLast();
+
+        if (current.isObject()) {
+            const QJsonObject object = current.toObject();
+            aggregates.descendantCount += object.size();
+            aggregates.jsonSize += 2 + separators(object.size());
+            for (auto it = object.constBegin(); it != object.constEnd(); ++it) {
+                aggregates.jsonSize += JsonStreamWriter::stringSize(it.key()) + 1;
+                stack.append(it.value());
+            }
+        } else if (current.isArray()) {
+            const QJsonArray array = current.toArray();
+            aggregates.descendantCount += array.size();
+            aggregates.jsonSize += 2 + separators(array.size());
+            for (const QJsonValue &element : array) {
+                stack.append(element);
+            }
+        } else {
+            TreeNode::ValueKind kind = TreeNode::NullValue;
+            aggregates.jsonSize += scalarSize(current, &kind);
+            // a leaf counts no leaves itself
+            if (!isRoot) {
+                ++aggregates.leafCounts[kind];
+            }
+        }
+        isRoot = false;
+    }
+    return aggregates;
+}
+
+void TreeAggregates::aggregateTree(TreeNodeArena &arena, TreeNode *root, const PendingFunction &pending)
+{
+    // depth-first without recursion; a node is summed up once all its children are
+    QVector<QPair<TreeNode *, bool>> stack{qMakePair(root, false)};
+    while (!stack.isEmpty()) {
+        const QPair<TreeNode *, bool> item = stack.takeLast();
+        TreeNode *node = item.first;
+
+        if (node->type() == TreeNode::Value) {
+            arena.aggregates(node) = {valueSize(node), {}, 0};
+            continue;
+        }
+
+        if (!item.second) {
+            if (node->childCount() == 0) {
+                const QJsonValue value = pending(node);
+                if (!value.isUndefined()) {
+                    arena.aggregates(node) = ofJson(value);
+                    continue;
+                }
+            }
+            stack.append(qMakePair(node, true));
+            for (TreeNode *child : node->children()) {
+                stack.append(qMakePair(child, false));
+            }
+            continue;
+        }
+
+        int count = 0;
+        qint64 size = 2 + separators(node->childCount());
+        TreeNode::LeafCounts leaves{};
+        for (const TreeNode *child : node->children()) {
+            count += 1 + child->descendantCount();
+            size += memberSize(node, child);
+            addLeaves(leaves, child);
+        }
+        arena.aggregates(node) = {size, leaves, count};
+    }
+}
+
+void TreeAggregates::childrenAdded(TreeNodeArena &arena, TreeNode *parentNode, const QList<TreeNode *> &children)
+{
+    int count = 0;
+    qint64 size = separators(parentNode->childCount()) - separators(parentNode->childCount() - children.count());
+    TreeNode::LeafCounts leaves{};
+    for (const TreeNode *child : children) {
+        count += 1 + child->descendantCount();
+        size += memberSize(parentNode, child);
+        addLeaves(leaves, child);
+    }
+    addToAncestors(arena, parentNode, count, size, leaves);
+}
+
+void TreeAggregates::childrenRemoved(TreeNodeArena &arena, TreeNode *parentNode, const QList<TreeNode *> &children)
+{
+    int count = 0;
+    qint64 size = separators(parentNode->childCount() + children.count()) - separators(parentNode->childCount());
+    TreeNode::LeafCounts leaves{};
+    for (const TreeNode *child : children) {
+        count += 1 + child->descendantCount();
+        size += memberSize(parentNode, child);
+        addLeaves(leaves, child);
+    }
+    addToAncestors(arena, parentNode, -count, -size, {}, leaves);
+}
+
+void TreeAggregates::valueChanged(TreeNodeArena &arena, TreeNode *node, TreeNode::ValueKind oldKind)
+{
+    const qint64 size = valueSize(node);
+    const qint64 delta = size - node->jsonSize();
+    if (delta != 0) {
+        addToAncestors(arena, node, 0, delta);
+    }
+
+    // the leaf itself counts no leaves, only its ancestors move it to the new kind
+    if (node->valueKind() != oldKind && node->parentNode()) {
+        TreeNode::LeafCounts added{};
+        TreeNode::LeafCounts removed{};
+        ++added[node->valueKind()];
+        ++removed[oldKind];
+        addToAncestors(arena, node->parentNode(), 0, 0, added, removed);
+    }
+}
+
+void TreeAggregates::pendingChanged(TreeNodeArena &arena, TreeNode *node, const QJsonValue &pending)
+{
+    const TreeNode::Aggregates old = arena.aggregates(node);
+    const TreeNode::Aggregates updated = pending.isUndefined() ? TreeNode::Aggregates{2, {}, 0} : ofJson(pending);
+    arena.aggregates(node) = updated;
+    if (node->parentNode()) {
+        addToAncestors(arena, node->parentNode(), updated.descendantCount - old.descendantCount,
+                       updated.jsonSize - old.jsonSize, updated.leafCounts, old.leafCounts);
+    }
+}
@@ -0,0 +1,123 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeAggregates.h                                                  *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeAggregates functions, which compute the descendant  *
+ * counts, compact JSON sizes and per-kind leaf counts cached on every TreeNode*
+ * and keep them up to date along the ancestors when the tree is edited.       *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_AGGREGATES_H__
+#define __TREE_AGGREGATES_H__
+
+#include <functional>
+
+#include <QList>
+#include <QJsonValue>
+
+#include "TreeNode.h"
+#include "TreeNodeArena.h"
+
+
+namespace TreeAggregates
+{
+    /**
+     * @brief Function returning the JSON value backing a node's unbuilt children,
+     * or an undefined value if it has none or they are only counted once built.
+     */
+    using PendingFunction = std::function<QJsonValue(const TreeNode *)>;
+
+    /**
+     * @brief Returns the size of a leaf's value written as compact JSON.
+     *
+     * @param node A node of type `TreeNode::Value`.
+     */
+    qint64 valueSize(const TreeNode *node);
+
+    /**
+     * @brief Returns the aggregates a node holding a JSON value has once all of it is built.
+     *
+     * Walks the value without recursion, O(size of the value).
+     *
+     * @param value An object, array or scalar.
+     */
+    TreeNode::Aggregates ofJson(const QJsonValue &value);
+
+    /**
+     * @brief Computes the aggregates of every node of a subtree, children first.
+     *
+     * A node whose children are not built yet is aggregated from the JSON value
+     * backing them, so it counts as it will once fetched and fetching it leaves
+     * the aggregates of the tree unchanged. The ancestors of `root` are not updated.
+     *
+     * @param arena The arena of the tree, which holds the aggregates blocks.
+     * @param root The root of the subtree.
+     * @param pending Returns the JSON value backing a node's unbuilt children.
+     */
+    void aggregateTree(TreeNodeArena &arena, TreeNode *root, const PendingFunction &pending);
+
+    /**
+     * @brief Adds children that were just inserted to the aggregates of their parent and its ancestors.
+     *
+     * The children's own aggregates must be computed already, see `aggregateTree()`.
+     * Costs O(depth) plus O(1) per child.
+     *
+     * @param arena The arena of the tree.
+     * @param parentNode The parent, which already holds the children.
+     * @param children The inserted children.
+     */
+    void childrenAdded(TreeNodeArena &arena, TreeNode *parentNode, const QList<TreeNode *> &children);
+
+    /**
+     * @brief Takes children that were just detached out of the aggregates of their parent and its ancestors.
+     *
+     * @param arena The arena of the tree.
+     * @param parentNode The former parent, which no longer holds the children.
+     * @param children The detached children, with their aggregates still intact.
+     */
+    void childrenRemoved(TreeNodeArena &arena, TreeNode *parentNode, const QList<TreeNode *> &children);
+
+    /**
+     * @brief Updates the size of a leaf whose value was just changed, and the
+     * sizes and leaf counts of its ancestors.
+     *
+     * @param arena The arena of the tree.
+     * @param node The edited leaf.
+     * @param oldKind The kind of the leaf's value before the change.
+     */
+    void valueChanged(TreeNodeArena &arena, TreeNode *node, TreeNode::ValueKind oldKind);
+
+    /**
+     * @brief Updates an object or array without built children whose unbuilt ones
+     * were replaced, and the aggregates of its ancestors.
+     *
+     * @param arena The arena of the tree.
+     * @param node The node, which has no built children.
+     * @param pending The JSON value backing its new children, undefined if it has none.
+     */
+    void pendingChanged(TreeNodeArena &arena, TreeNode *node, const QJsonValue &pending);
+}
+
+#endif // __TREE_AGGREGATES_H__
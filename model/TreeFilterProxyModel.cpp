@@ -0,0 +1,139 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeFilterProxyModel.cpp                                          *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeFilterProxyModel class, a proxy model that        *
+ * filters the tree by a search text.                                          *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include "TreeFilterProxyModel.h"
+
+TreeFilterProxyModel::TreeFilterProxyModel(TreeModel *treeModel, QObject *parent)
+    : QSortFilterProxyModel(parent),
+      _treeModel(treeModel) {
+
+    setSourceModel(treeModel);
+
+    // a reload diff, a batch or the aggregate updates of one edit emit many
+    // signals in a row, they are answered with a single refilter
+    _refilterTimer.setSingleShot(true);
+    _refilterTimer.setInterval(0);
+    connect(&_refilterTimer, &QTimer::timeout, this, &TreeFilterProxyModel::refilter);
+
+    // edited, fetched and reloaded nodes may match now, removed ones must not
+    // be looked up any more
+    auto sourceChanged = [this]() {
+        if (!_filterText.isEmpty()) {
+            _refilterTimer.start();
+        }
+    };
+    // the refilter comes later, by then the slots of removed nodes may hold new ones
+    connect(treeModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TreeFilterProxyModel::forgetRows);
+    connect(treeModel, &QAbstractItemModel::dataChanged, this, sourceChanged);
+    connect(treeModel, &QAbstractItemModel::rowsInserted, this, sourceChanged);
+    connect(treeModel, &QAbstractItemModel::rowsRemoved, this, sourceChanged);
+    connect(treeModel, &QAbstractItemModel::rowsMoved, this, sourceChanged);
+    connect(treeModel, &QAbstractItemModel::modelReset, this, sourceChanged);
+}
+
+void TreeFilterProxyModel::setFilterText(const QString &text) {
+    if (_filterText == text) {
+        return;
+    }
+    _filterText = text;
+    _refilterTimer.stop();
+    refilter();
+    emit filterTextChanged();
+}
+
+void TreeFilterProxyModel::refilter() {
+    _refilterTimer.stop();
+    const int previousCount = _matches.count();
+    _matches.clear();
+    _visible.clear();
+
+    if (!_filterText.isEmpty() && _treeModel) {
+        const QVector<const TreeNode *> matches = _treeModel->findNodes(_filterText);
+        _matches.reserve(matches.count());
+
+        for (const TreeNode *match : matches) {
+            _matches.insert(match);
+
+            // stops at the first ancestor some other match already added
+            for (const TreeNode *node = match; node && !_visible.contains(node); node = node->parentNode()) {
+                _visible.insert(node);
+            }
+        }
+    }
+
+    invalidateFilter();
+
+    if (_matches.count() != previousCount) {
+        emit matchCountChanged();
+    }
+}
+
+void TreeFilterProxyModel::forgetRows(const QModelIndex &sourceParent, int first, int last) {
+    if (_matches.isEmpty()) {
+        return;
+    }
+
+    const int previousCount = _matches.count();
+    QVector<const TreeNode *> stack;
+    for (int row = first; row <= last; ++row) {
+        stack.append(_treeModel->nodeAt(_treeModel->index(row, 0, sourceParent)));
+    }
+    while (!stack.isEmpty()) {
+        const TreeNode *node = stack.takeLast();
+        _matches.remove(node);
+        _visible.remove(node);
+        for (const TreeNode *child : node->children()) {
+            stack.append(child);
+        }
+    }
+
+    if (_matches.count() != previousCount) {
+        emit matchCountChanged();
+    }
+}
+
+bool TreeFilterProxyModel::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const {
+    if (_filterText.isEmpty()) {
+        return true;
+    }
+
+    const TreeNode *node = _treeModel->nodeAt(_treeModel->index(sourceRow, 0, sourceParent));
+    if (_visible.contains(node)) {
+        return true;
+    }
+
+    // the contents of a matching node stay browsable
+    for (const TreeNode *ancestor = node->parentNode(); ancestor; ancestor = ancestor->parentNode()) {
+        if (_matches.contains(ancestor)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,136 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeFilterProxyModel.h                                            *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeFilterProxyModel class, a proxy model that filters  *
+ * the tree down to the nodes matching a search text and their ancestors.      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_FILTER_PROXY_MODEL_H__
+#define __TREE_FILTER_PROXY_MODEL_H__
+
+#include <QSet>
+#include <QTimer>
+#include <QPointer>
+#include <QSortFilterProxyModel>
+
+#include "TreeModel.h"
+
+
+class TreeFilterProxyModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+    /**
+     * @brief The text to filter by; an empty text shows the whole tree.
+     */
+    Q_PROPERTY(QString filterText READ filterText WRITE setFilterText NOTIFY filterTextChanged)
+
+    /**
+     * @brief The number of nodes matching `filterText`.
+     */
+    Q_PROPERTY(int matchCount READ matchCount NOTIFY matchCountChanged)
+
+public:
+    /**
+     * @brief Constructs the proxy for the given tree model.
+     *
+     * @param treeModel The source model.
+     * @param parent The parent object.
+     */
+    explicit TreeFilterProxyModel(TreeModel *treeModel, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the text the tree is filtered by.
+     */
+    inline QString filterText() const { return _filterText; }
+
+    /**
+     * @brief Filters the tree by the given text.
+     *
+     * The matches come from the model's search index, then their ancestors are
+     * collected, so accepting a row is a hash lookup and only rows of expanded
+     * nodes are ever checked.
+     *
+     * @param text The text to search for.
+     */
+    void setFilterText(const QString &text);
+
+    /**
+     * @brief Returns the number of nodes matching the filter text.
+     */
+    inline int matchCount() const { return _matches.count(); }
+
+signals:
+    /**
+     * @brief Emitted when the `filterText` property changes.
+     */
+    void filterTextChanged();
+
+    /**
+     * @brief Emitted when the `matchCount` property changes.
+     */
+    void matchCountChanged();
+
+protected:
+    /**
+     * @brief Accepts matching nodes, their ancestors and their descendants.
+     *
+     * @param sourceRow The row in the source model.
+     * @param sourceParent The parent index in the source model.
+     * @return True if the row is shown.
+     */
+    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+
+private:
+    /**
+     * @brief Looks the filter text up again and re-applies the filter.
+     *
+     * Called when the text changes, and once control returns to the event loop
+     * after the source model changed while a filter is set, however many
+     * signals the change emitted.
+     */
+    void refilter();
+
+    /**
+     * @brief Drops nodes about to be removed from the source model from the matches.
+     *
+     * Their arena slots may be reused before the next refilter, a new node there
+     * must not be taken for a match.
+     *
+     * @param sourceParent The parent of the rows in the source model.
+     * @param first The first row to be removed.
+     * @param last The last row to be removed.
+     */
+    void forgetRows(const QModelIndex &sourceParent, int first, int last);
+
+    QPointer<TreeModel> _treeModel;
+    QString _filterText;
+    QSet<const TreeNode *> _matches;
+    QSet<const TreeNode *> _visible;   // the matches and all their ancestors
+    QTimer _refilterTimer;             // coalesces the source model's signals
+};
+
+#endif // __TREE_FILTER_PROXY_MODEL_H__
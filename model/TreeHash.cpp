@@ -0,0 +1,117 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeHash.cpp                                                      *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeHash helpers.                                     *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QVector>
+#include "TreeHash.h"
+
+static size_t leafHash(const TreeNode *node)
+{
+    switch (node->valueKind()) {
+    case TreeNode::BoolValue:
+        return qHashMulti(0, node->name(), int(node->valueKind()), node->boolValue());
+    case TreeNode::IntegerValue:
+        return qHashMulti(0, node->name(), int(node->valueKind()), node->integerValue());
+    case TreeNode::DoubleValue:
+        return qHashMulti(0, node->name(), int(node->valueKind()), node->doubleValue());
+    case TreeNode::StringValue:
+        return qHashMulti(0, node->name(), int(node->valueKind()), node->stringValue());
+    case TreeNode::NullValue:
+        break;
+    }
+    return qHashMulti(0, node->name(), int(node->valueKind()));
+}
+
+bool TreeHash::sameValue(const TreeNode *a, const TreeNode *b)
+{
+    if (a->valueKind() != b->valueKind()) {
+        return false;
+    }
+
+    switch (a->valueKind()) {
+    case TreeNode::BoolValue:
+        return a->boolValue() == b->boolValue();
+    case TreeNode::IntegerValue:
+        return a->integerValue() == b->integerValue();
+    case TreeNode::DoubleValue:
+        return a->doubleValue() == b->doubleValue();
+    case TreeNode::StringValue:
+        return a->stringValue() == b->stringValue();
+    case TreeNode::NullValue:
+        break;
+    }
+    return true;
+}
+
+void TreeHash::hashTree(const TreeNode *root, const PendingFunction &isPending, Table &table)
+{
+    struct Frame {
+        const TreeNode *node;
+        int next;
+        size_t hash;
+        bool complete;
+    };
+
+    auto frameFor = [&isPending](const TreeNode *node) {
+        return Frame{node, 0, qHashMulti(0, node->name(), int(node->type())), !isPending(node)};
+    };
+
+    // post-order without recursion, deep documents must not overflow the stack
+    QVector<Frame> stack{frameFor(root)};
+    while (!stack.isEmpty()) {
+        Frame &frame = stack.last();
+        const QList<TreeNode *> &children = frame.node->children();
+
+        if (frame.next < children.count()) {
+            const TreeNode *child = children.at(frame.next++);
+            if (child->type() == TreeNode::Value) {
+                frame.hash = qHashMulti(frame.hash, leafHash(child));
+            } else {
+                stack.append(frameFor(child));
+            }
+            continue;
+        }
+
+        const Frame done = stack.takeLast();
+        if (done.complete) {
+            table.insert(done.node, done.hash);
+        }
+        if (!stack.isEmpty()) {
+            Frame &parent = stack.last();
+            parent.hash = qHashMulti(parent.hash, done.hash);
+            parent.complete = parent.complete && done.complete;
+        }
+    }
+}
+
+void TreeHash::invalidate(const TreeNode *node, Table &table)
+{
+    for (const TreeNode *ancestor = node; ancestor; ancestor = ancestor->parentNode()) {
+        table.remove(ancestor);
+    }
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeHash.h                                                        *
+ *                                                                             *
+ * Description:                                                                *
+ * Declaration of the TreeHash helpers, content hashes of subtrees used to     *
+ * find what changed between two versions of a tree.                           *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_HASH_H__
+#define __TREE_HASH_H__
+
+#include <functional>
+
+#include <QHash>
+#include <QVariant>
+
+#include "TreeNode.h"
+
+
+namespace TreeHash
+{
+    /**
+     * @brief Content hashes of containers, keyed by node.
+     */
+    using Table = QHash<const TreeNode *, size_t>;
+
+    /**
+     * @brief Function telling whether a node still has children that are not built.
+     */
+    using PendingFunction = std::function<bool(const TreeNode *)>;
+
+    /**
+     * @brief Returns true if two nodes hold the same JSON value.
+     *
+     * The JSON type is part of the value, so the integer `3` differs from the
+     * double `3.0` and a null differs from an empty string.
+     *
+     * @param a The first node.
+     * @param b The second node.
+     */
+    bool sameValue(const TreeNode *a, const TreeNode *b);
+
+    /**
+     * @brief Hashes the objects and arrays of a tree.
+     *
+     * A container's hash covers its name, its type and, in order, the names,
+     * values and hashes of all its children, so two containers with equal hashes
+     * hold the same content. Containers with pending children anywhere below get
+     * no hash, since their content is not known.
+     *
+     * @param root The root of the tree.
+     * @param isPending Returns true for nodes whose children are not built.
+     * @param table Receives the hashes.
+     */
+    void hashTree(const TreeNode *root, const PendingFunction &isPending, Table &table);
+
+    /**
+     * @brief Removes the hashes of a node and its ancestors after the node was edited.
+     *
+     * @param node The edited node.
+     * @param table The hashes of its tree.
+     */
+    void invalidate(const TreeNode *node, Table &table);
+}
+
+#endif // __TREE_HASH_H__
@@ -0,0 +1,152 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeJournal.cpp                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeJournal class, an append-only sidecar journal of  *
+ * value edits keyed by JSON Pointer paths.                                    *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QDebug>
+#include <QFileInfo>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include "TreeJournal.h"
+
+TreeJournal::TreeJournal(const QString &jsonFile)
+    : _file{jsonFile + QStringLiteral(".journal")},
+      _compactingFilePath{jsonFile + QStringLiteral(".journal.compacting")} {}
+
+bool TreeJournal::append(const QString &path, const QJsonValue &value)
+{
+    return append(QVector<Operation>{{path, value}});
+}
+
+bool TreeJournal::append(const QVector<Operation> &operations)
+{
+    if (!_file.isOpen() && !_file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "[WARNING] :: failed to open journal:" << _file.fileName();
+        return false;
+    }
+
+    // one compact operation per line, so a torn write only loses the last line
+    QByteArray lines;
+    for (const Operation &entry : operations) {
+        QJsonObject operation;
+        operation["op"] = QStringLiteral("replace");
+        operation["path"] = entry.path;
+        operation["value"] = entry.value;
+
+        lines.append(QJsonDocument(operation).toJson(QJsonDocument::Compact));
+        lines.append('\n');
+    }
+
+    if (_file.write(lines) != lines.size()) {
+        return false;
+    }
+    return _file.flush();
+}
+
+qint64 TreeJournal::size() const
+{
+    if (_file.isOpen()) {
+        return _file.size();
+    }
+    return QFileInfo(_file.fileName()).size();
+}
+
+QVector<TreeJournal::Operation> TreeJournal::read() const
+{
+    QVector<Operation> operations;
+    readFile(_compactingFilePath, operations);
+    readFile(_file.fileName(), operations);
+    return operations;
+}
+
+void TreeJournal::readFile(const QString &filePath, QVector<Operation> &operations)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+
+    while (!file.atEnd()) {
+        const QByteArray line = file.readLine().trimmed();
+        if (line.isEmpty()) {
+            continue;
+        }
+
+        const QJsonObject operation = QJsonDocument::fromJson(line).object();
+        if (operation.value("op").toString() != QLatin1String("replace") || !operation.contains("path")) {
+            qWarning() << "[WARNING] :: skipping malformed journal entry in" << filePath;
+            continue;
+        }
+
+        operations.append({operation.value("path").toString(), operation.value("value")});
+    }
+}
+
+bool TreeJournal::rotate()
+{
+    _file.close();
+
+    if (!QFile::exists(_file.fileName())) {
+        return true;
+    }
+
+    if (!QFile::exists(_compactingFilePath)) {
+        return QFile::rename(_file.fileName(), _compactingFilePath);
+    }
+
+    // an earlier compaction did not finish, its edits are still needed
+    QFile source(_file.fileName());
+    QFile target(_compactingFilePath);
+    if (!source.open(QIODevice::ReadOnly) || !target.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    const QByteArray data = source.readAll();
+    if (target.write(data) != data.size() || !target.flush()) {
+        return false;
+    }
+    source.close();
+    return QFile::remove(_file.fileName());
+}
+
+void TreeJournal::removeCompacted()
+{
+    QFile::remove(_compactingFilePath);
+}
+
+bool TreeJournal::discard()
+{
+    _file.close();
+
+    bool removed = !QFile::exists(_file.fileName()) || QFile::remove(_file.fileName());
+    removed = (!QFile::exists(_compactingFilePath) || QFile::remove(_compactingFilePath)) && removed;
+    if (!removed) {
+        qWarning() << "[WARNING] :: failed to discard journal:" << _file.fileName();
+    }
+    return removed;
+}
@@ -0,0 +1,145 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeJournal.h                                                     *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeJournal class, an append-only sidecar journal of    *
+ * value edits. Each edit is written as a JSON-Patch style replace operation   *
+ * keyed by its JSON Pointer path, so persisting an edit costs O(change)       *
+ * instead of rewriting the whole document.                                    *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_JOURNAL_H__
+#define __TREE_JOURNAL_H__
+
+#include <QFile>
+#include <QVector>
+#include <QString>
+#include <QJsonValue>
+
+
+class TreeJournal
+{
+public:
+    /**
+     * @brief A single journaled edit.
+     */
+    struct Operation {
+        QString path;       // JSON Pointer of the edited node
+        QJsonValue value;   // the new value
+    };
+
+    /**
+     * @brief Constructs the journal belonging to the given JSON file.
+     *
+     * The journal lives next to the file as `<jsonFile>.journal`. While a
+     * compaction is running, the journaled edits it covers are kept in
+     * `<jsonFile>.journal.compacting`.
+     *
+     * @param jsonFile The path of the JSON file.
+     */
+    explicit TreeJournal(const QString &jsonFile);
+
+    /**
+     * @brief Returns the path of the active journal file.
+     */
+    inline QString filePath() const { return _file.fileName(); }
+
+    /**
+     * @brief Returns the path of the journal file covered by a running compaction.
+     */
+    inline QString compactingFilePath() const { return _compactingFilePath; }
+
+    /**
+     * @brief Appends a replace operation and flushes it to the file.
+     *
+     * @param path The JSON Pointer of the edited node.
+     * @param value The new value.
+     * @return True if the operation was written.
+     */
+    bool append(const QString &path, const QJsonValue &value);
+
+    /**
+     * @brief Appends several replace operations with a single write and flush.
+     *
+     * @param operations The operations, in the order they were made.
+     * @return True if all operations were written.
+     */
+    bool append(const QVector<Operation> &operations);
+
+    /**
+     * @brief Returns the size of the active journal in bytes.
+     */
+    qint64 size() const;
+
+    /**
+     * @brief Returns all journaled operations in the order they were made.
+     *
+     * Operations of an interrupted compaction come first, followed by the active
+     * journal. Malformed lines (e.g. a partially written last line after a crash)
+     * are skipped.
+     */
+    QVector<Operation> read() const;
+
+    /**
+     * @brief Moves the active journal behind the compaction file.
+     *
+     * Called right when the snapshot for a compaction is taken: everything
+     * journaled so far is covered by the snapshot, later edits go to a fresh
+     * active journal. If an earlier compaction failed, its file is kept and the
+     * active journal is appended to it.
+     *
+     * @return True on success.
+     */
+    bool rotate();
+
+    /**
+     * @brief Removes the compaction file once the compacted document is safely written.
+     */
+    void removeCompacted();
+
+    /**
+     * @brief Removes every journaled edit, including those of an unfinished compaction.
+     *
+     * Called when the document on disk has replaced the edited values, so that
+     * they are not replayed over it on the next load.
+     *
+     * @return True if no journal file is left.
+     */
+    bool discard();
+
+private:
+    /**
+     * @brief Reads the operations from one journal file.
+     *
+     * @param filePath The journal file.
+     * @param operations The list to append the operations to.
+     */
+    static void readFile(const QString &filePath, QVector<Operation> &operations);
+
+    QFile _file;
+    QString _compactingFilePath;
+};
+
+#endif // __TREE_JOURNAL_H__
@@ -0,0 +1,656 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeListModel.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeListModel class, a flat list of the visible rows  *
+ * of a TreeModel.                                                             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include "TreeListModel.h"
+
+namespace {
+
+// Fenwick trees over the visible rows of a node's children: `tree[i - 1]`
+// holds the rows of the children in (i - lowbit(i), i], 1-based
+
+/**
+ * @brief Turns the per-child counts into a Fenwick tree in place, in O(n).
+ */
+void buildCounts(QVector<int> &tree)
+{
+    const int size = tree.count();
+    for (int i = 1; i <= size; ++i) {
+        const int parent = i + (i & -i);
+        if (parent <= size) {
+            tree[parent - 1] += tree[i - 1];
+        }
+    }
+}
+
+/**
+ * @brief Adds `delta` to the count of one child.
+ */
+void addCount(QVector<int> &tree, int index, int delta)
+{
+    for (int i = index + 1; i <= tree.count(); i += i & -i) {
+        tree[i - 1] += delta;
+    }
+}
+
+/**
+ * @brief Returns the rows of the children before `index`.
+ */
+int countBefore(const QVector<int> &tree, int index)
+{
+    int rows = 0;
+    for (int i = index; i > 0; i -= i & -i) {
+        rows += tree[i - 1];
+    }
+    return rows;
+}
+
+/**
+ * @brief Returns the child whose rows contain `offset`, and makes `offset`
+ * relative to that child's first row.
+ *
+ * Every child takes up at least one row, so this is the last child with no
+ * more than `offset` rows before it.
+ */
+int findChild(const QVector<int> &tree, int &offset)
+{
+    int step = 1;
+    while (step * 2 <= tree.count()) {
+        step *= 2;
+    }
+
+    int position = 0;
+    for (; step > 0; step /= 2) {
+        if (position + step <= tree.count() && tree[position + step - 1] <= offset) {
+            position += step;
+            offset -= tree[position - 1];
+        }
+    }
+    return position;
+}
+
+} // namespace
+
+TreeListModel::TreeListModel(TreeModel *treeModel, QObject *parent)
+    : QAbstractListModel(parent),
+      _treeModel(treeModel),
+      _root{nullptr},
+      _pending{NoChange},
+      _pendingRow{0},
+      _pendingCount{0},
+      _lastRow{-1},
+      _lastNode{nullptr} {
+
+    resetBranches();
+
+    connect(treeModel, &QAbstractItemModel::dataChanged, this, &TreeListModel::onDataChanged);
+    connect(treeModel, &QAbstractItemModel::rowsInserted, this, &TreeListModel::onRowsInserted);
+    connect(treeModel, &QAbstractItemModel::rowsAboutToBeRemoved, this, &TreeListModel::onRowsAboutToBeRemoved);
+    connect(treeModel, &QAbstractItemModel::rowsRemoved, this, &TreeListModel::onRowsRemoved);
+    connect(treeModel, &QAbstractItemModel::rowsAboutToBeMoved, this, &TreeListModel::onRowsAboutToBeMoved);
+    connect(treeModel, &QAbstractItemModel::rowsMoved, this, &TreeListModel::onRowsMoved);
+    connect(treeModel, &QAbstractItemModel::modelAboutToBeReset, this, [this]() {
+        beginResetModel();
+    });
+    connect(treeModel, &QAbstractItemModel::modelReset, this, [this]() {
+        resetBranches();
+        endResetModel();
+    });
+}
+
+int TreeListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || !_root) {
+        return 0;
+    }
+    return _branches.constFind(_root)->rows;
+}
+
+QVariant TreeListModel::data(const QModelIndex &index, int role) const
+{
+    const TreeNode *node = index.isValid() ? nodeAt(index.row()) : nullptr;
+    if (!node || !_treeModel) {
+        return QVariant();
+    }
+
+    switch (role) {
+    case DepthRole:
+        return depth(node);
+    case ExpandedRole:
+        return nodeExpanded(node);
+    case HasChildrenRole:
+        // also true for containers a lazy tree model has not built yet
+        return _treeModel->hasChildren(_treeModel->indexOf(node));
+    case ChildIndexRole:
+        return node->row();
+    default:
+        return _treeModel->data(_treeModel->indexOf(node), role);
+    }
+}
+
+QHash<int, QByteArray> TreeListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles;
+    roles[NameRole] = "name";
+    roles[ValueRole] = "value";
+    roles[DepthRole] = "depth";
+    roles[ExpandedRole] = "expanded";
+    roles[HasChildrenRole] = "hasChildren";
+    roles[ChildIndexRole] = "childIndex";
+    return roles;
+}
+
+bool TreeListModel::canFetchMore(const QModelIndex &parent) const
+{
+    return !parent.isValid() && _treeModel && _treeModel->canFetchMore(QModelIndex());
+}
+
+void TreeListModel::fetchMore(const QModelIndex &parent)
+{
+    // the new top level nodes come in through onRowsInserted()
+    if (!parent.isValid() && _treeModel) {
+        _treeModel->fetchMore(QModelIndex());
+    }
+}
+
+const TreeNode *TreeListModel::nodeAt(int row) const
+{
+    if (row < 0 || row >= rowCount()) {
+        return nullptr;
+    }
+    if (row == _lastRow && _lastNode) {
+        return _lastNode;
+    }
+
+    const TreeNode *node = _root;
+    int offset = row;
+    for (;;) {
+        const int child = findChild(_branches.constFind(node)->counts, offset);
+        node = node->children().at(child);
+        if (offset == 0) {
+            break;
+        }
+        // the row is below this child, which is expanded then
+        --offset;
+    }
+
+    _lastRow = row;
+    _lastNode = node;
+    return node;
+}
+
+int TreeListModel::rowOf(const TreeNode *node) const
+{
+    if (!node || !_root || !showsChildren(node->parentNode())) {
+        return -1;
+    }
+
+    int row = 0;
+    for (const TreeNode *current = node; current != _root; current = current->parentNode()) {
+        const TreeNode *parent = current->parentNode();
+        row += countBefore(_branches.constFind(parent)->counts, current->row());
+        if (parent != _root) {
+            ++row;
+        }
+    }
+    return row;
+}
+
+bool TreeListModel::isExpanded(int row) const
+{
+    const TreeNode *node = nodeAt(row);
+    return node && nodeExpanded(node);
+}
+
+void TreeListModel::expand(int row)
+{
+    const TreeNode *node = nodeAt(row);
+    if (!node || nodeExpanded(node)) {
+        return;
+    }
+
+    const QModelIndex sourceIndex = _treeModel->indexOf(node);
+    if (_treeModel->canFetchMore(sourceIndex)) {
+        _treeModel->fetchMore(sourceIndex);
+
+        // fetching may unload other JSON Lines records, which moves the row
+        row = rowOf(node);
+        if (row < 0) {
+            return;
+        }
+    }
+    if (node->childCount() == 0) {
+        return;
+    }
+
+    // a node collapsed before kept its counts up to date, including the
+    // expanded nodes below it
+    auto it = _branches.find(node);
+    if (it == _branches.end()) {
+        it = _branches.insert(node, Branch());
+        rebuild(node, *it);
+    }
+
+    const int rows = it->rows;
+    beginInsertRows(QModelIndex(), row + 1, row + rows);
+    it->expanded = true;
+    propagate(node, rows);
+    endInsertRows();
+
+    emit dataChanged(index(row), index(row), {ExpandedRole});
+}
+
+void TreeListModel::collapse(int row)
+{
+    const TreeNode *node = nodeAt(row);
+    if (!node || !nodeExpanded(node)) {
+        return;
+    }
+
+    auto it = _branches.find(node);
+    const int rows = it->rows;
+    if (rows > 0) {
+        beginRemoveRows(QModelIndex(), row + 1, row + rows);
+    }
+    it->expanded = false;
+    propagate(node, -rows);
+    if (rows > 0) {
+        endRemoveRows();
+    }
+
+    emit dataChanged(index(row), index(row), {ExpandedRole});
+}
+
+void TreeListModel::toggleExpanded(int row)
+{
+    if (isExpanded(row)) {
+        collapse(row);
+    } else {
+        expand(row);
+    }
+}
+
+void TreeListModel::expandRecursively(int row, int depth)
+{
+    if (!_treeModel || !_root || row >= rowCount() || depth == 0) {
+        return;
+    }
+    const TreeNode *top = row < 0 ? _root : nodeAt(row);
+
+    // fetches first, while the branches still match what is shown; parents
+    // are collected before their children
+    QVector<const TreeNode *> nodes;
+    QVector<QPair<const TreeNode *, int>> pending{{top, row < 0 ? -1 : 0}};
+    while (!pending.isEmpty()) {
+        const QPair<const TreeNode *, int> next = pending.takeLast();
+        const TreeNode *node = next.first;
+        const int level = next.second;
+        const QModelIndex sourceIndex = _treeModel->indexOf(node);
+        if (_treeModel->canFetchMore(sourceIndex)) {
+            _treeModel->fetchMore(sourceIndex);
+        }
+        if (node->childCount() == 0) {
+            continue;
+        }
+
+        nodes.append(node);
+        if (depth >= 0 && level + 1 >= depth) {
+            continue;
+        }
+        for (const TreeNode *child : node->children()) {
+            pending.append({child, level + 1});
+        }
+    }
+
+    // children before parents, so each rebuild sees the final counts below it
+    auto expandCollected = [this, &nodes, top]() {
+        for (int i = nodes.count() - 1; i >= 0; --i) {
+            const TreeNode *node = nodes.at(i);
+            Branch &branch = _branches[node];
+            branch.expanded = node == _root || node != top;
+            rebuild(node, branch);
+        }
+    };
+
+    if (top == _root) {
+        beginResetModel();
+        expandCollected();
+        endResetModel();
+        return;
+    }
+
+    // the shown rows below the node need not be contiguous with the new ones,
+    // so they go first and the whole subtree comes back in one insertion
+    collapse(rowOf(top));
+    expandCollected();
+    expand(rowOf(top));
+}
+
+void TreeListModel::collapseAll()
+{
+    beginResetModel();
+    resetBranches();
+    endResetModel();
+}
+
+int TreeListModel::visibleRows(const TreeNode *node) const
+{
+    auto it = _branches.constFind(node);
+    return (it != _branches.constEnd() && it->expanded) ? 1 + it->rows : 1;
+}
+
+bool TreeListModel::nodeExpanded(const TreeNode *node) const
+{
+    auto it = _branches.constFind(node);
+    return it != _branches.constEnd() && it->expanded;
+}
+
+bool TreeListModel::showsChildren(const TreeNode *node) const
+{
+    for (const TreeNode *current = node; current != _root; current = current->parentNode()) {
+        if (!current || !nodeExpanded(current)) {
+            return false;
+        }
+    }
+    return node != nullptr;
+}
+
+int TreeListModel::firstChildRow(const TreeNode *node) const
+{
+    return node == _root ? 0 : rowOf(node) + 1;
+}
+
+int TreeListModel::depth(const TreeNode *node) const
+{
+    int levels = 0;
+    for (const TreeNode *parent = node->parentNode(); parent && parent != _root; parent = parent->parentNode()) {
+        ++levels;
+    }
+    return levels;
+}
+
+void TreeListModel::rebuild(const TreeNode *node, Branch &branch)
+{
+    const QList<TreeNode *> &children = node->children();
+    branch.counts.resize(children.count());
+    for (int i = 0; i < children.count(); ++i) {
+        branch.counts[i] = visibleRows(children.at(i));
+    }
+    buildCounts(branch.counts);
+    branch.rows = countBefore(branch.counts, branch.counts.count());
+    _lastNode = nullptr;
+}
+
+void TreeListModel::recount(const TreeNode *node)
+{
+    auto it = _branches.find(node);
+    if (it == _branches.end()) {
+        return;
+    }
+
+    const int before = it->rows;
+    rebuild(node, *it);
+    if (it->expanded && it->rows != before) {
+        propagate(node, it->rows - before);
+    }
+}
+
+void TreeListModel::propagate(const TreeNode *node, int delta)
+{
+    _lastNode = nullptr;
+
+    for (const TreeNode *current = node; current != _root; current = current->parentNode()) {
+        auto parent = _branches.find(current->parentNode());
+        if (parent == _branches.end()) {
+            return;
+        }
+        addCount(parent->counts, current->row(), delta);
+        parent->rows += delta;
+        if (!parent->expanded) {
+            return;
+        }
+    }
+}
+
+void TreeListModel::forget(const TreeNode *node)
+{
+    _lastNode = nullptr;
+
+    // a node only gets a branch once its parent had one, so the walk stops
+    // at the first node that was never expanded
+    QVector<const TreeNode *> pending{node};
+    while (!pending.isEmpty()) {
+        const TreeNode *current = pending.takeLast();
+        if (_branches.remove(current) == 0) {
+            continue;
+        }
+        for (const TreeNode *child : current->children()) {
+            pending.append(child);
+        }
+    }
+}
+
+void TreeListModel::resetBranches()
+{
+    _branches.clear();
+    _lastNode = nullptr;
+    _root = _treeModel ? _treeModel->nodeAt(QModelIndex()) : nullptr;
+    if (!_root) {
+        return;
+    }
+
+    Branch &branch = _branches[_root];
+    branch.expanded = true;
+    rebuild(_root, branch);
+}
+
+void TreeListModel::onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles)
+{
+    const TreeNode *parent = _treeModel->nodeAt(topLeft.parent());
+    if (!showsChildren(parent)) {
+        return;
+    }
+
+    const QVector<int> &counts = _branches.constFind(parent)->counts;
+    const int first = firstChildRow(parent);
+    for (int row = topLeft.row(); row <= bottomRight.row(); ++row) {
+        const QModelIndex changed = index(first + countBefore(counts, row));
+        emit dataChanged(changed, changed, roles);
+    }
+}
+
+void TreeListModel::onRowsInserted(const QModelIndex &parent, int first, int last)
+{
+    const TreeNode *node = _treeModel->nodeAt(parent);
+    auto it = _branches.find(node);
+    if (it == _branches.end()) {
+        // never expanded, the children are counted when it is
+        return;
+    }
+
+    // the new nodes have no branches, so each takes up one row
+    const bool shown = showsChildren(node);
+    if (shown) {
+        const int row = firstChildRow(node) + countBefore(it->counts, first);
+        beginInsertRows(QModelIndex(), row, row + last - first);
+    }
+    recount(node);
+    if (shown) {
+        endInsertRows();
+    }
+}
+
+void TreeListModel::onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last)
+{
+    const TreeNode *node = _treeModel->nodeAt(parent);
+    auto it = _branches.find(node);
+    if (it == _branches.end()) {
+        return;
+    }
+
+    _pending = NoChange;
+    if (showsChildren(node)) {
+        const int row = firstChildRow(node) + countBefore(it->counts, first);
+        const int rows = countBefore(it->counts, last + 1) - countBefore(it->counts, first);
+        beginRemoveRows(QModelIndex(), row, row + rows - 1);
+        _pending = RemovingRows;
+    }
+
+    // the tree model releases the nodes, their addresses may be reused
+    for (int i = first; i <= last; ++i) {
+        forget(node->children().at(i));
+    }
+}
+
+void TreeListModel::onRowsRemoved(const QModelIndex &parent, int first, int last)
+{
+    Q_UNUSED(first)
+    Q_UNUSED(last)
+
+    const TreeNode *node = _treeModel->nodeAt(parent);
+    auto it = _branches.find(node);
+    if (it == _branches.end()) {
+        return;
+    }
+
+    recount(node);
+    if (_pending == RemovingRows) {
+        endRemoveRows();
+        _pending = NoChange;
+    }
+
+    // e.g. an unloaded JSON Lines record, which shows no children until it is fetched again
+    it = _branches.find(node);
+    if (node != _root && node->childCount() == 0 && it->expanded) {
+        it->expanded = false;
+        const int row = rowOf(node);
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row), {ExpandedRole});
+        }
+    }
+}
+
+void TreeListModel::onRowsAboutToBeMoved(const QModelIndex &sourceParent, int sourceStart, int sourceEnd,
+                                         const QModelIndex &destinationParent, int destinationRow)
+{
+    const TreeNode *source = _treeModel->nodeAt(sourceParent);
+    const TreeNode *destination = _treeModel->nodeAt(destinationParent);
+    const bool fromShown = showsChildren(source);
+    const bool toShown = showsChildren(destination);
+
+    int moved = 0;
+    for (int i = sourceStart; i <= sourceEnd; ++i) {
+        moved += visibleRows(source->children().at(i));
+    }
+
+    // positions are taken while the branches still match the tree
+    const int from = fromShown ? firstChildRow(source)
+                                     + countBefore(_branches.constFind(source)->counts, sourceStart)
+                               : -1;
+    const int to = toShown ? firstChildRow(destination)
+                                 + countBefore(_branches.constFind(destination)->counts, destinationRow)
+                           : -1;
+
+    _pending = NoChange;
+    if (fromShown && toShown) {
+        if (beginMoveRows(QModelIndex(), from, from + moved - 1, QModelIndex(), to)) {
+            _pending = MovingRows;
+        } else {
+            beginResetModel();
+            _pending = Resetting;
+        }
+    } else if (fromShown) {
+        beginRemoveRows(QModelIndex(), from, from + moved - 1);
+        _pending = RemovingRows;
+    } else if (toShown) {
+        _pending = InsertingRows;
+        _pendingRow = to;
+    }
+    _pendingCount = moved;
+
+    // takes the rows out of the source's ancestors now, while their Fenwick
+    // trees are laid out as they were; onRowsMoved() adds them back on the
+    // destination side
+    if (source != destination) {
+        auto it = _branches.find(source);
+        if (it != _branches.end()) {
+            for (int i = sourceStart; i <= sourceEnd; ++i) {
+                addCount(it->counts, i, -visibleRows(source->children().at(i)));
+            }
+            it->rows -= moved;
+            if (it->expanded) {
+                propagate(source, -moved);
+            }
+        }
+    }
+}
+
+void TreeListModel::onRowsMoved(const QModelIndex &sourceParent, int sourceStart, int sourceEnd,
+                                const QModelIndex &destinationParent, int destinationRow)
+{
+    Q_UNUSED(sourceStart)
+    Q_UNUSED(sourceEnd)
+
+    const TreeNode *source = _treeModel->nodeAt(sourceParent);
+    const TreeNode *destination = _treeModel->nodeAt(destinationParent);
+
+    if (_pending == InsertingRows) {
+        beginInsertRows(QModelIndex(), _pendingRow, _pendingRow + _pendingCount - 1);
+    }
+    recount(source);
+    if (destination != source) {
+        recount(destination);
+    }
+
+    switch (_pending) {
+    case MovingRows:
+        endMoveRows();
+        break;
+    case RemovingRows:
+        endRemoveRows();
+        break;
+    case InsertingRows:
+        endInsertRows();
+        break;
+    case Resetting:
+        endResetModel();
+        break;
+    case NoChange:
+        break;
+    }
+    _pending = NoChange;
+
+    // rows moved to another level are indented differently
+    const int fromLevel = source == _root ? 0 : depth(source) + 1;
+    const int toLevel = destination == _root ? 0 : depth(destination) + 1;
+    if (fromLevel != toLevel && showsChildren(destination)) {
+        const int row = rowOf(destination->children().at(destinationRow));
+        emit dataChanged(index(row), index(row + _pendingCount - 1), {DepthRole});
+    }
+}
@@ -0,0 +1,277 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeListModel.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeListModel class, a flat list of the visible rows    *
+ * of a TreeModel for a plain ListView. Every expanded node keeps a Fenwick    *
+ * tree over the visible row counts of its children, so mapping a row to a     *
+ * node, expanding and collapsing never walk the rows being shown or hidden.   *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_LIST_MODEL_H__
+#define __TREE_LIST_MODEL_H__
+
+#include <QHash>
+#include <QVector>
+#include <QPointer>
+#include <QAbstractListModel>
+
+#include "TreeModel.h"
+
+
+class TreeListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Roles of the list, on top of the name and value of the tree model.
+     */
+    enum Roles {
+        NameRole = TreeModel::NameRole,     // name of the node
+        ValueRole = TreeModel::ValueRole,   // value of the node
+        DepthRole,                          // number of ancestors below the root, for indenting
+        ExpandedRole,                       // whether the children are shown
+        HasChildrenRole,                    // whether the node can be expanded
+        ChildIndexRole                      // row of the node in its parent, e.g. an array index
+    };
+    Q_ENUM(Roles)
+
+    /**
+     * @brief Constructs the list for the given tree model, with every node collapsed.
+     *
+     * The list follows the edits, fetches and reloads of the tree model.
+     *
+     * @param treeModel The tree to show.
+     * @param parent The parent object.
+     */
+    explicit TreeListModel(TreeModel *treeModel, QObject *parent = nullptr);
+
+    /**
+     * @brief Returns the number of visible rows, the children of the root and
+     * the visible descendants of the expanded ones.
+     *
+     * @param parent Unused, the list has no children.
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Returns the data of a row for the given role.
+     *
+     * The name and value come from the tree model, the other roles are
+     * computed from the node.
+     *
+     * @param index The index of the row.
+     * @param role One of `Roles`.
+     * @return The data, an invalid QVariant for an invalid index or unknown role.
+     */
+    QVariant data(const QModelIndex &index, int role) const override;
+
+    /**
+     * @brief Returns the role names for QML: name, value, depth, expanded,
+     * hasChildren and childIndex.
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+    /**
+     * @brief Returns true if the top level nodes are still to be built by a lazy tree model.
+     */
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    /**
+     * @brief Builds the top level nodes of a lazy tree model.
+     */
+    void fetchMore(const QModelIndex &parent) override;
+
+    /**
+     * @brief Returns the node shown in a row.
+     *
+     * Goes down from the root, finding the child containing the row in each
+     * expanded node's Fenwick tree, so this is O(depth * log(children)).
+     *
+     * @param row The row.
+     * @return The node, or nullptr if the row is out of range.
+     */
+    const TreeNode *nodeAt(int row) const;
+
+    /**
+     * @brief Returns the row a node is shown in.
+     *
+     * Goes up to the root, adding the rows shown before the node in each
+     * ancestor, so this is O(depth * log(children)).
+     *
+     * @param node A node of the tree model.
+     * @return The row, or -1 if the node is the root or inside a collapsed node.
+     */
+    int rowOf(const TreeNode *node) const;
+
+    /**
+     * @brief Returns true if the children of the node in the row are shown.
+     *
+     * @param row The row.
+     */
+    Q_INVOKABLE bool isExpanded(int row) const;
+
+    /**
+     * @brief Shows the children of the node in a row.
+     *
+     * Children a lazy tree model has not built yet are fetched first. Nodes
+     * below that were expanded before are shown expanded again. The rows are
+     * inserted with one signal and the counts are updated along the ancestors
+     * only, so this does not depend on how many rows get shown.
+     *
+     * @param row The row to expand.
+     */
+    Q_INVOKABLE void expand(int row);
+
+    /**
+     * @brief Hides the descendants of the node in a row, with one signal.
+     *
+     * @param row The row to collapse.
+     */
+    Q_INVOKABLE void collapse(int row);
+
+    /**
+     * @brief Expands the row if it is collapsed, collapses it otherwise.
+     *
+     * @param row The row.
+     */
+    Q_INVOKABLE void toggleExpanded(int row);
+
+    /**
+     * @brief Expands a row and its descendants down to the given depth.
+     *
+     * Every node below is visited once, and fetched first for a lazy tree
+     * model, so this is linear in the size of the subtree, but the rows are
+     * still inserted with a single signal (a reset for the whole tree).
+     *
+     * @param row The row to expand, -1 for the whole tree.
+     * @param depth The number of levels to expand, -1 for all of them.
+     */
+    Q_INVOKABLE void expandRecursively(int row = -1, int depth = -1);
+
+    /**
+     * @brief Collapses every node and forgets which ones were expanded.
+     */
+    Q_INVOKABLE void collapseAll();
+
+private:
+    /**
+     * @brief What a node that was expanded once keeps about its children.
+     */
+    struct Branch {
+        QVector<int> counts;    // Fenwick tree over the visible rows of each child
+        int rows = 0;           // rows shown below the node while it is expanded
+        bool expanded = false;
+    };
+
+    /**
+     * @brief What a source change being made has to finish in `onRowsRemoved()` or `onRowsMoved()`.
+     */
+    enum PendingChange {
+        NoChange,
+        RemovingRows,
+        InsertingRows,
+        MovingRows,
+        Resetting
+    };
+
+    /**
+     * @brief Returns the rows the node takes up, itself and its shown descendants.
+     */
+    int visibleRows(const TreeNode *node) const;
+
+    /**
+     * @brief Returns true if the node is expanded.
+     */
+    bool nodeExpanded(const TreeNode *node) const;
+
+    /**
+     * @brief Returns true if the children of the node are rows of the list.
+     */
+    bool showsChildren(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the row of the first child of a node whose children are shown.
+     */
+    int firstChildRow(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the number of ancestors of a node, not counting the root.
+     */
+    int depth(const TreeNode *node) const;
+
+    /**
+     * @brief Rebuilds the Fenwick tree of a node from the current children, in O(children).
+     */
+    void rebuild(const TreeNode *node, Branch &branch);
+
+    /**
+     * @brief Rebuilds the branch of a node, if it has one, and passes a change
+     * of its shown rows up to the ancestors.
+     */
+    void recount(const TreeNode *node);
+
+    /**
+     * @brief Adds a change of the rows an expanded node takes up to its ancestors.
+     *
+     * Each ancestor's Fenwick tree is updated at the child on the path, and the
+     * walk stops at the first collapsed ancestor, above which nothing changes.
+     *
+     * @param node The expanded node whose shown rows changed.
+     * @param delta The number of rows added, negative if rows were removed.
+     */
+    void propagate(const TreeNode *node, int delta);
+
+    /**
+     * @brief Drops the branches of a subtree the tree model is about to release.
+     */
+    void forget(const TreeNode *node);
+
+    /**
+     * @brief Starts over with the root of the tree model, every node collapsed.
+     */
+    void resetBranches();
+
+    void onDataChanged(const QModelIndex &topLeft, const QModelIndex &bottomRight, const QList<int> &roles);
+    void onRowsInserted(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsRemoved(const QModelIndex &parent, int first, int last);
+    void onRowsAboutToBeMoved(const QModelIndex &sourceParent, int sourceStart, int sourceEnd,
+                              const QModelIndex &destinationParent, int destinationRow);
+    void onRowsMoved(const QModelIndex &sourceParent, int sourceStart, int sourceEnd,
+                     const QModelIndex &destinationParent, int destinationRow);
+
+    QPointer<TreeModel> _treeModel;
+    const TreeNode *_root;
+    QHash<const TreeNode *, Branch> _branches;  // nodes expanded at least once; the root always is
+    PendingChange _pending;
+    int _pendingRow;
+    int _pendingCount;
+    mutable int _lastRow;                   // the last row looked up, as delegates ask for several roles
+    mutable const TreeNode *_lastNode;
+};
+
+#endif // __TREE_LIST_MODEL_H__
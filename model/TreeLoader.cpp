@@ -0,0 +1,861 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeLoader.cpp                                                    *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeLoader class, which reads a JSON file and builds  *
+ * the TreeNode hierarchy for the TreeModel, either on the GUI thread or on a  *
+ * worker thread.                                                              *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <QFile>
+#include <QPair>
+#include <QFileInfo>
+#include <QDebug>
+#include <QJsonValue>
+#include <QVector>
+#include <QJsonDocument>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include "TreeLoader.h"
+#include "JsonStreamReader.h"
+#include "CborDocumentReader.h"
+#include "MsgPackReader.h"
+#include "CompressedDevice.h"
+#include "TreeStats.h"
+
+// size of the chunks in which the JSON file is read, progress and cancellation
+// are checked between chunks
+static const qint64 READ_CHUNK_SIZE = 4 * 1024 * 1024;
+
+// progress (in percent) reached once the file is read and parsed, the
+// remaining part is spent on building the tree
+static const int READ_PROGRESS = 50;
+static const int PARSE_PROGRESS = 60;
+
+// fewest entries built by one job of a parallel build, smaller jobs cost more to schedule than they save
+static const int PARALLEL_JOB_ENTRIES = 1024;
+
+// jobs per pool thread in a parallel build, so that uneven subtrees still keep every core busy
+static const int PARALLEL_JOBS_PER_THREAD = 4;
+
+// records of a JSON Lines file kept built before the least recently used ones are unloaded
+static const int DEFAULT_RECORD_CACHE_SIZE = 1000;
+
+namespace {
+
+/**
+ * @brief Builds TreeNodes straight from JsonStreamReader events.
+ *
+ * Produces the same tree as `TreeLoader::traverseJsonObject()` and
+ * `TreeLoader::traverseJsonArray()`: every array element gets its own unnamed
+ * node, a top-level array is skipped, and scalars keep their JSON type
+ * (integers, doubles, strings, bools and null).
+ */
+class TreeNodeStreamBuilder : public JsonStreamHandler
+{
+public:
+    TreeNodeStreamBuilder(TreeNodeArena *arena, TreeNode *rootNode)
+        : _arena{arena},
+          _rootNode{rootNode},
+          _skipDepth{0} {}
+
+    void startObject() override {
+        if (_skipDepth > 0) {
+            ++_skipDepth;
+            return;
+        }
+
+        if (_frames.isEmpty()) {
+            _frames.append({_rootNode, false});
+            return;
+        }
+
+        TreeNode *node = appendNode(containerName(), QVariant());
+        node->setType(TreeNode::Object);
+        _frames.append({node, false});
+    }
+
+    void endObject() override {
+        endContainer();
+    }
+
+    void startArray() override {
+        if (_skipDepth > 0) {
+            ++_skipDepth;
+            return;
+        }
+
+        // the root of the tree is an object, a top-level array is not represented
+        if (_frames.isEmpty()) {
+            _skipDepth = 1;
+            return;
+        }
+
+        TreeNode *node = appendNode(containerName(), QVariant());
+        node->setType(TreeNode::Array);
+        _frames.append({node, true});
+    }
+
+    void endArray() override {
+        endContainer();
+    }
+
+    void key(const QString &name) override {
+        _key = name;
+    }
+
+    void value(const QVariant &value) override {
+        // scalars inside skipped arrays and top-level scalars are dropped
+        if (_skipDepth > 0 || _frames.isEmpty()) {
+            return;
+        }
+
+        if (_frames.last().isArray) {
+            appendNode(QString(), value);
+            return;
+        }
+
+        appendNode(_key, value);
+    }
+
+private:
+    struct Frame {
+        TreeNode *node;
+        bool isArray;
+    };
+
+    QString containerName() const {
+        return _frames.last().isArray ? QString() : _key;
+    }
+
+    TreeNode *appendNode(const QString &name, const QVariant &value) {
+        TreeNode *parentNode = _frames.last().node;
+        TreeNode *node = _arena->create(name, value, parentNode);
+        parentNode->appendChild(node);
+        return node;
+    }
+
+    void endContainer() {
+        if (_skipDepth > 0) {
+            --_skipDepth;
+            return;
+        }
+        _frames.removeLast();
+    }
+
+    TreeNodeArena *_arena;
+    TreeNode *_rootNode;
+    QVector<Frame> _frames;
+    QString _key;
+    int _skipDepth;
+};
+
+/**
+ * @brief What a streaming reader left behind after parsing a document.
+ */
+struct StreamResult {
+    bool ok;
+    bool aborted;
+    QString errorString;
+    qint64 errorOffset;
+};
+
+/**
+ * @brief Parses a document with one of the streaming readers, which share their interface.
+ */
+template <typename Reader>
+StreamResult streamInto(JsonStreamHandler *handler, QIODevice *device, const JsonStreamReader::ChunkCallback &callback)
+{
+    Reader reader(handler);
+    reader.setChunkSize(READ_CHUNK_SIZE);
+    reader.setChunkCallback(callback);
+    const bool ok = reader.parse(device);
+    return {ok, reader.isAborted(), reader.errorString(), reader.errorOffset()};
+}
+
+} // namespace
+
+TreeLoader::TreeLoader(const QString &jsonFile)
+    : _jsonFile{jsonFile},
+      _parser{StreamParser},
+      _format{DocumentFormat::Json},
+      _compression{DocumentFormat::Uncompressed},
+      _lazy{false},
+      _parallel{false},
+      _snapshotCache{false},
+      _jsonLines{false},
+      _linesRoot{nullptr},
+      _recordClock{0},
+      _recordCacheSize{DEFAULT_RECORD_CACHE_SIZE},
+      _canceled{false},
+      _lastProgress{-1} {}
+
+void TreeLoader::setParser(Parser parser)
+{
+    _parser = parser;
+}
+
+void TreeLoader::setParallel(bool parallel)
+{
+    _parallel = parallel;
+}
+
+void TreeLoader::setLazy(bool lazy)
+{
+    _lazy = lazy;
+}
+
+void TreeLoader::setSnapshotCache(bool enabled)
+{
+    _snapshotCache = enabled;
+}
+
+void TreeLoader::setJsonLines(bool jsonLines)
+{
+    _jsonLines = jsonLines;
+}
+
+void TreeLoader::setRecordCacheSize(int size)
+{
+    _recordCacheSize = qMax(1, size);
+}
+
+void TreeLoader::touchRecord(const TreeNode *node) const
+{
+    if (!_linesRoot) {
+        return;
+    }
+    while (node->parentNode() && node->parentNode() != _linesRoot) {
+        node = node->parentNode();
+    }
+    auto record = _builtRecords.find(node);
+    if (record != _builtRecords.end()) {
+        *record = ++_recordClock;
+    }
+}
+
+QList<TreeNode *> TreeLoader::recordsToUnload() const
+{
+    QList<TreeNode *> records;
+    const int excess = int(_builtRecords.count()) - _recordCacheSize;
+    if (excess <= 0) {
+        return records;
+    }
+
+    QVector<QPair<quint64, int>> byAge;
+    byAge.reserve(_builtRecords.count());
+    for (auto it = _builtRecords.constBegin(); it != _builtRecords.constEnd(); ++it) {
+        byAge.append(qMakePair(it.value(), it.key()->row()));
+    }
+    std::partial_sort(byAge.begin(), byAge.begin() + excess, byAge.end());
+
+    for (int i = 0; i < excess; ++i) {
+        records.append(_linesRoot->child(byAge.at(i).second));
+    }
+    return records;
+}
+
+void TreeLoader::unloadRecord(const TreeNode *record)
+{
+    _builtRecords.remove(record);
+}
+
+bool TreeLoader::isPendingRecord(const TreeNode *node) const
+{
+    return _linesRoot && node->parentNode() == _linesRoot && node->type() != TreeNode::Value
+           && !_builtRecords.contains(node);
+}
+
+bool TreeLoader::hasPendingChildren(const TreeNode *node) const
+{
+    return _pendingValues.contains(node) || _pendingRecords.contains(node) || isPendingRecord(node);
+}
+
+int TreeLoader::pendingChildCount(const TreeNode *node) const
+{
+    if (isPendingRecord(node)) {
+        return jsonChildCount(_lines->record(node->row()));
+    }
+
+    auto record = _pendingRecords.constFind(node);
+    if (record != _pendingRecords.constEnd()) {
+        return _snapshot->childCount(*record);
+    }
+    return jsonChildCount(_pendingValues.value(node));
+}
+
+QJsonValue TreeLoader::pendingValue(const TreeNode *node) const
+{
+    if (isPendingRecord(node)) {
+        return _lines->record(node->row());
+    }
+
+    auto record = _pendingRecords.constFind(node);
+    if (record != _pendingRecords.constEnd()) {
+        return _snapshot->toJson(*record);
+    }
+    return _pendingValues.value(node, QJsonValue(QJsonValue::Undefined));
+}
+
+TreeVersion::Node::Pending TreeLoader::frozenPending(const TreeNode *node) const
+{
+    TreeVersion::Node::Pending pending;
+    auto record = _pendingRecords.constFind(node);
+    if (record != _pendingRecords.constEnd()) {
+        pending.snapshot = _snapshot;
+        pending.record = *record;
+    } else {
+        pending.value = pendingValue(node);
+    }
+    return pending;
+}
+
+void TreeLoader::fetchChildren(TreeNode *node)
+{
+    // a cancel request that arrived after load() returned is stale by now and
+    // must not cut the traversal short
+    _canceled.store(false, std::memory_order_relaxed);
+
+    if (isPendingRecord(node)) {
+        _builtRecords.insert(node, ++_recordClock);
+        appendChildren(*_arena, node, _lines->record(node->row()));
+        return;
+    }
+
+    auto record = _pendingRecords.find(node);
+    if (record != _pendingRecords.end()) {
+        const quint32 index = *record;
+        _pendingRecords.erase(record);
+        _snapshot->buildChildren(node, index, *_arena, _pendingRecords);
+        return;
+    }
+
+    const QJsonValue value = _pendingValues.take(node);
+
+    if (value.isObject()) {
+        QJsonObject jsonObj = value.toObject();
+        traverseJsonObject(*_arena, node, jsonObj);
+        return;
+    }
+
+    if (value.isArray()) {
+        QJsonArray jsonArray = value.toArray();
+        traverseJsonArray(*_arena, node, jsonArray);
+    }
+}
+
+void TreeLoader::appendChildren(TreeNodeArena &arena, TreeNode *node, const QJsonValue &value)
+{
+    _canceled.store(false, std::memory_order_relaxed);
+
+    if (value.isObject()) {
+        QJsonObject jsonObj = value.toObject();
+        traverseJsonObject(arena, node, jsonObj);
+        return;
+    }
+
+    if (value.isArray()) {
+        QJsonArray jsonArray = value.toArray();
+        traverseJsonArray(arena, node, jsonArray);
+    }
+}
+
+void TreeLoader::setPendingValue(const TreeNode *node, const QJsonValue &value)
+{
+    _pendingRecords.remove(node);
+    _pendingValues.remove(node);
+    if (jsonChildCount(value) > 0) {
+        _pendingValues.insert(node, value);
+    }
+}
+
+void TreeLoader::forgetPending(const TreeNode *node)
+{
+    _pendingRecords.remove(node);
+    _pendingValues.remove(node);
+}
+
+int TreeLoader::jsonChildCount(const QJsonValue &value)
+{
+    if (value.isObject()) {
+        return value.toObject().size();
+    }
+
+    if (value.isArray()) {
+        return value.toArray().size();
+    }
+
+    return 0;
+}
+
+void TreeLoader::deferChildren(TreeNode *node, const QJsonValue &value)
+{
+    // the value shares the parsed document, so keeping it around costs no copy
+    if (jsonChildCount(value) > 0) {
+        _pendingValues.insert(node, value);
+    }
+}
+
+void TreeLoader::cancel()
+{
+    _canceled.store(true, std::memory_order_relaxed);
+}
+
+bool TreeLoader::isCanceled() const
+{
+    return _canceled.load(std::memory_order_relaxed);
+}
+
+void TreeLoader::setProgressCallback(const ProgressCallback &callback)
+{
+    _progressCallback = callback;
+}
+
+void TreeLoader::reportProgress(int percent)
+{
+    if (percent == _lastProgress || !_progressCallback) {
+        return;
+    }
+    _lastProgress = percent;
+    _progressCallback(percent);
+}
+
+void TreeLoader::appendJsonValue(TreeNodeArena &arena, TreeNode* rootNode, const QString &name, const QJsonValue &value) {
+
+    if (value.isString() || value.isBool() || value.isDouble() || value.isNull()) {
+        TreeNode *obj = arena.create(name, QVariant(), rootNode);
+        arena.setJsonValue(obj, value);
+        rootNode->appendChild(obj);
+        return;
+    }
+
+    if (value.isArray()) {
+        TreeNode *obj = arena.create(name, QVariant(), rootNode);
+        obj->setType(TreeNode::Array);
+        rootNode->appendChild(obj);
+        if (_lazy) {
+            deferChildren(obj, value);
+            return;
+        }
+        QJsonArray jsonArray = value.toArray();
+        traverseJsonArray(arena, obj, jsonArray);
+        return;
+    }
+
+    if (value.isObject()) {
+        TreeNode *obj = arena.create(name, QVariant(), rootNode);
+        obj->setType(TreeNode::Object);
+        rootNode->appendChild(obj);
+        if (_lazy) {
+            deferChildren(obj, value);
+            return;
+        }
+        QJsonObject childObj = value.toObject();
+        traverseJsonObject(arena, obj, childObj);
+        return;
+    }
+
+    if(value.isUndefined()) {
+        qWarning() << "[WARNING] :: undefined type for node: " << name;
+    }
+}
+
+void TreeLoader::traverseJsonObject(TreeNodeArena &arena, TreeNode* rootNode, QJsonObject &jsonObj) {
+
+    for (auto it = jsonObj.begin(); it != jsonObj.end(); ++it)
+    {
+        if (isCanceled()) {
+            return;
+        }
+        appendJsonValue(arena, rootNode, it.key(), it.value());
+    }
+}
+
+void TreeLoader::traverseJsonArray(TreeNodeArena &arena, TreeNode* obj, QJsonArray &jsonArray) {
+    for (int i = 0; i < jsonArray.size(); ++i) {
+        if (isCanceled()) {
+            return;
+        }
+        appendJsonElement(arena, obj, jsonArray.at(i));
+    }
+}
+
+void TreeLoader::appendJsonElement(TreeNodeArena &arena, TreeNode *obj, const QJsonValue &value) {
+    // objects and nested arrays become unnamed child nodes, so every
+    // element keeps its own row and can be addressed by its index
+    if (value.isObject() || value.isArray()) {
+        appendJsonValue(arena, obj, QString(), value);
+        return;
+    }
+
+    TreeNode *element = arena.create(QString(), QVariant(), obj);
+    arena.setJsonValue(element, value);
+    obj->appendChild(element);
+}
+
+TreeNode* TreeLoader::load() {
+
+    // every load builds into a fresh arena, which then owns the whole tree
+    _arena = QSharedPointer<TreeNodeArena>::create();
+    _pendingValues.clear();
+    _pendingRecords.clear();
+    _snapshot.reset();
+    _lines.reset();
+    _linesRoot = nullptr;
+    _builtRecords.clear();
+    _phaseTimings.clear();
+    _errorString.clear();
+    _format = _jsonLines ? DocumentFormat::Json : DocumentFormat::detect(_jsonFile);
+    _compression = _jsonLines ? DocumentFormat::Uncompressed : DocumentFormat::detectCompression(_jsonFile);
+    _phaseTimer.start();
+
+    TreeNode* rootNode = _arena->create("Config", QVariant());
+    rootNode->setType(TreeNode::Object);
+    QFile jsonFile(_jsonFile);
+
+    if (!jsonFile.open(QIODevice::ReadOnly)) {
+        qDebug() << "ERROR - failed to open json file";
+        _errorString = jsonFile.errorString();
+        return rootNode;
+    }
+
+    if (_jsonLines) {
+        return loadLines(rootNode);
+    }
+
+    TreeSnapshot::SourceKey sourceKey{0, 0, 0};
+    if (_snapshotCache) {
+        sourceKey = TreeSnapshot::SourceKey::of(_jsonFile);
+        if (loadSnapshot(rootNode, sourceKey)) {
+            recordPhase(QStringLiteral("snapshotRead"));
+            return rootNode;
+        }
+    }
+
+    // a compressed file is decompressed chunk by chunk on its way into the parser
+    CompressedDevice decompressed(&jsonFile, _compression);
+    QIODevice *device = &jsonFile;
+    if (_compression != DocumentFormat::Uncompressed) {
+        if (!decompressed.open(QIODevice::ReadOnly)) {
+            qWarning() << "[WARNING] :: failed to decompress" << _jsonFile << ":" << decompressed.errorString();
+            _errorString = decompressed.errorString();
+            return rootNode;
+        }
+        device = &decompressed;
+    }
+
+    // lazy loading keeps handles into the parsed document, so it needs the DOM;
+    // binary documents have no DOM path and are always streamed
+    if (_format == DocumentFormat::Json && (_lazy || _parser == DomParser || _parallel)) {
+        rootNode = loadDocument(rootNode, jsonFile, *device);
+    } else {
+        rootNode = streamDocument(rootNode, jsonFile, *device);
+        recordPhase(QStringLiteral("parse"));
+    }
+
+    if (rootNode && _snapshotCache) {
+        const bool written = TreeSnapshot::write(TreeSnapshot::snapshotPath(_jsonFile), sourceKey, rootNode,
+                                                 [this](const TreeNode *node) { return pendingValue(node); });
+        if (!written) {
+            qWarning() << "[WARNING] :: failed to write snapshot for" << _jsonFile;
+        }
+        recordPhase(QStringLiteral("snapshotWrite"));
+    }
+    return rootNode;
+}
+
+void TreeLoader::recordPhase(const QString &phase) {
+    const qint64 msecs = _phaseTimer.restart();
+    _phaseTimings[phase] = msecs;
+    qCDebug(lcTreeLoad) << _jsonFile << phase << "took" << msecs << "ms";
+}
+
+bool TreeLoader::loadSnapshot(TreeNode *rootNode, const TreeSnapshot::SourceKey &sourceKey) {
+    _snapshot = TreeSnapshot::open(TreeSnapshot::snapshotPath(_jsonFile), sourceKey);
+    if (!_snapshot) {
+        return false;
+    }
+
+    // only the top level is built, everything below is served from the
+    // mapped snapshot when it is expanded
+    _snapshot->buildChildren(rootNode, TreeSnapshot::rootRecord(), *_arena, _pendingRecords);
+    reportProgress(100);
+    return true;
+}
+
+TreeNode *TreeLoader::loadLines(TreeNode *rootNode) {
+    rootNode->setType(TreeNode::Array);
+    _lines = QSharedPointer<JsonLinesFile>::create(_jsonFile);
+
+    // scanning is the bulk of the work, building the record nodes the rest
+    const qint64 fileSize = QFileInfo(_jsonFile).size();
+    const bool scanned = _lines->scan([this, fileSize](qint64 bytesRead) {
+        reportProgress(fileSize > 0 ? int(bytesRead * 90 / fileSize) : 90);
+        return !isCanceled();
+    });
+    if (isCanceled()) {
+        _lines.reset();
+        _arena.reset();
+        return nullptr;
+    }
+    if (!scanned) {
+        qWarning() << "[WARNING] :: failed to read json lines file:" << _lines->errorString();
+        _errorString = _lines->errorString();
+        _lines.reset();
+        return rootNode;
+    }
+    recordPhase(QStringLiteral("scan"));
+
+    const int count = _lines->recordCount();
+    for (int i = 0; i < count; ++i) {
+        TreeNode *record = _arena->create(QString(), QVariant(), rootNode);
+        switch (_lines->kind(i)) {
+        case JsonLinesFile::ObjectRecord:
+            record->setType(TreeNode::Object);
+            break;
+        case JsonLinesFile::ArrayRecord:
+            record->setType(TreeNode::Array);
+            break;
+        case JsonLinesFile::ScalarRecord:
+            _arena->setJsonValue(record, _lines->record(i));
+            break;
+        }
+        rootNode->appendChild(record);
+
+        if ((i & 0xffff) == 0xffff) {
+            if (isCanceled()) {
+                _lines.reset();
+                _arena.reset();
+                return nullptr;
+            }
+            reportProgress(90 + int(qint64(i) * 10 / count));
+        }
+    }
+
+    _linesRoot = rootNode;
+    recordPhase(QStringLiteral("build"));
+    reportProgress(100);
+    return rootNode;
+}
+
+TreeNode* TreeLoader::loadDocument(TreeNode *rootNode, QFile &jsonFile, QIODevice &device) {
+
+    // reading in chunks, so that progress can be reported and a cancel
+    // request does not have to wait for the whole file to be read
+    const qint64 fileSize = jsonFile.size();
+    QByteArray jsonData;
+    jsonData.reserve(fileSize);
+    reportProgress(0);
+
+    while (!device.atEnd()) {
+        if (isCanceled()) {
+            _arena.reset();
+            return nullptr;
+        }
+
+        const QByteArray chunk = device.read(READ_CHUNK_SIZE);
+        if (chunk.isEmpty()) {
+            break;
+        }
+        jsonData.append(chunk);
+        // measured on the file, which is what a compressed document is read from
+        reportProgress(fileSize > 0 ? int(jsonFile.pos() * READ_PROGRESS / fileSize) : READ_PROGRESS);
+    }
+
+    recordPhase(QStringLiteral("read"));
+
+    QJsonParseError parseError;
+    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonData, &parseError);
+    jsonData.clear();
+    if (parseError.error != QJsonParseError::NoError) {
+        _errorString = parseError.errorString();
+    }
+    reportProgress(PARSE_PROGRESS);
+    recordPhase(QStringLiteral("parse"));
+
+    QJsonObject jsonObj = jsonDoc.object();
+
+    if (_parallel && !_lazy && QThreadPool::globalInstance()->maxThreadCount() > 1) {
+        if (!buildParallel(rootNode, jsonObj)) {
+            _arena.reset();
+            return nullptr;
+        }
+        reportProgress(100);
+        recordPhase(QStringLiteral("build"));
+        return rootNode;
+    }
+
+    // traversing the top level entries one by one, so that progress advances
+    // as the tree is being built
+    const int count = jsonObj.size();
+    int done = 0;
+    for (auto it = jsonObj.begin(); it != jsonObj.end(); ++it) {
+        appendJsonValue(*_arena, rootNode, it.key(), it.value());
+
+        if (isCanceled()) {
+            _pendingValues.clear();
+            _arena.reset();
+            return nullptr;
+        }
+        reportProgress(PARSE_PROGRESS + (++done) * (100 - PARSE_PROGRESS) / count);
+    }
+
+    reportProgress(100);
+    recordPhase(QStringLiteral("build"));
+    return rootNode;
+}
+
+bool TreeLoader::buildParallel(TreeNode *rootNode, const QJsonObject &jsonObj) {
+
+    // a range of entries of one JSON container, built into its own arena
+    struct Job {
+        TreeNode *parent;       // the node the built entries are grafted under
+        TreeNode *container;    // appended to the root before the entries, for the first job of a split member
+        QJsonValue json;
+        int begin;
+        int end;
+        QSharedPointer<TreeNodeArena> arena;
+        TreeNode *holder;       // collects the built entries until they are grafted
+    };
+
+    const int jobsWanted = QThreadPool::globalInstance()->maxThreadCount() * PARALLEL_JOBS_PER_THREAD;
+    auto jobSize = [jobsWanted](int entries) {
+        return qMax(PARALLEL_JOB_ENTRIES, entries / jobsWanted);
+    };
+
+    QVector<Job> jobs;
+    auto addJobs = [&jobs, &jobSize](TreeNode *parent, TreeNode *container, const QJsonValue &json,
+                                     int begin, int end) {
+        const int size = jobSize(end - begin);
+        for (int first = begin; first < end; first += size) {
+            jobs.append({parent, first == begin ? container : nullptr, json, first, qMin(end, first + size),
+                         QSharedPointer<TreeNodeArena>(), nullptr});
+        }
+    };
+
+    // members of the root are split into ranges; a member that is a large
+    // container itself gets its node right away and its entries are split too
+    const QJsonValue root(jsonObj);
+    const int rootSize = jobSize(jsonObj.size());
+    int rangeBegin = 0;
+    int index = 0;
+    for (auto it = jsonObj.constBegin(); it != jsonObj.constEnd(); ++it, ++index) {
+        const QJsonValue value = it.value();
+        const int entries = jsonChildCount(value);
+
+        if (entries >= rootSize) {
+            addJobs(rootNode, nullptr, root, rangeBegin, index);
+
+            TreeNode *container = _arena->create(it.key(), QVariant(), rootNode);
+            container->setType(value.isArray() ? TreeNode::Array : TreeNode::Object);
+            addJobs(container, container, value, 0, entries);
+            rangeBegin = index + 1;
+        } else if (index + 1 - rangeBegin == rootSize) {
+            addJobs(rootNode, nullptr, root, rangeBegin, index + 1);
+            rangeBegin = index + 1;
+        }
+    }
+    addJobs(rootNode, nullptr, root, rangeBegin, index);
+
+    QtConcurrent::blockingMap(jobs, [this](Job &job) {
+        job.arena = QSharedPointer<TreeNodeArena>::create();
+        job.holder = job.arena->create(QString(), QVariant());
+
+        if (job.json.isArray()) {
+            const QJsonArray jsonArray = job.json.toArray();
+            for (int i = job.begin; i < job.end && !isCanceled(); ++i) {
+                appendJsonElement(*job.arena, job.holder, jsonArray.at(i));
+            }
+            return;
+        }
+
+        const QJsonObject object = job.json.toObject();
+        auto it = object.constBegin() + job.begin;
+        for (int i = job.begin; i < job.end && !isCanceled(); ++i, ++it) {
+            appendJsonValue(*job.arena, job.holder, it.key(), it.value());
+        }
+    });
+
+    if (isCanceled()) {
+        return false;
+    }
+
+    // grafting in job order keeps the document order
+    for (const Job &job : jobs) {
+        if (job.container) {
+            rootNode->appendChild(job.container);
+        }
+        for (TreeNode *node : job.holder->children()) {
+            job.parent->appendChild(node);
+        }
+        _arena->adopt(job.arena);
+    }
+    return true;
+}
+
+TreeNode* TreeLoader::streamDocument(TreeNode *rootNode, QFile &jsonFile, QIODevice &device) {
+
+    const qint64 fileSize = jsonFile.size();
+    reportProgress(0);
+
+    TreeNodeStreamBuilder builder(_arena.data(), rootNode);
+    // the readers count decompressed bytes, progress is measured on the file
+    const auto onChunk = [this, fileSize, &jsonFile](qint64) {
+        reportProgress(fileSize > 0 ? int(jsonFile.pos() * 100 / fileSize) : 0);
+        return !isCanceled();
+    };
+
+    StreamResult result{false, false, QString(), -1};
+    switch (_format) {
+    case DocumentFormat::Cbor:
+        result = streamInto<CborDocumentReader>(&builder, &device, onChunk);
+        break;
+    case DocumentFormat::MessagePack:
+        result = streamInto<MsgPackReader>(&builder, &device, onChunk);
+        break;
+    case DocumentFormat::Json:
+        result = streamInto<JsonStreamReader>(&builder, &device, onChunk);
+        break;
+    }
+
+    if (result.aborted) {
+        _arena.reset();
+        return nullptr;
+    }
+
+    if (!result.ok) {
+        // like QJsonDocument::fromJson(), a malformed file gives an empty tree
+        qWarning() << "[WARNING] :: failed to parse" << DocumentFormat::name(_format) << "file at offset"
+                   << result.errorOffset << ":" << result.errorString;
+        _errorString = result.errorString;
+        _arena = QSharedPointer<TreeNodeArena>::create();
+        rootNode = _arena->create("Config", QVariant());
+        rootNode->setType(TreeNode::Object);
+    }
+
+    reportProgress(100);
+    return rootNode;
+}
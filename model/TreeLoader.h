@@ -0,0 +1,555 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeLoader.h                                                      *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeLoader class, which reads a JSON file and builds    *
+ * the TreeNode hierarchy for the TreeModel. The loader has no model state, so *
+ * it can run on a worker thread and reports progress and honours cancellation *
+ * while it works.                                                             *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_LOADER_H__
+#define __TREE_LOADER_H__
+
+#include <atomic>
+#include <functional>
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+
+#include <QSharedPointer>
+#include <QVariantMap>
+#include <QElapsedTimer>
+
+#include "TreeNode.h"
+#include "TreeNodeArena.h"
+#include "TreeSnapshot.h"
+#include "JsonLinesFile.h"
+#include "DocumentFormat.h"
+#include "TreeVersion.h"
+
+
+class TreeLoader
+{
+public:
+    /**
+     * @brief Callback type used to report loading progress.
+     *
+     * The callback receives the progress in percent (0 - 100). It is invoked on
+     * the thread that runs `load()`, so receivers living on other threads must
+     * marshal the value themselves (e.g. with a queued connection).
+     */
+    using ProgressCallback = std::function<void(int)>;
+
+    /**
+     * @brief Enum for the parsers the loader can use.
+     *
+     * - StreamParser: the file is read in chunks by `JsonStreamReader` and the
+     *   nodes are created while reading, so neither the raw bytes nor a DOM are
+     *   held in memory.
+     * - DomParser: the whole file is read and parsed by `QJsonDocument` first,
+     *   and the nodes are created in a second traversal.
+     */
+    enum Parser {
+        StreamParser,
+        DomParser
+    };
+
+    /**
+     * @brief Constructs a TreeLoader for the given JSON file.
+     *
+     * @param jsonFile The path of the JSON file to be loaded.
+     */
+    explicit TreeLoader(const QString &jsonFile);
+
+    /**
+     * @brief Reads the JSON file and builds the tree of TreeNode objects.
+     *
+     * The root node is named "Config" and carries an empty value. If the JSON
+     * file cannot be opened, an error message is logged and the empty root node
+     * is returned.
+     *
+     * This function does not touch any model state and may be called from a
+     * worker thread.
+     *
+     * @return A pointer to the root `TreeNode`, owned by `arena()`, or nullptr
+     *         if loading was cancelled.
+     */
+    TreeNode *load();
+
+    /**
+     * @brief Returns the arena owning the nodes built by the last `load()`.
+     *
+     * Nodes created later by `fetchChildren()` go into the same arena. Callers
+     * keep the tree alive by holding on to the returned pointer.
+     */
+    inline QSharedPointer<TreeNodeArena> arena() const { return _arena; }
+
+    /**
+     * @brief Requests cancellation of a running `load()`.
+     *
+     * Thread-safe; the loader checks the flag between read chunks and while
+     * traversing the document, discards the partially built tree and returns
+     * nullptr from `load()`.
+     */
+    void cancel();
+
+    /**
+     * @brief Returns true if cancellation has been requested.
+     */
+    bool isCanceled() const;
+
+    /**
+     * @brief Sets the callback used to report loading progress.
+     *
+     * @param callback The callback receiving progress values in percent.
+     */
+    void setProgressCallback(const ProgressCallback &callback);
+
+    /**
+     * @brief Sets the parser used by `load()` (default is `StreamParser`).
+     *
+     * Lazy loading keeps handles into the parsed document and therefore always
+     * uses the `DomParser`. Only applies to JSON; CBOR and MessagePack files
+     * are always streamed, see `format()`.
+     *
+     * @param parser The parser to use.
+     */
+    void setParser(Parser parser);
+
+    /**
+     * @brief Returns the parser used by `load()`.
+     */
+    inline Parser parser() const { return _parser; }
+
+    /**
+     * @brief Enables or disables lazy materialization of child nodes.
+     *
+     * In lazy mode `load()` only creates the top-level nodes. Objects and arrays
+     * keep a handle to their (implicitly shared) QJsonValue instead, and their
+     * children are built one level at a time by `fetchChildren()` when a view
+     * expands them.
+     *
+     * @param lazy True to build children on demand.
+     */
+    void setLazy(bool lazy);
+
+    /**
+     * @brief Returns true if lazy materialization is enabled.
+     */
+    inline bool isLazy() const { return _lazy; }
+
+    /**
+     * @brief Enables or disables building the tree on all cores.
+     *
+     * The file is parsed into a QJsonDocument, then the members of the root
+     * object are split into ranges that are built on the global QThreadPool,
+     * each into its own `TreeNodeArena`. A member that is a large object or
+     * array is split into ranges of its own entries. The built subtrees are
+     * grafted under their parents in the original order and their arenas are
+     * adopted by the loader's arena. Has no effect in lazy mode, which only
+     * builds the top level, or on CBOR and MessagePack files.
+     *
+     * @param parallel True to build in parallel.
+     */
+    void setParallel(bool parallel);
+
+    /**
+     * @brief Returns true if building on all cores is enabled.
+     */
+    inline bool isParallel() const { return _parallel; }
+
+    /**
+     * @brief Returns the format the last `load()` read the file as.
+     *
+     * Detected by `DocumentFormat::detect()` on every load. CBOR and MessagePack
+     * files are always streamed straight into the tree (by `CborDocumentReader`
+     * and `MsgPackReader`) and build the same nodes a JSON file with the same
+     * content would; lazy and parallel loading apply to JSON only. A JSON Lines
+     * file is always `DocumentFormat::Json`.
+     */
+    inline DocumentFormat::Format format() const { return _format; }
+
+    /**
+     * @brief Returns the compression the last `load()` found the file stored with.
+     *
+     * Detected by `DocumentFormat::detectCompression()`. A compressed file is
+     * decompressed by a `CompressedDevice` in chunks as the parser asks for
+     * data, so the streaming parsers never hold more than a chunk of it. The
+     * snapshot cache still applies; JSON Lines files must be uncompressed.
+     */
+    inline DocumentFormat::Compression compression() const { return _compression; }
+
+    /**
+     * @brief Returns why the last `load()` could not read the file.
+     *
+     * @return The error, or an empty string if the file was opened and parsed.
+     */
+    inline QString errorString() const { return _errorString; }
+
+    /**
+     * @brief Returns how long the phases of the last load took, in milliseconds.
+     *
+     * Depending on how the file was loaded, the phases are `snapshotRead`,
+     * `read`, `parse` (including building the tree when streaming), `build`
+     * and `snapshotWrite`. Each is also logged to the `treeview.load` category.
+     */
+    inline QVariantMap phaseTimings() const { return _phaseTimings; }
+
+    /**
+     * @brief Enables or disables the binary snapshot cache.
+     *
+     * With the cache enabled, `load()` first looks for `<jsonFile>.snapshot`
+     * built from the same version of the file (same size, modification time and
+     * sampled hash). If there is one, it is memory-mapped and only the top-level
+     * nodes are built; everything below is built from the mapped records when
+     * `fetchChildren()` is called, without parsing any JSON. Otherwise the file
+     * is parsed as usual and a new snapshot is written.
+     *
+     * @param enabled True to use and maintain the snapshot cache.
+     */
+    void setSnapshotCache(bool enabled);
+
+    /**
+     * @brief Enables or disables reading the file as JSON Lines (NDJSON).
+     *
+     * In this mode the file holds one JSON value per line. `load()` scans it
+     * once for the byte offset of every record (see `JsonLinesFile`) and makes
+     * the root an array with one node per record. Records that are objects or
+     * arrays are parsed and built only when `fetchChildren()` is called, and at
+     * most `recordCacheSize()` records are kept built: `recordsToUnload()` names
+     * the least recently used ones beyond that. The snapshot cache, lazy and
+     * parallel settings do not apply to the records themselves.
+     *
+     * @param jsonLines True to read the file as JSON Lines.
+     */
+    void setJsonLines(bool jsonLines);
+
+    /**
+     * @brief Returns true if the file is read as JSON Lines.
+     */
+    inline bool isJsonLines() const { return _jsonLines; }
+
+    /**
+     * @brief Sets how many records of a JSON Lines file are kept built.
+     *
+     * @param size The number of records (default 1000, at least 1).
+     */
+    void setRecordCacheSize(int size);
+
+    /**
+     * @brief Returns how many records of a JSON Lines file are kept built.
+     */
+    inline int recordCacheSize() const { return _recordCacheSize; }
+
+    /**
+     * @brief Marks the record a node belongs to as used, see `recordsToUnload()`.
+     *
+     * Only the use order changes, which is kept in mutable members, so that the
+     * model can call this from `data()`.
+     *
+     * @param node Any node of the tree; nodes outside built records are ignored.
+     */
+    void touchRecord(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the least recently used built records beyond `recordCacheSize()`.
+     *
+     * The caller removes their children from the tree and then calls
+     * `unloadRecord()` for each, which makes them pending again.
+     *
+     * @return The record nodes, oldest first.
+     */
+    QList<TreeNode *> recordsToUnload() const;
+
+    /**
+     * @brief Marks a record whose children were removed as pending again.
+     *
+     * @param record The record node, a child of the root without children.
+     */
+    void unloadRecord(const TreeNode *record);
+
+    /**
+     * @brief Returns true if the node has children that are not built yet.
+     *
+     * @param node The node to check.
+     */
+    bool hasPendingChildren(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the number of children `fetchChildren()` will append to the node.
+     *
+     * @param node The node to check.
+     * @return The number of pending children, 0 if nothing is pending.
+     */
+    int pendingChildCount(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the unparsed JSON value backing a node's pending children.
+     *
+     * @param node The node to check.
+     * @return The pending value, or an undefined QJsonValue if nothing is pending.
+     */
+    QJsonValue pendingValue(const TreeNode *node) const;
+
+    /**
+     * @brief Returns a node's pending children as a tree version keeps them.
+     *
+     * Children in a memory-mapped snapshot stay a reference to their record, so
+     * freezing a tree loaded from a snapshot does not read the pending subtrees.
+     *
+     * @param node The node to check.
+     * @return The pending children, null if nothing is pending.
+     */
+    TreeVersion::Node::Pending frozenPending(const TreeNode *node) const;
+
+    /**
+     * @brief Builds one level of pending children for the node.
+     *
+     * Containers among the new children stay pending themselves. Must be called
+     * on the thread that owns the tree, once `load()` has returned.
+     *
+     * @param node The node whose children are to be built.
+     */
+    void fetchChildren(TreeNode *node);
+
+    /**
+     * @brief Appends the members or elements of a JSON value as children of a node.
+     *
+     * Used to insert new content into a loaded tree. The nodes are created in
+     * the given arena, the one that owns `node`, and in lazy mode nested
+     * containers stay pending. Must be called on the thread that owns the tree.
+     *
+     * @param arena The arena to create the nodes in.
+     * @param node The node to append to.
+     * @param value An object, whose members become named children, or an array,
+     *              whose elements become unnamed children.
+     */
+    void appendChildren(TreeNodeArena &arena, TreeNode *node, const QJsonValue &value);
+
+    /**
+     * @brief Replaces whatever backs a node's pending children with a JSON value.
+     *
+     * Used to hand over children that were never built, e.g. when the tree is
+     * updated from a newer version of the file. An empty or scalar value leaves
+     * the node without pending children.
+     *
+     * @param node The node, which must not have built children.
+     * @param value The object or array its children are to be built from.
+     */
+    void setPendingValue(const TreeNode *node, const QJsonValue &value);
+
+    /**
+     * @brief Drops the pending children of a node that is removed from the tree.
+     *
+     * @param node The node.
+     */
+    void forgetPending(const TreeNode *node);
+
+private:
+    /**
+     * @brief Stores and logs the time since the previous phase ended.
+     *
+     * @param phase The name of the phase that just ended.
+     */
+    void recordPhase(const QString &phase);
+
+    /**
+     * @brief Builds the top level of the tree from a matching snapshot.
+     *
+     * @param rootNode The root node to populate.
+     * @param sourceKey The key of the JSON file.
+     * @return True if a matching snapshot was found and mapped.
+     */
+    bool loadSnapshot(TreeNode *rootNode, const TreeSnapshot::SourceKey &sourceKey);
+
+    /**
+     * @brief Builds the tree by parsing the whole file into a QJsonDocument first.
+     *
+     * @param rootNode The root node to populate.
+     * @param jsonFile The opened JSON file, used to measure progress.
+     * @param device The device the document is read from, the file itself or a `CompressedDevice` on top of it.
+     * @return The populated root node, or nullptr if loading was cancelled.
+     */
+    TreeNode *loadDocument(TreeNode *rootNode, QFile &jsonFile, QIODevice &device);
+
+    /**
+     * @brief Builds the children of the root on the global QThreadPool, see `setParallel()`.
+     *
+     * @param rootNode The root node to populate.
+     * @param jsonObj The parsed root object.
+     * @return False if loading was cancelled.
+     */
+    bool buildParallel(TreeNode *rootNode, const QJsonObject &jsonObj);
+
+    /**
+     * @brief Builds the tree in a single pass with the streaming reader of `format()`.
+     *
+     * @param rootNode The root node to populate.
+     * @param jsonFile The opened JSON, CBOR or MessagePack file, used to measure progress.
+     * @param device The device the document is read from, the file itself or a `CompressedDevice` on top of it.
+     * @return The populated root node, or nullptr if loading was cancelled.
+     */
+    TreeNode *streamDocument(TreeNode *rootNode, QFile &jsonFile, QIODevice &device);
+
+    /**
+     * @brief Indexes a JSON Lines file and creates one node per record, see `setJsonLines()`.
+     *
+     * @param rootNode The root node to populate.
+     * @return The populated root node, or nullptr if loading was cancelled.
+     */
+    TreeNode *loadLines(TreeNode *rootNode);
+
+    /**
+     * @brief Returns true if the node is a record of a JSON Lines file whose children are not built.
+     */
+    bool isPendingRecord(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the number of TreeNodes the given JSON value expands to.
+     *
+     * Follows the same rules as `traverseJsonObject()` and `traverseJsonArray()`.
+     *
+     * @param value The JSON object or array.
+     * @return The number of direct child nodes.
+     */
+    static int jsonChildCount(const QJsonValue &value);
+
+    /**
+     * @brief Records the value of a container node so its children can be built later.
+     *
+     * @param node The container node.
+     * @param value The JSON object or array backing the node.
+     */
+    void deferChildren(TreeNode *node, const QJsonValue &value);
+
+    /**
+     * @brief Creates the TreeNode for a single named JSON value and appends it to `rootNode`.
+     *
+     * Scalars become leaf nodes carrying the value, while arrays and objects
+     * become parent nodes whose contents are traversed recursively.
+     *
+     * @param arena The arena the nodes are created in.
+     * @param rootNode The node to which the new node will be appended.
+     * @param name The name (key) of the value.
+     * @param value The JSON value to be converted.
+     */
+    void appendJsonValue(TreeNodeArena &arena, TreeNode* rootNode, const QString &name, const QJsonValue &value);
+
+    /**
+     * @brief Creates the unnamed TreeNode for a single JSON array element and appends it to `obj`.
+     *
+     * @param arena The arena the nodes are created in.
+     * @param obj The array node.
+     * @param value The element.
+     */
+    void appendJsonElement(TreeNodeArena &arena, TreeNode *obj, const QJsonValue &value);
+
+    /**
+     * @brief Recursively traverses a JSON object and creates a tree structure of TreeNode objects.
+     *
+     * This function takes a JSON object and recursively traverses its contents to build
+     * a tree of `TreeNode` objects, starting from the given `rootNode`. It handles various
+     * data types in the JSON object, including strings, booleans, doubles, arrays, objects,
+     * and null values. The resulting tree structure is represented by `TreeNode` objects
+     * where each `TreeNode` corresponds to a key-value pair from the JSON object.
+     *
+     * The function processes each JSON element based on its type:
+     * - Strings are stored as values in the tree.
+     * - Booleans are stored as values in the tree.
+     * - Doubles are stored as values in the tree.
+     * - Arrays are represented as parent nodes with their elements recursively added as children.
+     * - Objects are represented as parent nodes with their key-value pairs added recursively as child nodes.
+     * - Null values are represented by a `TreeNode` with an empty string value.
+     *
+     * The function will output a warning if an "undefined" type is encountered in the JSON object.
+     *
+     * @param arena The arena the nodes are created in.
+     * @param rootNode The root node of the tree to which new nodes will be appended.
+     * @param jsonObj The JSON object to be traversed.
+     *
+     * @warning Undefined types in the JSON object are logged as warnings.
+     *
+     * @see TreeNode
+     * */
+    void traverseJsonObject(TreeNodeArena &arena, TreeNode* rootNode, QJsonObject &jsonObj);
+
+    /**
+     * @brief Recursively traverses a JSON array and processes its elements.
+     *
+     * This function iterates over each element in a given `QJsonArray` and appends one unnamed `TreeNode`
+     * per element to the provided `TreeNode` object. Objects and nested arrays become container nodes
+     * whose contents are traversed recursively, other values (such as strings, numbers, booleans, etc.)
+     * become leaf nodes. Every element thus keeps its index as its row.
+     *
+     * @param arena The arena the nodes are created in.
+     * @param obj The parent `TreeNode` to which new nodes will be appended. The new nodes represent the
+     *            elements of the JSON array.
+     * @param jsonArray The `QJsonArray` to be traversed. It contains various elements that can be objects,
+     *                  arrays, or basic types.
+     *
+     * @see TreeNode
+     * @see traverseJsonObject
+     */
+    void traverseJsonArray(TreeNodeArena &arena, TreeNode* rootNode, QJsonArray &jsonArray);
+
+    /**
+     * @brief Reports progress through the callback, skipping unchanged values.
+     *
+     * @param percent The progress in percent.
+     */
+    void reportProgress(int percent);
+
+private:
+    QString _jsonFile;
+    ProgressCallback _progressCallback;
+    QSharedPointer<TreeNodeArena> _arena;
+    Parser _parser;
+    DocumentFormat::Format _format;
+    DocumentFormat::Compression _compression;
+    bool _lazy;
+    bool _parallel;
+    QHash<const TreeNode *, QJsonValue> _pendingValues;
+    bool _snapshotCache;
+    QSharedPointer<TreeSnapshot> _snapshot;
+    QHash<const TreeNode *, quint32> _pendingRecords;
+    bool _jsonLines;
+    QSharedPointer<JsonLinesFile> _lines;
+    TreeNode *_linesRoot;
+    mutable QHash<const TreeNode *, quint64> _builtRecords;   // built records and when they were last used
+    mutable quint64 _recordClock;
+    int _recordCacheSize;
+    QElapsedTimer _phaseTimer;
+    QVariantMap _phaseTimings;
+    QString _errorString;
+    std::atomic<bool> _canceled;
+    int _lastProgress;
+};
+
+#endif // __TREE_LOADER_H__
@@ -30,104 +30,1027 @@
  *                                                                             *
  ******************************************************************************/
 
+#include <algorithm>
+#include <QBuffer>
 #include <QFile>
+#include <QFileInfo>
+#include <QDebug>
 #include <QJsonValue>
 #include <QJsonObject>
 #include <QJsonDocument>
+#include <QSaveFile>
+#include <QPair>
+#include <QSet>
+#include <QtConcurrent>
 #include "TreeModel.h"
+#include "JsonPointer.h"
+#include "JsonStreamWriter.h"
+#include "CborDocumentWriter.h"
+#include "MsgPackWriter.h"
+#include "CompressedDevice.h"
+#include "TreeAggregates.h"
+#include "TreeWriter.h"
 
-TreeModel::TreeModel(const QString jsonFile) : QAbstractItemModel(), _jsonFile(jsonFile){
+// journal size in bytes above which the journal is compacted into the JSON file
+static const qint64 DEFAULT_JOURNAL_THRESHOLD = 4 * 1024 * 1024;
+
+// interval in milliseconds at which instrumented builds publish their stats
+static const int STATS_INTERVAL = 1000;
+
+// name of members inserted by insertRows(), numbered when taken
+static const QString NEW_MEMBER_NAME = QStringLiteral("newMember");
+
+// editors write in several steps, so the file is only parsed again once it
+// has been quiet for this many milliseconds
+static const int WATCH_DELAY = 200;
+
+TreeModel::TreeModel(const QString jsonFile, LoadModes loadMode)
+    : QAbstractItemModel(),
+      _jsonFile(jsonFile),
+      _loading(false),
+      _loadCanceled(false),
+      _progress(0),
+      _saver(jsonFile, [this]() { return saveSnapshot(); }),
+      _journal(jsonFile),
+      _persistenceMode(WriteBehind),
+      _journalThreshold(DEFAULT_JOURNAL_THRESHOLD),
+      _compressionLevel(-1),
+      _watchFile(false),
+      _aggregates(loadMode.testFlag(Aggregates)),
+      _fileKey{0, 0, 0},
+      _reloadKey{0, 0, 0},
+      _reloadPending(false),
+      _batchDepth(0),
+      _batchDirty(false) {
+
+    connect(&_saver, &TreeSaver::dirtyChanged, this, &TreeModel::dirtyChanged);
+    connect(&_saver, &TreeSaver::savingChanged, this, &TreeModel::savingChanged);
+    connect(&_saver, &TreeSaver::saved, this, [this](bool success) {
+        // the written document contains every edit of the rotated journal
+        if (success) {
+            _journal.removeCompacted();
+            // the watcher reports our own write as well, it must not be merged back in
+            _fileKey = TreeSnapshot::SourceKey::of(_jsonFile);
+        }
+        _stats.recordPhase(QStringLiteral("save"), _saveTimer.elapsed());
+    });
+
+    if (TreeStats::isCompiledIn()) {
+        // pushing the stats on every call would cost more than the calls themselves
+        _statsTimer.setInterval(STATS_INTERVAL);
+        connect(&_statsTimer, &QTimer::timeout, this, [this]() {
+            _stats.log();
+            emit statsChanged();
+        });
+        _statsTimer.start();
+    }
+    connect(&_loadWatcher, &QFutureWatcher<TreeNode *>::finished, this, &TreeModel::onLoadFinished);
+    connect(&_reloadWatcher, &QFutureWatcher<TreeNode *>::finished, this, &TreeModel::onReloadFinished);
+
+    _watchTimer.setSingleShot(true);
+    _watchTimer.setInterval(WATCH_DELAY);
+    connect(&_watchTimer, &QTimer::timeout, this, &TreeModel::startReload);
+    connect(&_watcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+        // a file replaced by a rename is no longer watched
+        if (!_watcher.files().contains(_jsonFile) && QFile::exists(_jsonFile)) {
+            _watcher.addPath(_jsonFile);
+        }
+        _watchTimer.start();
+    });
+    connect(&_watcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        // catches a file that was deleted and written again
+        if (!_watcher.files().contains(_jsonFile) && QFile::exists(_jsonFile)) {
+            _watcher.addPath(_jsonFile);
+            _watchTimer.start();
+        }
+    });
+
+    // the loader is kept after loading, in lazy mode it builds the remaining children
+    _loader = QSharedPointer<TreeLoader>::create(_jsonFile);
+    _loader->setLazy(loadMode.testFlag(Lazy));
+    _loader->setSnapshotCache(loadMode.testFlag(Cached));
+    _loader->setParallel(loadMode.testFlag(Parallel));
+    _loader->setJsonLines(loadMode.testFlag(JsonLines) || JsonLinesFile::isJsonLinesFile(_jsonFile));
+    // a JSON Lines file is read-only and too large to compare on every change
+    _watchFile = loadMode.testFlag(Watched) && !_loader->isJsonLines();
+    _fileKey = TreeSnapshot::SourceKey::of(_jsonFile);
+    if (_watchFile) {
+        _watcher.addPath(QFileInfo(_jsonFile).absolutePath());
+        if (QFile::exists(_jsonFile)) {
+            _watcher.addPath(_jsonFile);
+        }
+    }
+
+    if (loadMode.testFlag(Asynchronous)) {
+        // the model stays empty until the worker has built the tree
+        _arena = QSharedPointer<TreeNodeArena>::create();
+        _rootNode = _arena->create("Config", QVariant());
+        _rootNode->setType(TreeNode::Object);
+        startAsyncLoad();
+        return;
+    }
+
+    _loadTimer.start();
     _rootNode = setupJsonModelData();
+    _arena = _loader->arena();
+    if (_aggregates) {
+        TreeAggregates::aggregateTree(*_arena, _rootNode, [this](const TreeNode *node) {
+            return aggregatedPending(*_loader, node);
+        });
+    }
+    if (_watchFile) {
+        TreeHash::hashTree(_rootNode, [this](const TreeNode *node) { return _loader->hasPendingChildren(node); }, _hashes);
+    }
+    replayJournal(_rootNode);
+    recordLoadPhases();
+    _progress = 100;
 }
 
-void TreeModel::traverseJsonObject(TreeNode* rootNode, QJsonObject &jsonObj) {
+TreeModel::~TreeModel() {
+    // the nodes are owned by the arena(s), which free them when released;
+    // a running load has to stop first, as the worker still uses its arena,
+    // and what was shown meanwhile is a placeholder that must not be saved
+    if (_loading) {
+        _loader->cancel();
+        _loadWatcher.waitForFinished();
+        _loadCanceled = true;
+    }
+
+    // a batch that was never committed is persisted all the same
+    if (_batchDepth > 0) {
+        _batchDepth = 1;
+        commitBatch();
+    }
+    _saver.waitForSaved();
 
-    for (auto it = jsonObj.begin(); it != jsonObj.end(); ++it)
-    {
-        QString name = it.key();
+    if (_reloadWatcher.isRunning()) {
+        _reloadLoader->cancel();
+        _reloadWatcher.waitForFinished();
+    }
+}
 
-        if (it.value().isString()) {
-            TreeNode *obj = new TreeNode(name, it.value().toString(), rootNode);
-            rootNode->children().append(obj);
-            continue;
+TreeNode* TreeModel::setupJsonModelData() {
+    return _loader->load();
+}
+
+void TreeModel::startAsyncLoad() {
+    // progress is reported on the worker thread, so it is queued to the GUI thread
+    _loader->setProgressCallback([this](int progress) {
+        QMetaObject::invokeMethod(this, [this, progress]() {
+            setProgress(progress);
+        }, Qt::QueuedConnection);
+    });
+
+    setProgress(0);
+    setLoading(true);
+    _loadTimer.start();
+
+    // the hashes are computed on the worker as well, right after the tree
+    QSharedPointer<TreeLoader> loader = _loader;
+    QSharedPointer<TreeHash::Table> hashes;
+    if (_watchFile) {
+        hashes = QSharedPointer<TreeHash::Table>::create();
+    }
+    _loadingHashes = hashes;
+    const bool aggregates = _aggregates;
+    _loadWatcher.setFuture(QtConcurrent::run([loader, hashes, aggregates]() {
+        TreeNode *rootNode = loader->load();
+        if (rootNode && aggregates) {
+            TreeAggregates::aggregateTree(*loader->arena(), rootNode, [&loader](const TreeNode *node) {
+                return aggregatedPending(*loader, node);
+            });
+        }
+        if (rootNode && !loader->isJsonLines() && hashes) {
+            TreeHash::hashTree(rootNode, [&loader](const TreeNode *node) { return loader->hasPendingChildren(node); }, *hashes);
         }
+        return rootNode;
+    }));
+}
 
-        if (it.value().isBool()) {
-            TreeNode *obj = new TreeNode(name, it.value().toBool(), rootNode);
-            rootNode->children().append(obj);
-            continue;
+void TreeModel::onLoadFinished() {
+    TreeNode *rootNode = _loadWatcher.result();
+
+    if (rootNode) {
+        beginResetModel();
+        // releasing the old arena frees the previous tree in one pass
+        _arena = _loader->arena();
+        _rootNode = rootNode;
+        // the indexes of the old tree are dropped, the next lookups build new ones
+        _searchIndex.reset();
+        _pathIndex.reset();
+        _hashes.clear();
+        _versions.clear();
+        if (_loadingHashes) {
+            _hashes.swap(*_loadingHashes);
         }
+        replayJournal(_rootNode);
+        endResetModel();
+        recordLoadPhases();
+        setProgress(100);
+    } else {
+        // cancelled, what is shown is not the document and must not be edited or saved
+        _loadCanceled = true;
+    }
 
-        if (it.value().isDouble()) {
-            TreeNode *obj = new TreeNode(name, it.value().toDouble(), rootNode);
-            rootNode->children().append(obj);
-            continue;
+    _loadingHashes.reset();
+    setLoading(false);
+
+    if (_reloadPending) {
+        _reloadPending = false;
+        _watchTimer.start();
+    }
+}
+
+void TreeModel::recordLoadPhases() {
+    const QVariantMap phases = _loader->phaseTimings();
+    for (auto it = phases.constBegin(); it != phases.constEnd(); ++it) {
+        _stats.recordPhase(it.key(), it.value().toLongLong());
+    }
+    _stats.recordPhase(QStringLiteral("load"), _loadTimer.elapsed());
+    emit statsChanged();
+}
+
+void TreeModel::resetStats() {
+    _stats.reset();
+    emit statsChanged();
+}
+
+void TreeModel::setWatchFile(bool watch) {
+    if (_watchFile == watch || (watch && _loader->isJsonLines())) {
+        return;
+    }
+    _watchFile = watch;
+
+    if (watch) {
+        _watcher.addPath(QFileInfo(_jsonFile).absolutePath());
+        if (QFile::exists(_jsonFile)) {
+            _watcher.addPath(_jsonFile);
+        }
+        // without hashes every subtree would have to be compared on the next change
+        if (!_loading) {
+            _hashes.clear();
+            TreeHash::hashTree(_rootNode, [this](const TreeNode *node) { return _loader->hasPendingChildren(node); }, _hashes);
+        }
+    } else {
+        if (!_watcher.files().isEmpty()) {
+            _watcher.removePaths(_watcher.files());
         }
+        if (!_watcher.directories().isEmpty()) {
+            _watcher.removePaths(_watcher.directories());
+        }
+        _watchTimer.stop();
+        _hashes.clear();
+    }
+    emit watchFileChanged();
+}
 
-        if (it.value().isArray()) {
-            TreeNode *obj = new TreeNode(name, "", rootNode);
-            rootNode->children().append(obj);
-            QJsonArray jsonArray = it.value().toArray();
-            traverseJsonArray(obj, jsonArray);
-            continue;
+void TreeModel::startReload() {
+    if (!_watchFile || _loadCanceled) {
+        return;
+    }
+    if (_loading || _reloadWatcher.isRunning()) {
+        _reloadPending = true;
+        return;
+    }
+
+    // a file that is gone or being replaced right now is picked up by the next change
+    const TreeSnapshot::SourceKey key = TreeSnapshot::SourceKey::of(_jsonFile);
+    if (!QFile::exists(_jsonFile) || key == _fileKey) {
+        return;
+    }
+
+    // the new tree is built the same way as the current one, so that members
+    // come in the same order and pending children can be handed over
+    QSharedPointer<TreeLoader> loader = QSharedPointer<TreeLoader>::create(_jsonFile);
+    loader->setLazy(_loader->isLazy());
+    loader->setParser(_loader->parser());
+    loader->setParallel(_loader->isParallel());
+    QSharedPointer<TreeHash::Table> hashes = QSharedPointer<TreeHash::Table>::create();
+
+    _reloadLoader = loader;
+    _reloadHashes = hashes;
+    _reloadKey = key;
+    _reloadTimer.start();
+    _reloadWatcher.setFuture(QtConcurrent::run([loader, hashes]() -> TreeNode * {
+        TreeNode *rootNode = loader->load();
+        if (!rootNode || !loader->errorString().isEmpty()) {
+            return nullptr;
         }
+        TreeHash::hashTree(rootNode, [&loader](const TreeNode *node) { return loader->hasPendingChildren(node); }, *hashes);
+        return rootNode;
+    }));
+}
 
-        if (it.value().isObject()) {
-            TreeNode *obj = new TreeNode(name, "", rootNode);
-            rootNode->children().append(obj);
-            QJsonObject childObj = it.value().toObject();
-            traverseJsonObject(obj, childObj);
-            continue;
+void TreeModel::onReloadFinished() {
+    TreeNode *rootNode = _reloadWatcher.result();
+
+    // a full load that started in the meantime replaces the tree anyway
+    if (rootNode && !_loading) {
+        const qint64 parsed = _reloadTimer.restart();
+        diffNode(_rootNode, rootNode);
+        _fileKey = _reloadKey;
+        // the tree took the values of the file, the edits made before must not be
+        // replayed over them, and a save that is running writes them all the same,
+        // so the tree is written again once it is done
+        _journal.discard();
+        _batchOperations.clear();
+        if (_saver.isSaving()) {
+            markDirty();
         }
+        _stats.recordPhase(QStringLiteral("reloadParse"), parsed);
+        _stats.recordPhase(QStringLiteral("reloadDiff"), _reloadTimer.elapsed());
+        emit statsChanged();
+    }
+
+    // everything that was kept has been copied, the reloaded tree goes with its arena
+    _reloadLoader.reset();
+    _reloadHashes.reset();
+
+    if (_reloadPending) {
+        _reloadPending = false;
+        _watchTimer.start();
+    }
+}
+
+void TreeModel::diffNode(TreeNode *oldNode, TreeNode *newNode) {
+    auto oldHash = _hashes.constFind(oldNode);
+    auto newHash = _reloadHashes->constFind(newNode);
+    if (oldHash != _hashes.constEnd() && newHash != _reloadHashes->constEnd() && *oldHash == *newHash) {
+        return;
+    }
 
-        if (it.value().isNull()) {
-            TreeNode *obj = new TreeNode(name, "", rootNode);
-            rootNode->children().append(obj);
+    const bool oldPending = _loader->hasPendingChildren(oldNode);
+    const bool newPending = _reloadLoader->hasPendingChildren(newNode);
+
+    if (oldNode->childCount() == 0 && (oldPending || newPending)) {
+        // the view has not seen any children here, so they are just handed over
+        QJsonValue pending;
+        if (newPending) {
+            pending = _reloadLoader->pendingValue(newNode);
+        } else if (newNode->childCount() > 0) {
+            // the new node belongs to the reloaded tree, and so do the pending values below it
+            pending = serializeTree(newNode, [this](const TreeNode *node) {
+                if (!_reloadLoader->hasPendingChildren(node)) {
+                    return QJsonValue(QJsonValue::Undefined);
+                }
+                return _reloadLoader->pendingValue(node);
+            });
+        }
+        _loader->setPendingValue(oldNode, pending);
+        _hashes.remove(oldNode);
+        TreeVersion::invalidate(oldNode, _versions);
+        if (_aggregates) {
+            TreeAggregates::pendingChanged(*_arena, oldNode, aggregatedPending(*_loader, oldNode));
+            emitAggregatesChanged(oldNode);
         }
 
-        if(it.value().isUndefined()) {
-            qWarning() << "[WARNING] :: undefined type for node: " << name;
+        // only the expand indicator may have changed
+        if (oldPending != _loader->hasPendingChildren(oldNode) && oldNode != _rootNode) {
+            const QModelIndex index = indexForNode(oldNode);
+            emit dataChanged(index, index);
         }
+        return;
+    }
+
+    // the children are shown, so they are compared against built ones
+    if (newPending) {
+        _reloadLoader->fetchChildren(newNode);
+    }
+
+    const QList<TreeNode *> &oldChildren = oldNode->children();
+    const QList<TreeNode *> &newChildren = newNode->children();
+
+    if (oldNode->type() == TreeNode::Array) {
+        // equal elements are skipped at both ends, containers by their content hashes,
+        // so that an insertion or removal in one place is a single rowsInserted or rowsRemoved
+        const auto sameElement = [this](const TreeNode *oldChild, const TreeNode *newChild) {
+            if (oldChild->type() != newChild->type()) {
+                return false;
+            }
+            if (oldChild->type() == TreeNode::Value) {
+                return TreeHash::sameValue(oldChild, newChild);
+            }
+            auto oldChildHash = _hashes.constFind(oldChild);
+            auto newChildHash = _reloadHashes->constFind(newChild);
+            return oldChildHash != _hashes.constEnd() && newChildHash != _reloadHashes->constEnd()
+                   && *oldChildHash == *newChildHash;
+        };
+
+        int first = 0;
+        while (first < oldChildren.count() && first < newChildren.count()
+               && sameElement(oldChildren.at(first), newChildren.at(first))) {
+            ++first;
+        }
+        int oldLast = oldChildren.count() - 1;
+        int newLast = newChildren.count() - 1;
+        while (oldLast >= first && newLast >= first && sameElement(oldChildren.at(oldLast), newChildren.at(newLast))) {
+            --oldLast;
+            --newLast;
+        }
+
+        // the elements in between are matched by index, only their tail grows or shrinks
+        const int common = qMin(oldLast, newLast) - first + 1;
+        for (int row = first; row < first + common; ++row) {
+            diffChild(oldNode, row, newChildren.at(row));
+        }
+        if (oldLast >= first + common) {
+            removeChildRows(oldNode, first + common, oldLast);
+        } else if (newLast >= first + common) {
+            insertChildRows(oldNode, first + common, newNode, first + common, newLast);
+        }
+    } else {
+        bool sameMembers = oldChildren.count() == newChildren.count();
+        for (int row = 0; sameMembers && row < oldChildren.count(); ++row) {
+            sameMembers = oldChildren.at(row)->name() == newChildren.at(row)->name();
+        }
+
+        if (sameMembers) {
+            for (int row = 0; row < newChildren.count(); ++row) {
+                diffChild(oldNode, row, newChildren.at(row));
+            }
+        } else {
+            // members are matched by name: removed ones go first, back to front
+            // in runs, then the rest is aligned with the new order
+            QSet<QString> newNames;
+            newNames.reserve(newChildren.count());
+            for (const TreeNode *child : newChildren) {
+                newNames.insert(child->name());
+            }
+
+            int runEnd = -1;
+            for (int row = oldChildren.count() - 1; row >= 0; --row) {
+                if (!newNames.contains(oldChildren.at(row)->name())) {
+                    if (runEnd < 0) {
+                        runEnd = row;
+                    }
+                } else if (runEnd >= 0) {
+                    removeChildRows(oldNode, row + 1, runEnd);
+                    runEnd = -1;
+                }
+            }
+            if (runEnd >= 0) {
+                removeChildRows(oldNode, 0, runEnd);
+            }
+
+            QSet<QString> oldNames;
+            oldNames.reserve(oldChildren.count());
+            for (const TreeNode *child : oldChildren) {
+                oldNames.insert(child->name());
+            }
+
+            for (int row = 0; row < newChildren.count(); ++row) {
+                const QString &name = newChildren.at(row)->name();
+                if (row < oldChildren.count() && oldChildren.at(row)->name() == name) {
+                    diffChild(oldNode, row, newChildren.at(row));
+                    continue;
+                }
+
+                if (!oldNames.contains(name)) {
+                    int last = row;
+                    while (last + 1 < newChildren.count() && !oldNames.contains(newChildren.at(last + 1)->name())) {
+                        ++last;
+                    }
+                    insertChildRows(oldNode, row, newNode, row, last);
+                    row = last;
+                    continue;
+                }
+
+                int from = row + 1;
+                while (from < oldChildren.count() && oldChildren.at(from)->name() != name) {
+                    ++from;
+                }
+                if (from < oldChildren.count()) {
+                    moveChildRow(oldNode, from, row);
+                    diffChild(oldNode, row, newChildren.at(row));
+                } else {
+                    // a repeated name that has no counterpart left
+                    insertChildRows(oldNode, row, newNode, row, row);
+                }
+            }
+
+            if (oldChildren.count() > newChildren.count()) {
+                removeChildRows(oldNode, newChildren.count(), oldChildren.count() - 1);
+            }
+        }
+    }
+
+    if (newHash != _reloadHashes->constEnd()) {
+        _hashes.insert(oldNode, *newHash);
+    } else {
+        _hashes.remove(oldNode);
     }
 }
 
-void TreeModel::traverseJsonArray(TreeNode* obj, QJsonArray &jsonArray) {
-    for (int i = 0; i < jsonArray.size(); ++i) {
-        QJsonValue value = jsonArray.at(i);
-        if (value.isObject()) {
-            QJsonObject childObj = value.toObject();
-            traverseJsonObject(obj, childObj);
-            continue;
+void TreeModel::diffChild(TreeNode *parentNode, int row, TreeNode *newNode) {
+    TreeNode *oldNode = parentNode->child(row);
+
+    if (oldNode->type() != newNode->type()) {
+        removeChildRows(parentNode, row, row);
+        insertChildRows(parentNode, row, newNode->parentNode(), newNode->row(), newNode->row());
+        return;
+    }
+
+    if (oldNode->type() != TreeNode::Value) {
+        diffNode(oldNode, newNode);
+        return;
+    }
+
+    if (!TreeHash::sameValue(oldNode, newNode)) {
+        const TreeNode::ValueKind oldKind = oldNode->valueKind();
+        _arena->copyValue(oldNode, newNode);
+        if (_searchIndex) {
+            _searchIndex->update(oldNode);
+        }
+        TreeVersion::invalidate(oldNode, _versions);
+        const QModelIndex index = indexForNode(oldNode);
+        emit dataChanged(index, index, {ValueRole});
+        if (_aggregates) {
+            TreeAggregates::valueChanged(*_arena, oldNode, oldKind);
+            emitAggregatesChanged(oldNode);
         }
+    }
+}
+
+void TreeModel::removeChildRows(TreeNode *parentNode, int first, int last) {
+    beginRemoveRows(indexForNode(parentNode), first, last);
+    // out of the indexes before rowsRemoved, whose receivers may search them
+    for (int row = first; row <= last; ++row) {
+        forgetSubtree(parentNode->child(row));
+    }
+    const QList<TreeNode *> removed = parentNode->takeChildren(first, last - first + 1);
+    endRemoveRows();
 
-        if (value.isArray()) {
-            // ToDo
+    if (_aggregates) {
+        TreeAggregates::childrenRemoved(*_arena, parentNode, removed);
+        emitAggregatesChanged(parentNode);
+    }
+
+    for (TreeNode *node : removed) {
+        _arena->release(node);
+    }
+
+    TreeHash::invalidate(parentNode, _hashes);
+    TreeVersion::invalidate(parentNode, _versions);
+}
+
+void TreeModel::insertChildRows(TreeNode *parentNode, int row, const TreeNode *sourceNode, int first, int last) {
+    QList<TreeNode *> nodes;
+    nodes.reserve(last - first + 1);
+    for (int i = first; i <= last; ++i) {
+        nodes.append(cloneSubtree(sourceNode->children().at(i), parentNode));
+    }
+    insertNodes(parentNode, row, nodes);
+}
+
+bool TreeModel::insertNodes(TreeNode *parentNode, int row, const QList<TreeNode *> &nodes) {
+    if (_loading || _loadCanceled) {
+        for (TreeNode *node : nodes) {
+            _arena->release(node);
+        }
+        return false;
+    }
+
+    if (_aggregates) {
+        for (TreeNode *node : nodes) {
+            TreeAggregates::aggregateTree(*_arena, node, [this](const TreeNode *pending) {
+                return aggregatedPending(*_loader, pending);
+            });
+        }
+    }
+
+    beginInsertRows(indexForNode(parentNode), row, row + nodes.count() - 1);
+    parentNode->insertChildren(row, nodes);
+    endInsertRows();
+
+    if (_aggregates) {
+        TreeAggregates::childrenAdded(*_arena, parentNode, nodes);
+        emitAggregatesChanged(parentNode);
+    }
+
+    if (_searchIndex) {
+        for (const TreeNode *node : nodes) {
+            _searchIndex->addSubtree(node);
+        }
+    }
+
+    if (_pathIndex && parentNode->type() == TreeNode::Array) {
+        // the elements after the new ones moved to higher indexes
+        _pathIndex->reindexChildren(parentNode, row);
+    } else if (_pathIndex) {
+        for (const TreeNode *node : nodes) {
+            _pathIndex->addSubtree(node);
+        }
+    }
+    TreeHash::invalidate(parentNode, _hashes);
+    TreeVersion::invalidate(parentNode, _versions);
+    return true;
+}
+
+void TreeModel::moveChildRow(TreeNode *parentNode, int from, int to) {
+    const QModelIndex parent = indexForNode(parentNode);
+
+    // the path of a member is its name, so the path index stays valid
+    beginMoveRows(parent, from, from, parent, to);
+    parentNode->insertChild(to, parentNode->takeChild(from));
+    endMoveRows();
+    TreeVersion::invalidate(parentNode, _versions);
+}
+
+TreeNode *TreeModel::cloneSubtree(const TreeNode *sourceNode, TreeNode *parentNode) {
+    TreeNode *clone = _arena->create(sourceNode->name(), QVariant(), parentNode);
+    _arena->copyValue(clone, sourceNode);
+    clone->setType(sourceNode->type());
+
+    QVector<QPair<const TreeNode *, TreeNode *>> stack{qMakePair(sourceNode, clone)};
+    while (!stack.isEmpty()) {
+        const QPair<const TreeNode *, TreeNode *> item = stack.takeLast();
+
+        if (_reloadLoader->hasPendingChildren(item.first)) {
+            _loader->setPendingValue(item.second, _reloadLoader->pendingValue(item.first));
+        }
+        auto hash = _reloadHashes->constFind(item.first);
+        if (hash != _reloadHashes->constEnd()) {
+            _hashes.insert(item.second, *hash);
+        }
+
+        for (const TreeNode *child : item.first->children()) {
+            TreeNode *copy = _arena->create(child->name(), QVariant(), item.second);
+            _arena->copyValue(copy, child);
+            copy->setType(child->type());
+            item.second->appendChild(copy);
+            stack.append(qMakePair(child, copy));
+        }
+    }
+    return clone;
+}
+
+void TreeModel::forgetSubtree(TreeNode *node) {
+    if (_searchIndex) {
+        _searchIndex->removeSubtree(node);
+    }
+    if (_pathIndex) {
+        _pathIndex->removeSubtree(node);
+    }
+
+    QVector<TreeNode *> stack{node};
+    while (!stack.isEmpty()) {
+        TreeNode *current = stack.takeLast();
+        _loader->forgetPending(current);
+        _hashes.remove(current);
+        _versions.remove(current);
+        _batchNodes.remove(current);
+        for (TreeNode *child : current->children()) {
+            stack.append(child);
+        }
+    }
+}
+
+void TreeModel::cancelLoading() {
+    if (_loading) {
+        _loader->cancel();
+    }
+}
+
+void TreeModel::flush() {
+    if (!isEditable()) {
+        return;
+    }
+    _saver.flush();
+}
+
+void TreeModel::setSaveDelay(int delay) {
+    if (_saver.delay() == delay) {
+        return;
+    }
+    _saver.setDelay(delay);
+    emit saveDelayChanged();
+}
+
+void TreeModel::setPersistenceMode(PersistenceMode mode) {
+    if (_persistenceMode == mode) {
+        return;
+    }
+    _persistenceMode = mode;
+
+    // write-behind saves the whole document anyway, the journal is folded in now
+    if (mode == WriteBehind && _journal.size() > 0) {
+        compactJournal();
+    }
+    emit persistenceModeChanged();
+}
+
+void TreeModel::setJournalThreshold(qint64 threshold) {
+    if (_journalThreshold == threshold) {
+        return;
+    }
+    _journalThreshold = threshold;
+    emit journalThresholdChanged();
+}
+
+void TreeModel::setCompressionLevel(int level) {
+    if (_compressionLevel == level) {
+        return;
+    }
+    _compressionLevel = level;
+    emit compressionLevelChanged();
+}
+
+void TreeModel::replayJournal(TreeNode *rootNode) {
+    const QVector<TreeJournal::Operation> operations = _journal.read();
+    if (operations.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    const JsonPointer::FetchFunction fetch = [this](TreeNode *node) {
+        if (_loader->hasPendingChildren(node)) {
+            fetchPendingChildren(node);
+        }
+    };
+
+    for (const TreeJournal::Operation &operation : operations) {
+        TreeNode *node = JsonPointer::resolve(rootNode, operation.path, fetch);
+        if (!node || node->type() != TreeNode::Value) {
+            qWarning() << "[WARNING] :: journal entry does not match the document:" << operation.path;
             continue;
         }
+        const TreeNode::ValueKind oldKind = node->valueKind();
+        _arena->setJsonValue(node, operation.value);
+        if (_searchIndex) {
+            _searchIndex->update(node);
+        }
+        TreeHash::invalidate(node, _hashes);
+        TreeVersion::invalidate(node, _versions);
+        if (_aggregates) {
+            // replayed before the views see the tree, so nothing is announced
+            TreeAggregates::valueChanged(*_arena, node, oldKind);
+        }
+    }
+    _stats.recordPhase(QStringLiteral("journalReplay"), timer.elapsed());
+}
 
-        obj->children().append(new TreeNode("", value, obj));
+TreeSaver::WriteFunction TreeModel::saveSnapshot() {
+    if (!isEditable()) {
+        return TreeSaver::WriteFunction();
     }
+
+    _saveTimer.start();
+    // the version is written on the saver's worker while the tree is edited further
+    const TreeVersion version = snapshot();
+    if (version.isNull()) {
+        return TreeSaver::WriteFunction();
+    }
+    _journal.rotate();
+
+    const DocumentFormat::Format documentFormat = _loader->format();
+    const DocumentFormat::Compression compression = _loader->compression();
+    const int level = _compressionLevel;
+
+    _stats.recordPhase(QStringLiteral("saveSnapshot"), _saveTimer.elapsed());
+    return [version, documentFormat, compression, level](QIODevice *device) {
+        return writeCompressed(device, compression, level, [&version, documentFormat](QIODevice *target) {
+            return version.write(target, documentFormat, QJsonDocument::Indented);
+        });
+    };
 }
 
-TreeNode* TreeModel::setupJsonModelData() {
+void TreeModel::compactJournal() {
+    if (!isEditable()) {
+        return;
+    }
+    _saver.markDirty();
+    _saver.flush();
+}
 
-    TreeNode* rootNode = new TreeNode("Config", "");
-    QFile jsonFile(_jsonFile);
+void TreeModel::markDirty() {
+    if (!isEditable()) {
+        return;
+    }
+    _saver.markDirty();
+}
 
-    if (!jsonFile.open(QIODevice::ReadOnly)) {
-        qDebug() << "ERROR - failed to open json file";
-        return rootNode;
+void TreeModel::fetchPendingChildren(TreeNode *node) {
+    _loader->fetchChildren(node);
+    // same content, but the new children have no frozen nodes, which invalidate() relies on
+    TreeVersion::invalidate(node, _versions);
+    if (_aggregates) {
+        for (TreeNode *child : node->children()) {
+            TreeAggregates::aggregateTree(*_arena, child, [this](const TreeNode *pending) {
+                return aggregatedPending(*_loader, pending);
+            });
+        }
+        // the node was aggregated from its pending value already, except a JSON Lines record
+        if (_loader->isJsonLines()) {
+            TreeAggregates::childrenAdded(*_arena, node, node->children());
+        }
+    }
+    if (_searchIndex) {
+        _searchIndex->addChildren(node);
+    }
+    if (_pathIndex && node != _rootNode && !_pathIndex->contains(node)) {
+        // a record of a JSON Lines file, indexed from the moment it is built
+        _pathIndex->addSubtree(node);
+    } else if (_pathIndex) {
+        _pathIndex->addChildren(node);
+    }
+}
+
+QVector<const TreeNode *> TreeModel::findNodes(const QString &text) {
+    if (!_searchIndex) {
+        // built on the first search only, and kept up to date from then on
+        QElapsedTimer timer;
+        timer.start();
+        _searchIndex = QSharedPointer<TreeSearchIndex>::create();
+        if (_loader->isJsonLines()) {
+            // the records themselves are not indexed, only what was built of them
+            for (const TreeNode *record : _rootNode->children()) {
+                _searchIndex->addChildren(record);
+            }
+        } else {
+            _searchIndex->addChildren(_rootNode);
+        }
+        _stats.recordPhase(QStringLiteral("searchIndex"), timer.elapsed());
+    }
+    return _searchIndex->find(text);
+}
+
+QModelIndex TreeModel::indexForPath(const QString &path) {
+    if (_loading) {
+        // the placeholder has no nodes, and the loader belongs to the worker
+        return QModelIndex();
+    }
+
+    if (!_pathIndex) {
+        // built on the first lookup only, and kept up to date from then on
+        QElapsedTimer timer;
+        timer.start();
+        _pathIndex = QSharedPointer<TreePathIndex>::create();
+        if (_loader->isJsonLines()) {
+            // records are only indexed while they are built
+            for (const TreeNode *record : _rootNode->children()) {
+                if (!_loader->hasPendingChildren(record)) {
+                    _pathIndex->addSubtree(record);
+                }
+            }
+        } else {
+            _pathIndex->addChildren(_rootNode);
+        }
+        _stats.recordPhase(QStringLiteral("pathIndex"), timer.elapsed());
+    }
+
+    TreeNode *node = _pathIndex->node(path);
+    if (!node) {
+        // the path may lead into children that are not built yet
+        node = JsonPointer::resolve(_rootNode, path, [this](TreeNode *pending) {
+            const QModelIndex index = indexForNode(pending);
+            if (canFetchMore(index)) {
+                fetchMore(index);
+            }
+        });
+    }
+
+    if (!node) {
+        return QModelIndex();
+    }
+    return indexForNode(node);
+}
+
+QString TreeModel::pathForIndex(const QModelIndex &index) const {
+    return pathForNode(nodeForIndex(index));
+}
+
+QVariant TreeModel::valueAt(const QString &path) {
+    if (path.isEmpty()) {
+        return serializeTree(_rootNode).toVariant();
+    }
+
+    const QModelIndex index = indexForPath(path);
+    if (!index.isValid()) {
+        return QVariant();
+    }
+
+    TreeNode *node = nodeForIndex(index);
+    if (node->type() != TreeNode::Value) {
+        return serializeTree(node).toVariant();
+    }
+    // unlike data(), a null is returned as a null QVariant
+    return node->jsonValue().toVariant();
+}
+
+QString TreeModel::pathForNode(const TreeNode *node) const {
+    if (node == _rootNode) {
+        return QString();
+    }
+    // walks up for nodes the index does not know, and before there is one
+    return _pathIndex && _pathIndex->contains(node) ? _pathIndex->path(node) : JsonPointer::pathFor(node);
+}
+
+QModelIndex TreeModel::indexForNode(TreeNode *node) const {
+    if (node == _rootNode) {
+        return QModelIndex();
+    }
+    return createIndex(node->row(), 0, node);
+}
+
+TreeNode *TreeModel::nodeForIndex(const QModelIndex &index) const {
+    if (!index.isValid()) {
+        return _rootNode;
+    }
+    return static_cast<TreeNode *>(index.internalPointer());
+}
+
+bool TreeModel::hasChildren(const QModelIndex &parent) const {
+    TREE_STATS_SCOPE(_stats, TreeStats::HasChildren);
+    TreeNode *node = nodeForIndex(parent);
+    if (node->childCount() > 0) {
+        return true;
+    }
+    // the loader's bookkeeping is owned by the worker until loading is done
+    return !_loading && _loader->hasPendingChildren(node);
+}
+
+bool TreeModel::canFetchMore(const QModelIndex &parent) const {
+    TREE_STATS_SCOPE(_stats, TreeStats::CanFetchMore);
+    return !_loading && _loader->hasPendingChildren(nodeForIndex(parent));
+}
+
+void TreeModel::fetchMore(const QModelIndex &parent) {
+    TREE_STATS_SCOPE(_stats, TreeStats::FetchMore);
+    if (!canFetchMore(parent)) {
+        return;
+    }
+
+    TreeNode *node = nodeForIndex(parent);
+    const int count = _loader->pendingChildCount(node);
+    const int first = node->childCount();
+
+    if (count > 0) {
+        beginInsertRows(parent, first, first + count - 1);
+        fetchPendingChildren(node);
+        endInsertRows();
+    } else {
+        // e.g. an empty record of a JSON Lines file, which is no longer pending afterwards
+        fetchPendingChildren(node);
     }
+    emitAggregatesChanged(node);
 
-    QJsonDocument jsonDoc = QJsonDocument::fromJson(jsonFile.readAll());
-    QJsonObject jsonObj = jsonDoc.object();
-    traverseJsonObject(rootNode, jsonObj);
+    if (_loader->isJsonLines()) {
+        unloadRecords();
+    }
+}
+
+void TreeModel::unloadRecords() {
+    for (TreeNode *record : _loader->recordsToUnload()) {
+        if (record->childCount() > 0) {
+            removeChildRows(record, 0, record->childCount() - 1);
+        }
+        // records are only indexed while they are built
+        if (_pathIndex) {
+            _pathIndex->removeSubtree(record);
+        }
+        _loader->unloadRecord(record);
+    }
+}
+
+void TreeModel::emitAggregatesChanged(TreeNode *node) {
+    if (!_aggregates) {
+        return;
+    }
+    for (TreeNode *current = node; current != _rootNode; current = current->parentNode()) {
+        emit dataChanged(createIndex(current->row(), TreeNode::DescendantCountColumn, current),
+                         createIndex(current->row(), TreeNode::TypeColumn, current),
+                         {ValueRole, Qt::DisplayRole});
+    }
+}
+
+void TreeModel::setRecordCacheSize(int size) {
+    _loader->setRecordCacheSize(size);
+    if (!_loading && _loader->isJsonLines()) {
+        unloadRecords();
+    }
+}
 
-    return rootNode;
+void TreeModel::setProgress(int progress) {
+    if (_progress == progress) {
+        return;
+    }
+    _progress = progress;
+    emit progressChanged();
+}
+
+void TreeModel::setLoading(bool loading) {
+    if (_loading == loading) {
+        return;
+    }
+    _loading = loading;
+    emit loadingChanged();
 }
 
 int TreeModel::rowCount(const QModelIndex &parent) const
 {
+    TREE_STATS_SCOPE(_stats, TreeStats::RowCount);
     int rowCount = 0;
     if (!parent.isValid()) {
         rowCount = _rootNode->children().count();
@@ -139,17 +1062,29 @@ int TreeModel::rowCount(const QModelIndex &parent) const
 
 int TreeModel::columnCount(const QModelIndex &parent) const
 {
+    TREE_STATS_SCOPE(_stats, TreeStats::ColumnCount);
     Q_UNUSED(parent);
-    return 1;
+    return _aggregates ? int(TreeNode::ColumnCount) : 1;
 }
 
 QVariant TreeModel::data(const QModelIndex &index, int role) const
 {
+    TREE_STATS_SCOPE(_stats, TreeStats::Data);
     if (!index.isValid()) {
         return QVariant();
     }
 
     TreeNode *node = static_cast<TreeNode *>(index.internalPointer());
+    if (_loader->isJsonLines() && !_loading) {
+        // what is shown stays built, see recordCacheSize(); only the loader's
+        // use order changes, which touchRecord() keeps in mutable members
+        _loader->touchRecord(node);
+    }
+
+    if (index.column() != TreeNode::NameColumn) {
+        return (role == ValueRole || role == Qt::DisplayRole) ? node->data(index.column()) : QVariant();
+    }
+
     if (role == NameRole) {
         return node->name();
     }
@@ -163,6 +1098,7 @@ QVariant TreeModel::data(const QModelIndex &index, int role) const
 
 QModelIndex TreeModel::index(int row, int column, const QModelIndex &parent) const
 {
+    TREE_STATS_SCOPE(_stats, TreeStats::Index);
     if (!hasIndex(row, column, parent)) {
         return QModelIndex();
     }
@@ -184,6 +1120,7 @@ QModelIndex TreeModel::index(int row, int column, const QModelIndex &parent) con
 
 QModelIndex TreeModel::parent(const QModelIndex &index) const
 {
+    TREE_STATS_SCOPE(_stats, TreeStats::Parent);
     if (!index.isValid()) {
         return QModelIndex();
     }
@@ -208,45 +1145,589 @@ QHash<int, QByteArray> TreeModel::roleNames() const
     return roles;
 }
 
+QVariantMap TreeModel::memoryStats() const
+{
+    const NamePool &names = _arena->names();
+
+    QVariantMap stats;
+    stats["nodes"] = _arena->nodeCount();
+    stats["nodeBytes"] = _arena->bytesReserved();
+    stats["nodeSize"] = int(sizeof(TreeNode));
+    stats["stringValueBytes"] = _arena->stringBytesReserved();
+    stats["aggregateBytes"] = _arena->aggregateBytesReserved();
+    stats["uniqueNames"] = names.uniqueNames();
+    stats["nameLookups"] = names.lookups();
+    stats["nameBytes"] = names.bytesStored();
+    stats["nameBytesSaved"] = names.bytesSaved();
+    stats["searchIndexNodes"] = _searchIndex ? _searchIndex->nodeCount() : 0;
+    stats["pathIndexNodes"] = _pathIndex ? _pathIndex->nodeCount() : 0;
+    stats["frozenNodes"] = int(_versions.count());
+    stats["frozenNodeSize"] = int(sizeof(TreeVersionNode));
+    return stats;
+}
+
 QJsonValue TreeModel::serializeTree(TreeNode* item) {
-    if (item->children().isEmpty()) {
+    return serializeTree(item, [this](const TreeNode *node) {
+        if (_loading || !_loader->hasPendingChildren(node)) {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+        return _loader->pendingValue(node);
+    });
+}
+
+QJsonValue TreeModel::serializeTree(const TreeNode *item, const std::function<QJsonValue(const TreeNode *)> &pendingValue) {
+    const QJsonValue pending = pendingValue(item);
+    if (!pending.isUndefined()) {
+        // children were never built, the original JSON value is still up to date
+        return pending;
+    }
+
+    if (item->type() == TreeNode::Array) {
+        QJsonArray jsonArray;
+        for (const TreeNode* child : item->children()) {
+            jsonArray.append(serializeTree(child, pendingValue));
+        }
+        return jsonArray;
+    }
+
+    if (item->type() == TreeNode::Value && item->children().isEmpty()) {
         // we reached the leaf node, now return its value
-        return QJsonValue::fromVariant(item->value());
+        return item->jsonValue();
     }
 
     QJsonObject jsonObject;
-    for (TreeNode* child : item->children()) {
+    for (const TreeNode* child : item->children()) {
         // recursively serialize the tree for each child node
         QString key = child->name();
-        jsonObject[key] = serializeTree(child);
+        jsonObject[key] = serializeTree(child, pendingValue);
     }
     return jsonObject;
 }
 
 QJsonDocument TreeModel::serializeTreeToJson() {
-    QJsonValue rootValue = serializeTree(_rootNode);
-    return QJsonDocument(rootValue.toObject());
+    // written like a save, so that both give the same document for every kind of root
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!writeTree(&buffer, DocumentFormat::Json, QJsonDocument::Compact)) {
+        qWarning() << "[WARNING] :: failed to serialize the tree";
+        return QJsonDocument();
+    }
+    return QJsonDocument::fromJson(buffer.data());
+}
+
+bool TreeModel::writeTree(QIODevice *device, QJsonDocument::JsonFormat format) {
+    return writeTree(device, DocumentFormat::Json, format);
+}
+
+bool TreeModel::writeTree(QIODevice *device, DocumentFormat::Format documentFormat, QJsonDocument::JsonFormat format) {
+    const auto pendingValue = [this](const TreeNode *node) {
+        if (_loading || !_loader->hasPendingChildren(node)) {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+        return _loader->pendingValue(node);
+    };
+
+    switch (documentFormat) {
+    case DocumentFormat::Cbor: {
+        CborDocumentWriter writer(device);
+        return TreeWriter::writeNodes(writer, _rootNode, pendingValue);
+    }
+    case DocumentFormat::MessagePack: {
+        MsgPackWriter writer(device);
+        return TreeWriter::writeNodes(writer, _rootNode, pendingValue);
+    }
+    case DocumentFormat::Json:
+        break;
+    }
+    JsonStreamWriter writer(device, format);
+    return TreeWriter::writeNodes(writer, _rootNode, pendingValue);
+}
+
+bool TreeModel::writeDocument(QIODevice *device, DocumentFormat::Format documentFormat,
+                              DocumentFormat::Compression compression, QJsonDocument::JsonFormat format) {
+    return writeCompressed(device, compression, _compressionLevel, [this, documentFormat, format](QIODevice *target) {
+        return writeTree(target, documentFormat, format);
+    });
+}
+
+bool TreeModel::writeCompressed(QIODevice *device, DocumentFormat::Compression compression, int level,
+                                const TreeSaver::WriteFunction &write) {
+    if (compression == DocumentFormat::Uncompressed) {
+        return write(device);
+    }
+
+    // compressed while it is written, the uncompressed document never exists in full
+    CompressedDevice compressed(device, compression);
+    compressed.setLevel(level);
+    if (!compressed.open(QIODevice::WriteOnly)) {
+        qWarning() << "[WARNING] :: failed to compress:" << compressed.errorString();
+        return false;
+    }
+    const bool written = write(&compressed);
+    return compressed.finish() && written;
 }
 
-void TreeModel::saveToJsonFile(const QString& filePath) {
-    QJsonDocument doc = serializeTreeToJson();
-    QFile file(filePath);
-    if (file.open(QIODevice::WriteOnly)) {
-        file.write(doc.toJson());
-        file.close();
+QJsonValue TreeModel::aggregatedPending(const TreeLoader &loader, const TreeNode *node) {
+    if (loader.isJsonLines() || !loader.hasPendingChildren(node)) {
+        return QJsonValue(QJsonValue::Undefined);
     }
+    return loader.pendingValue(node);
+}
+
+void TreeModel::saveToJsonFile(const QString& filePath, QJsonDocument::JsonFormat format) {
+    if (isReadOnly()) {
+        qWarning() << "[WARNING] :: cannot save a read-only JSON Lines model:" << filePath;
+        return;
+    }
+
+    // the model's own file keeps the format it was read in, other files get the one their name says
+    const bool ownFile = QFileInfo(filePath) == QFileInfo(_jsonFile);
+    const DocumentFormat::Format documentFormat = ownFile ? _loader->format() : DocumentFormat::fromFileName(filePath);
+    const DocumentFormat::Compression compression =
+        ownFile ? _loader->compression() : DocumentFormat::compressionFromFileName(filePath);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly) || !writeDocument(&file, documentFormat, compression, format)
+        || !file.commit()) {
+        qWarning() << "[WARNING] :: failed to save" << DocumentFormat::name(documentFormat) << "file:" << filePath;
+        return;
+    }
+
+    if (ownFile) {
+        _fileKey = TreeSnapshot::SourceKey::of(_jsonFile);
+    }
+}
+
+TreeVersion TreeModel::snapshot() {
+    if (_loader->isJsonLines() || _loading || _loadCanceled) {
+        // the empty tree shown until the worker is done is not the document
+        return TreeVersion();
+    }
+    // frozen on the first call, afterwards only the paths edited since the versions still held
+    return TreeVersion::freeze(_rootNode, [this](const TreeNode *node) { return _loader->frozenPending(node); },
+                               _versions);
 }
 
 bool TreeModel::setData(const QModelIndex &index, const QVariant &value, int role) {
     // we are not using role, as we are simply editing value at given index
     Q_UNUSED(role);
+    TREE_STATS_SCOPE(_stats, TreeStats::SetData);
 
-    TreeNode* node = static_cast<TreeNode*>(index.internalPointer());
-    if (index.isValid()) {
-        node->setValue(value);
-        emit dataChanged(index, index, {Qt::EditRole});
-        saveToJsonFile(_jsonFile);
-        return true;
+    if (!isEditable() || !index.isValid() || index.column() != TreeNode::NameColumn) {
+        return false;
+    }
+
+    // objects and arrays hold no value, as in setValues()
+    TreeNode *node = static_cast<TreeNode *>(index.internalPointer());
+    if (node->type() != TreeNode::Value) {
+        return false;
+    }
+
+    // a single edit is a batch of one, inside an open batch it is just collected
+    beginBatch();
+    applyValue(node, value);
+    commitBatch();
+    return true;
+}
+
+bool TreeModel::setValues(const QVariantList &updates) {
+    if (!isEditable()) {
+        return false;
+    }
+
+    // everything is validated before the first value changes
+    QVector<QPair<TreeNode *, QVariant>> resolved;
+    resolved.reserve(updates.count());
+    for (const QVariant &update : updates) {
+        const QVariantMap fields = update.toMap();
+        TreeNode *node = nullptr;
+
+        if (fields.contains(QStringLiteral("index"))) {
+            const QModelIndex index = fields.value(QStringLiteral("index")).value<QModelIndex>();
+            if (index.isValid() && index.model() == this) {
+                node = nodeForIndex(index);
+            }
+        } else if (fields.contains(QStringLiteral("path"))) {
+            const QString path = fields.value(QStringLiteral("path")).toString();
+            node = path.isEmpty() ? nullptr : nodeForPath(path);
+        }
+
+        if (!node || node->type() != TreeNode::Value || !fields.contains(QStringLiteral("value"))) {
+            qWarning() << "[WARNING] :: invalid update, no value was changed:" << fields;
+            return false;
+        }
+        resolved.append(qMakePair(node, fields.value(QStringLiteral("value"))));
+    }
+
+    beginBatch();
+    for (const QPair<TreeNode *, QVariant> &update : resolved) {
+        applyValue(update.first, update.second);
+    }
+    commitBatch();
+    return true;
+}
+
+void TreeModel::beginBatch() {
+    ++_batchDepth;
+}
+
+void TreeModel::commitBatch() {
+    if (_batchDepth == 0) {
+        qWarning() << "[WARNING] :: commitBatch() called without beginBatch()";
+        return;
+    }
+    if (--_batchDepth > 0) {
+        return;
+    }
+
+    // adjacent rows of the same parent are announced with one signal
+    QHash<TreeNode *, QVector<int>> rowsByParent;
+    for (const TreeNode *node : std::as_const(_batchNodes)) {
+        rowsByParent[node->parentNode()].append(node->row());
+    }
+    _batchNodes.clear();
+
+    // the size and type columns of a leaf change along with its value
+    const int lastColumn = _aggregates ? int(TreeNode::TypeColumn) : 0;
+    for (auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it) {
+        TreeNode *parentNode = it.key();
+        QVector<int> &rows = it.value();
+        std::sort(rows.begin(), rows.end());
+
+        int first = 0;
+        while (first < rows.count()) {
+            int last = first;
+            while (last + 1 < rows.count() && rows.at(last + 1) == rows.at(last) + 1) {
+                ++last;
+            }
+            emit dataChanged(createIndex(rows.at(first), 0, parentNode->children().at(rows.at(first))),
+                             createIndex(rows.at(last), lastColumn, parentNode->children().at(rows.at(last))),
+                             {ValueRole, Qt::EditRole});
+            first = last + 1;
+        }
+    }
+
+    // and so do the sizes and leaf types of the ancestors, each is announced once
+    if (_aggregates) {
+        QSet<TreeNode *> ancestors;
+        for (auto it = rowsByParent.constBegin(); it != rowsByParent.constEnd(); ++it) {
+            for (TreeNode *node = it.key(); node != _rootNode && !ancestors.contains(node); node = node->parentNode()) {
+                ancestors.insert(node);
+                emit dataChanged(createIndex(node->row(), TreeNode::JsonSizeColumn, node),
+                                 createIndex(node->row(), TreeNode::TypeColumn, node),
+                                 {ValueRole, Qt::DisplayRole});
+            }
+        }
+    }
+
+    // one journal write or one save for the whole batch
+    bool dirty = _batchDirty;
+    if (!_batchOperations.isEmpty()) {
+        if (_persistenceMode == Journal && _journal.append(_batchOperations)) {
+            if (_journal.size() >= _journalThreshold) {
+                compactJournal();
+            }
+        } else {
+            dirty = true;
+        }
+        _batchOperations.clear();
+    }
+    _batchDirty = false;
+
+    if (dirty) {
+        markDirty();
+    }
+}
+
+void TreeModel::applyValue(TreeNode *node, const QVariant &value) {
+    const TreeNode::ValueKind oldKind = node->valueKind();
+    _arena->setValue(node, value);
+    if (_aggregates) {
+        TreeAggregates::valueChanged(*_arena, node, oldKind);
+    }
+    if (_searchIndex) {
+        _searchIndex->update(node);
+    }
+    TreeHash::invalidate(node, _hashes);
+    TreeVersion::invalidate(node, _versions);
+    _batchNodes.insert(node);
+
+    if (_persistenceMode == Journal) {
+        _batchOperations.append({pathForNode(node), node->jsonValue()});
+    } else {
+        _batchDirty = true;
+    }
+}
+
+bool TreeModel::insertRows(int row, int count, const QModelIndex &parent) {
+    TreeNode *parentNode = nodeForIndex(parent);
+    if (!isEditable() || count <= 0 || parentNode->type() == TreeNode::Value) {
+        return false;
+    }
+
+    fetchAllChildren(parentNode);
+    if (row < 0 || row > parentNode->childCount()) {
+        return false;
+    }
+
+    // new members need names of their own, new elements are unnamed
+    QSet<QString> names;
+    if (parentNode->type() == TreeNode::Object) {
+        for (const TreeNode *child : parentNode->children()) {
+            names.insert(child->name());
+        }
+    }
+
+    QList<TreeNode *> nodes;
+    nodes.reserve(count);
+    int suffix = 0;
+    for (int i = 0; i < count; ++i) {
+        QString name;
+        if (parentNode->type() == TreeNode::Object) {
+            name = NEW_MEMBER_NAME;
+            while (names.contains(name)) {
+                name = NEW_MEMBER_NAME + QString::number(++suffix);
+            }
+            names.insert(name);
+        }
+        nodes.append(_arena->create(name, QString(), parentNode));
+    }
+
+    if (!insertNodes(parentNode, row, nodes)) {
+        return false;
+    }
+    persistStructure();
+    return true;
+}
+
+bool TreeModel::removeRows(int row, int count, const QModelIndex &parent) {
+    TreeNode *parentNode = nodeForIndex(parent);
+    if (!isEditable() || count <= 0 || row < 0 || row + count > parentNode->childCount()) {
+        return false;
+    }
+
+    removeChildRows(parentNode, row, row + count - 1);
+    if (_pathIndex && parentNode->type() == TreeNode::Array) {
+        _pathIndex->reindexChildren(parentNode, row);
+    }
+    persistStructure();
+    return true;
+}
+
+bool TreeModel::moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                         const QModelIndex &destinationParent, int destinationChild) {
+    TreeNode *sourceNode = nodeForIndex(sourceParent);
+    TreeNode *destinationNode = nodeForIndex(destinationParent);
+    if (!isEditable() || count <= 0 || sourceRow < 0 || sourceRow + count > sourceNode->childCount()
+        || destinationNode->type() == TreeNode::Value || sourceNode->type() != destinationNode->type()) {
+        return false;
+    }
+
+    if (sourceNode != destinationNode) {
+        fetchAllChildren(destinationNode);
+
+        for (const TreeNode *node = destinationNode; node->parentNode(); node = node->parentNode()) {
+            if (node->parentNode() == sourceNode && node->row() >= sourceRow && node->row() < sourceRow + count) {
+                return false;
+            }
+        }
+
+        if (destinationNode->type() == TreeNode::Object) {
+            QSet<QString> names;
+            for (const TreeNode *child : destinationNode->children()) {
+                names.insert(child->name());
+            }
+            for (int row = sourceRow; row < sourceRow + count; ++row) {
+                if (names.contains(sourceNode->children().at(row)->name())) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    if (destinationChild < 0 || destinationChild > destinationNode->childCount()
+        || !beginMoveRows(sourceParent, sourceRow, sourceRow + count - 1, destinationParent, destinationChild)) {
+        return false;
+    }
+    const QList<TreeNode *> moved = sourceNode->takeChildren(sourceRow, count);
+    const int row = (sourceNode == destinationNode && destinationChild > sourceRow) ? destinationChild - count : destinationChild;
+    destinationNode->insertChildren(row, moved);
+    endMoveRows();
+
+    if (_aggregates && sourceNode != destinationNode) {
+        TreeAggregates::childrenRemoved(*_arena, sourceNode, moved);
+        TreeAggregates::childrenAdded(*_arena, destinationNode, moved);
+        emitAggregatesChanged(sourceNode);
+        emitAggregatesChanged(destinationNode);
+    }
+
+    // members keep their paths within their object, elements take those of their new indexes
+    if (_pathIndex && destinationNode->type() == TreeNode::Array) {
+        _pathIndex->reindexChildren(destinationNode, sourceNode == destinationNode ? qMin(sourceRow, row) : row);
+    } else if (_pathIndex && sourceNode != destinationNode) {
+        for (const TreeNode *node : moved) {
+            _pathIndex->removeSubtree(node);
+            _pathIndex->addSubtree(node);
+        }
+    }
+    if (_pathIndex && sourceNode != destinationNode && sourceNode->type() == TreeNode::Array) {
+        _pathIndex->reindexChildren(sourceNode, sourceRow);
+    }
+
+    TreeHash::invalidate(sourceNode, _hashes);
+    TreeHash::invalidate(destinationNode, _hashes);
+    TreeVersion::invalidate(sourceNode, _versions);
+    TreeVersion::invalidate(destinationNode, _versions);
+    persistStructure();
+    return true;
+}
+
+bool TreeModel::insertValues(const QString &path, int row, const QVariantList &values) {
+    if (!isEditable() || values.isEmpty()) {
+        return false;
+    }
+
+    TreeNode *parentNode = nodeForPath(path);
+    if (!parentNode || parentNode->type() != TreeNode::Array) {
+        qWarning() << "[WARNING] :: cannot insert values, not an array:" << path;
+        return false;
+    }
+
+    fetchAllChildren(parentNode);
+    if (row == -1) {
+        row = parentNode->childCount();
+    }
+    if (row < 0 || row > parentNode->childCount()) {
+        qWarning() << "[WARNING] :: cannot insert values, row out of range:" << path << row;
+        return false;
+    }
+
+    if (!insertNodes(parentNode, row, buildNodes(QJsonArray::fromVariantList(values)))) {
+        return false;
+    }
+    persistStructure();
+    return true;
+}
+
+bool TreeModel::insertMembers(const QString &path, const QVariantMap &members) {
+    if (!isEditable() || members.isEmpty()) {
+        return false;
+    }
+
+    TreeNode *parentNode = nodeForPath(path);
+    if (!parentNode || parentNode->type() != TreeNode::Object) {
+        qWarning() << "[WARNING] :: cannot insert members, not an object:" << path;
+        return false;
+    }
+
+    fetchAllChildren(parentNode);
+    for (const TreeNode *child : parentNode->children()) {
+        if (members.contains(child->name())) {
+            qWarning() << "[WARNING] :: cannot insert members, already exists:" << path << child->name();
+            return false;
+        }
+    }
+
+    if (!insertNodes(parentNode, parentNode->childCount(), buildNodes(QJsonObject::fromVariantMap(members)))) {
+        return false;
+    }
+    persistStructure();
+    return true;
+}
+
+int TreeModel::removePaths(const QStringList &paths) {
+    if (!isEditable()) {
+        return 0;
+    }
+
+    // everything is resolved first, removing rows shifts the indexes of array elements
+    QSet<const TreeNode *> nodes;
+    for (const QString &path : paths) {
+        TreeNode *node = path.isEmpty() ? nullptr : nodeForPath(path);
+        if (!node) {
+            qWarning() << "[WARNING] :: cannot remove, path does not resolve:" << path;
+            continue;
+        }
+        nodes.insert(node);
+    }
+
+    // nodes below another removed node go with it
+    QHash<TreeNode *, QVector<int>> rowsByParent;
+    for (const TreeNode *node : nodes) {
+        bool nested = false;
+        for (const TreeNode *ancestor = node->parentNode(); ancestor && !nested; ancestor = ancestor->parentNode()) {
+            nested = nodes.contains(ancestor);
+        }
+        if (!nested) {
+            rowsByParent[node->parentNode()].append(node->row());
+        }
+    }
+
+    int removed = 0;
+    for (auto it = rowsByParent.begin(); it != rowsByParent.end(); ++it) {
+        TreeNode *parentNode = it.key();
+        QVector<int> &rows = it.value();
+        std::sort(rows.begin(), rows.end());
+
+        // back to front, so the rows still to be removed keep their numbers
+        int last = rows.count() - 1;
+        while (last >= 0) {
+            int first = last;
+            while (first > 0 && rows.at(first - 1) == rows.at(first) - 1) {
+                --first;
+            }
+            removeChildRows(parentNode, rows.at(first), rows.at(last));
+            removed += last - first + 1;
+            last = first - 1;
+        }
+
+        if (_pathIndex && parentNode->type() == TreeNode::Array) {
+            _pathIndex->reindexChildren(parentNode, rows.first());
+        }
+    }
+
+    if (removed > 0) {
+        persistStructure();
+    }
+    return removed;
+}
+
+QList<TreeNode *> TreeModel::buildNodes(const QJsonValue &value) {
+    // built under a scratch node, so that they can be inserted in one pass; the
+    // loader's own arena is gone after a cancelled load, the model's never is
+    TreeNode *scratch = _arena->create(QString(), QVariant());
+    _loader->appendChildren(*_arena, scratch, value);
+    const QList<TreeNode *> nodes = scratch->takeChildren(0, scratch->childCount());
+    _arena->release(scratch);
+    return nodes;
+}
+
+TreeNode *TreeModel::nodeForPath(const QString &path) {
+    if (path.isEmpty()) {
+        return _rootNode;
+    }
+    const QModelIndex index = indexForPath(path);
+    return index.isValid() ? nodeForIndex(index) : nullptr;
+}
+
+void TreeModel::fetchAllChildren(TreeNode *node) {
+    const QModelIndex index = indexForNode(node);
+    if (canFetchMore(index)) {
+        fetchMore(index);
+    }
+}
+
+void TreeModel::persistStructure() {
+    // the whole document is written, which covers the values edited so far in
+    // an open batch, and their paths may not be valid any more
+    if (!_batchOperations.isEmpty()) {
+        _batchOperations.clear();
+        _batchDirty = true;
+    }
+
+    if (_persistenceMode == Journal) {
+        compactJournal();
+        return;
     }
-    return false;
+    markDirty();
 }
@@ -34,30 +34,328 @@
 #define __TREE_MODEL_H__
 
 #include <QFile>
+#include <QTimer>
+#include <QElapsedTimer>
 #include <QVariant>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonDocument>
+#include <QSharedPointer>
+#include <QFutureWatcher>
+#include <QFileSystemWatcher>
+#include <QSet>
 #include <QAbstractItemModel>
 
 #include "TreeNode.h"
+#include "TreeLoader.h"
+#include "TreeNodeArena.h"
+#include "TreeSaver.h"
+#include "TreeJournal.h"
+#include "TreeSearchIndex.h"
+#include "TreePathIndex.h"
+#include "TreeStats.h"
+#include "TreeHash.h"
+#include "TreeVersion.h"
 
 
 class TreeModel : public QAbstractItemModel
 {
     Q_OBJECT
 
+    /**
+     * @brief True while the JSON file is being loaded on a worker thread.
+     */
+    Q_PROPERTY(bool loading READ isLoading NOTIFY loadingChanged)
+
+    /**
+     * @brief Progress of the current load in percent (0 - 100).
+     */
+    Q_PROPERTY(int progress READ progress NOTIFY progressChanged)
+
+    /**
+     * @brief True while there are edits that have not been written to the JSON file yet.
+     */
+    Q_PROPERTY(bool dirty READ isDirty NOTIFY dirtyChanged)
+
+    /**
+     * @brief True while the JSON file is being written on a worker thread.
+     */
+    Q_PROPERTY(bool saving READ isSaving NOTIFY savingChanged)
+
+    /**
+     * @brief Window in milliseconds in which edits are coalesced into one save.
+     */
+    Q_PROPERTY(int saveDelay READ saveDelay WRITE setSaveDelay NOTIFY saveDelayChanged)
+
+    /**
+     * @brief How edits are persisted, see `PersistenceMode`.
+     */
+    Q_PROPERTY(PersistenceMode persistenceMode READ persistenceMode WRITE setPersistenceMode NOTIFY persistenceModeChanged)
+
+    /**
+     * @brief Journal size in bytes above which the journal is compacted into the JSON file.
+     */
+    Q_PROPERTY(qint64 journalThreshold READ journalThreshold WRITE setJournalThreshold NOTIFY journalThresholdChanged)
+
+    /**
+     * @brief Level at which compressed files (`*.gz`, `*.zst`) are written, -1 for the codec's default.
+     */
+    Q_PROPERTY(int compressionLevel READ compressionLevel WRITE setCompressionLevel NOTIFY compressionLevelChanged)
+
+    /**
+     * @brief Call counters, latency histograms and phase timings, see `TreeStats::toVariantMap()`.
+     *
+     * Refreshed once a second while instrumentation is compiled in.
+     */
+    Q_PROPERTY(QVariantMap stats READ stats NOTIFY statsChanged)
+
+    /**
+     * @brief True while changes made to the JSON file by other programs are merged into the model.
+     */
+    Q_PROPERTY(bool watchFile READ isWatchingFile WRITE setWatchFile NOTIFY watchFileChanged)
+
+    /**
+     * @brief True if the model cannot be edited, which is the case for JSON Lines files.
+     */
+    Q_PROPERTY(bool readOnly READ isReadOnly CONSTANT)
+
 public:
     /**
-     * @brief Constructs the TreeModel with an optional parent object.
+     * @brief Enum for the ways the JSON file can be loaded.
+     *
+     * - Synchronous: the tree is built in the constructor, on the calling thread.
+     * - Asynchronous: the tree is built on a worker thread and swapped in with a
+     *   model reset once it is ready; the model is empty until then.
+     * - Lazy: only the top-level nodes are built up front, children of objects
+     *   and arrays are built when a view expands them (see `fetchMore()`).
+     *   Can be combined with either of the above.
+     * - Cached: the tree is also written to a binary `<jsonFile>.snapshot`, and a
+     *   snapshot matching the file is memory-mapped on the next load instead of
+     *   parsing the JSON. Nodes built from a snapshot are always fetched lazily.
+     * - Parallel: the file is parsed into a QJsonDocument and the tree is built
+     *   on all cores (see `TreeLoader::setParallel()`). Ignored together with Lazy.
+     * - Watched: the file is watched and changes made by other programs are
+     *   merged into the model, see `setWatchFile()`.
+     * - JsonLines: the file holds one JSON value per line (NDJSON). It is
+     *   scanned once for the byte offset of every record, each record is a
+     *   top-level row and is parsed only when expanded; at most
+     *   `recordCacheSize()` records stay built. Files named `*.jsonl` or
+     *   `*.ndjson` are read this way without the flag. The model is read-only
+     *   and is not watched.
+     * - Aggregates: every node caches the number of its descendants and the
+     *   size of its value as compact JSON, in an arena block allocated only in
+     *   this mode, kept up to date along the ancestors
+     *   on every edit, and the model shows them with the JSON type as extra
+     *   columns (see `TreeNode::Column`). Nodes a lazy load has not built yet
+     *   are counted from the JSON value or snapshot record backing them; only
+     *   the records of a JSON Lines file are counted once they are built.
+     */
+    enum LoadMode {
+        Synchronous = 0x0,
+        Asynchronous = 0x1,
+        Lazy = 0x2,
+        Cached = 0x4,
+        Parallel = 0x8,
+        Watched = 0x10,
+        JsonLines = 0x20,
+        Aggregates = 0x40
+    };
+    Q_DECLARE_FLAGS(LoadModes, LoadMode)
+    Q_FLAG(LoadModes)
+
+    /**
+     * @brief Enum for the ways edits are persisted.
+     *
+     * - WriteBehind: edits are coalesced and the whole JSON file is rewritten
+     *   in the background after `saveDelay`.
+     * - Journal: every edit is appended to `<jsonFile>.journal` as a replace
+     *   operation keyed by its JSON Pointer path, which costs O(change). Once the
+     *   journal grows past `journalThreshold`, it is compacted into the JSON file
+     *   in the background.
+     *
+     * Journaled edits are replayed whenever the file is loaded, in both modes.
+     */
+    enum PersistenceMode {
+        WriteBehind,
+        Journal
+    };
+    Q_ENUM(PersistenceMode)
+
+    /**
+     * @brief Constructs the TreeModel for the given JSON file.
      *
      * This constructor initializes the model and sets up the root node (TreeNode).
      * The model is used for managing a tree structure of JSON data, which can
      * be displayed in views like QTreeView.
      *
-     * @param parent The parent QObject, default is nullptr.
+     * @param jsonFile The path of the JSON file to populate the model from.
+     * @param loadMode Whether to load the file synchronously or on a worker thread,
+     *                 and whether to build child nodes lazily.
+     */
+    explicit TreeModel(const QString jsonFile, LoadModes loadMode = Synchronous);
+
+    /**
+     * @brief Destructor for the TreeModel class.
+     *
+     * Writes pending edits, then cancels and waits for a running background
+     * load. The tree itself is freed in one pass by its `TreeNodeArena`.
+     */
+    ~TreeModel();
+
+    /**
+     * @brief Returns true while a background load is running.
+     */
+    inline bool isLoading() const { return _loading; }
+
+    /**
+     * @brief Returns the progress of the current load in percent.
+     */
+    inline int progress() const { return _progress; }
+
+    /**
+     * @brief Returns true if there are edits that have not been written yet.
+     */
+    inline bool isDirty() const { return _saver.isDirty(); }
+
+    /**
+     * @brief Returns true while the JSON file is being written on a worker thread.
+     */
+    inline bool isSaving() const { return _saver.isSaving(); }
+
+    /**
+     * @brief Returns the window in which edits are coalesced into one save, in milliseconds.
+     */
+    inline int saveDelay() const { return _saver.delay(); }
+
+    /**
+     * @brief Sets the window in which edits are coalesced into one save.
+     *
+     * @param delay The delay in milliseconds.
+     */
+    void setSaveDelay(int delay);
+
+    /**
+     * @brief Returns how edits are persisted.
+     */
+    inline PersistenceMode persistenceMode() const { return _persistenceMode; }
+
+    /**
+     * @brief Sets how edits are persisted.
+     *
+     * Switching to `WriteBehind` compacts a non-empty journal right away.
+     *
+     * @param mode The persistence mode.
+     */
+    void setPersistenceMode(PersistenceMode mode);
+
+    /**
+     * @brief Returns the journal size in bytes above which the journal is compacted.
+     */
+    inline qint64 journalThreshold() const { return _journalThreshold; }
+
+    /**
+     * @brief Sets the journal size in bytes above which the journal is compacted.
+     *
+     * @param threshold The threshold in bytes.
+     */
+    void setJournalThreshold(qint64 threshold);
+
+    /**
+     * @brief Returns the level at which compressed files are written.
+     */
+    inline int compressionLevel() const { return _compressionLevel; }
+
+    /**
+     * @brief Sets the level at which compressed files are written.
+     *
+     * Applies to saves of the model's own file when it was read compressed,
+     * and to `saveToJsonFile()` with a `.gz` or `.zst` path. Lower levels save
+     * faster, higher ones write less, see `CompressedDevice::setLevel()`.
+     *
+     * @param level 1 - 9 for gzip, 1 - 19 for Zstandard, or -1 for the codec's default.
+     */
+    void setCompressionLevel(int level);
+
+    /**
+     * @brief Returns the call counters, latency histograms and phase timings.
+     */
+    inline QVariantMap stats() const { return _stats.toVariantMap(); }
+
+    /**
+     * @brief Clears the call counters, latency histograms and phase timings.
+     */
+    Q_INVOKABLE void resetStats();
+
+    /**
+     * @brief Returns true if changes made to the JSON file by other programs are merged in.
+     */
+    inline bool isWatchingFile() const { return _watchFile; }
+
+    /**
+     * @brief Enables or disables watching the JSON file for changes.
+     *
+     * When the file changes, it is parsed again on a worker thread and the new
+     * tree is compared with the current one. Only what differs is updated, with
+     * `dataChanged`, `rowsInserted`, `rowsRemoved` and `rowsMoved`, so views keep
+     * their expanded nodes and scroll position. Unchanged subtrees are skipped
+     * by comparing their content hashes, so applying a change costs about as
+     * much as the change itself. Array elements are matched from both ends by
+     * content, so an element inserted or removed in one place is a single
+     * `rowsInserted` or `rowsRemoved`. Changes written by the model's own saves are
+     * recognized and ignored. An external change wins over the local edits
+     * that were not saved yet, which are dropped from the journal as well, so
+     * they are not replayed over the file on the next load.
+     *
+     * @param watch True to watch the file.
+     */
+    void setWatchFile(bool watch);
+
+    /**
+     * @brief Returns true if the model cannot be edited.
+     *
+     * JSON Lines files are opened read-only: `setData()`, the structural edits
+     * and the batch calls return false (or 0).
+     */
+    inline bool isReadOnly() const { return _loader->isJsonLines(); }
+
+    /**
+     * @brief Returns the format the file was read in, which saving keeps.
+     *
+     * CBOR (`*.cbor`) and MessagePack (`*.msgpack`, `*.mpk`) files are
+     * recognized by their name or their first bytes, see `DocumentFormat::detect()`.
+     */
+    inline DocumentFormat::Format documentFormat() const { return _loader->format(); }
+
+    /**
+     * @brief Returns the compression the file was read with, which saving keeps.
+     *
+     * `*.gz` and `*.zst` files, or files starting with the gzip or Zstandard
+     * magic number, are decompressed while they are parsed.
      */
-    explicit TreeModel(const QString jsonFile);
+    inline DocumentFormat::Compression compression() const { return _loader->compression(); }
+
+    /**
+     * @brief Returns true if the nodes' aggregates are maintained and shown as extra columns.
+     */
+    inline bool hasAggregates() const { return _aggregates; }
+
+    /**
+     * @brief Returns how many records of a JSON Lines file are kept built.
+     */
+    inline int recordCacheSize() const { return _loader->recordCacheSize(); }
+
+    /**
+     * @brief Sets how many records of a JSON Lines file are kept built.
+     *
+     * When a record is expanded and more records than this are built, the
+     * children of the least recently shown ones are removed again (with
+     * `rowsRemoved`); they are parsed anew when expanded the next time. This
+     * keeps the memory used by the tree bounded by the record size, whatever
+     * the size of the file.
+     *
+     * @param size The number of records (default 1000).
+     */
+    void setRecordCacheSize(int size);
 
     /**
      * @brief Enum for custom roles used in the model.
@@ -85,11 +383,11 @@ public:
      * @brief Returns the number of columns under a given parent index.
      *
      * This method is part of the QAbstractItemModel interface. It returns
-     * the number of columns in the model. In this case, it's a single column
-     * representing the node names.
+     * the number of columns in the model: a single column representing the
+     * node names, or `TreeNode::ColumnCount` with `LoadMode::Aggregates`.
      *
      * @param parent The parent index (default is QModelIndex()).
-     * @return The number of columns (in this case, 1).
+     * @return The number of columns.
      */
     int columnCount(const QModelIndex &parent = QModelIndex()) const override;
 
@@ -99,6 +397,7 @@ public:
      * This method is part of the QAbstractItemModel interface. It provides
      * the actual data for a given node at the specified index and role.
      * It uses the custom roles, like `NameRole`, to retrieve node name data.
+     * The aggregate columns return their value for `ValueRole` and `Qt::DisplayRole`.
      *
      * @param index The model index.
      * @param role The role that specifies what data to retrieve.
@@ -142,17 +441,49 @@ public:
      */
     QHash<int, QByteArray> roleNames() const override;
 
+    /**
+     * @brief Returns true if the node at the given index has children.
+     *
+     * In lazy mode this also accounts for children that are not built yet, so
+     * views show an expand indicator for them.
+     *
+     * @param parent The parent index (default is QModelIndex()).
+     * @return True if the node has (possibly pending) children.
+     */
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+
+    /**
+     * @brief Returns true if the node at the given index has children that are not built yet.
+     *
+     * @param parent The parent index.
+     * @return True if `fetchMore()` would add rows under the parent.
+     */
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    /**
+     * @brief Builds the pending children of the node at the given index.
+     *
+     * The new rows are announced with a single begin/endInsertRows pair. Only
+     * one level is built, nested containers stay pending until they are expanded.
+     *
+     * @param parent The parent index.
+     */
+    void fetchMore(const QModelIndex &parent) override;
+
     /**
      * @brief Recursively serializes a tree structure into a QJsonValue.
      *
      * This function recursively serializes the tree structure rooted at the given `TreeNode*`
-     * into a `QJsonValue`. The value can either be a `QJsonObject` if the node has children (e.g., an object or array),
-     * or a primitive JSON value (e.g., string, number, boolean) if the node is a leaf.
+     * into a `QJsonValue`. The value is a `QJsonArray` for array nodes, a `QJsonObject` for object nodes
+     * (and any other node with children), or a primitive JSON value (e.g., string, number, boolean) for leaves.
+     *
+     * Nodes whose children have not been built yet (lazy mode) are serialized
+     * straight from their pending JSON value.
      *
      * @param node The root node of the tree to be serialized.
      *
      * @return A `QJsonValue` representing the serialized JSON structure of the tree.
-     * It can be either a `QJsonObject` or a primitive JSON value.
+     * It can be a `QJsonObject`, a `QJsonArray` or a primitive JSON value.
      *
      * @note This function does not modify the tree structure, it only serializes it.
      */
@@ -163,25 +494,85 @@ public:
      *
      * This function serializes the entire tree structure starting from the root node into a `QJsonDocument`.
      * The resulting document can be written to a file or used for other purposes where a JSON format is required.
+     * It is parsed from the output of `writeTree()`, so it is the document a save writes,
+     * e.g. an array for the records of a JSON Lines file.
      *
      * @return A `QJsonDocument` containing the entire serialized tree structure.
      * The document will represent the entire tree as a JSON object or array.
      */
     QJsonDocument serializeTreeToJson();
 
+    /**
+     * @brief Writes the entire tree structure as JSON text to a device.
+     *
+     * The tree is walked once and written token by token through a `JsonStreamWriter`,
+     * without building a `QJsonDocument` first. Arrays stay arrays, nulls stay null,
+     * integers are written as integers and doubles always with a fraction or exponent,
+     * so loading the output gives back the same tree.
+     *
+     * @param device The device to write to, must be open for writing.
+     * @param format Indented (the default, like `QJsonDocument::toJson()`) or compact output.
+     * @return False if the device refused any of the data.
+     */
+    bool writeTree(QIODevice *device, QJsonDocument::JsonFormat format = QJsonDocument::Indented);
+
+    /**
+     * @brief Writes the entire tree structure to a device in the given format.
+     *
+     * Walks the tree the same way as the JSON overload, through `CborDocumentWriter`
+     * or `MsgPackWriter` for the binary formats. Containers are written with
+     * their sizes up front, integers in their smallest encoding and doubles as
+     * 64-bit floats, so loading the output gives back the same tree.
+     *
+     * @param device The device to write to, must be open for writing.
+     * @param documentFormat JSON, CBOR or MessagePack.
+     * @param format Indented or compact output, only used for JSON.
+     * @return False if the device refused any of the data.
+     */
+    bool writeTree(QIODevice *device, DocumentFormat::Format documentFormat,
+                   QJsonDocument::JsonFormat format = QJsonDocument::Indented);
+
     /**
      * @brief Saves the tree structure to a JSON file at the specified file path.
      *
-     * This function serializes the entire tree structure starting from the root node and saves it as a JSON file
-     * at the specified file path. The tree is serialized into a `QJsonDocument` and written to the file.
+     * This function streams the entire tree structure starting from the root node into the file
+     * with `writeTree()`, without building a `QJsonDocument` in memory. The model's own file is
+     * written in `documentFormat()` and `compression()`, so a CBOR or MessagePack file stays
+     * one and a compressed file stays compressed; any other path gets the format and compression
+     * its name says (see `DocumentFormat::fromFileName()`), e.g. `backup.json.zst`.
      *
      * @param filePath The path of the file where the tree structure will be saved. The path should include the file name and extension (e.g., "path/to/file.json").
+     * @param format Indented (the default) or compact output, for JSON files.
      *
      * @return void
      *
-     * @note If the file at the given path does not exist, it will be created. If the file already exists, it will be overwritten.
+     * @note If the file at the given path does not exist, it will be created. If the file already exists, it will be
+     *       replaced atomically (temporary file and rename).
+     * @note Read-only models (JSON Lines files) are not saved.
+     */
+    void saveToJsonFile(const QString& filePath, QJsonDocument::JsonFormat format = QJsonDocument::Indented);
+
+    /**
+     * @brief Returns an immutable version of the tree for readers on other threads.
+     *
+     * The version can be traversed, queried with `TreeVersion::valueAt()` and written
+     * with `TreeVersion::write()` on any thread while the model is edited, without locks.
+     *
+     * Versions share the frozen copies of unchanged nodes. Nothing is copied before the
+     * first call, which freezes the whole tree, O(nodes). The copies cost
+     * `memoryStats()["frozenNodeSize"]` per node for as long as a version holds them,
+     * and are freed with the last version. While one is held, an edit drops the copies
+     * on the path from the edited node to the root, so a call copies only the paths
+     * edited since, and is O(1) without edits in between; keep the previous version to
+     * get that. Children that were never built stay the JSON value or snapshot record
+     * backing them.
+     *
+     * @return The current version, a null version for JSON Lines files, whose records
+     *         would all have to be parsed, and while the tree is loading or after the
+     *         load was cancelled, as the tree shown then is not the document. A null
+     *         version has nothing to save.
      */
-    void saveToJsonFile(const QString& filePath);
+    TreeVersion snapshot();
 
     /**
      * @brief Sets the data for a given index in the tree model.
@@ -191,77 +582,296 @@ public:
      * with editing the value of the item at the given index.
      *
      * The data update triggers a `dataChanged` signal to notify any views that the data
-     * has been updated. Additionally, it saves the updated model state to a JSON file
-     * by calling the `saveToJsonFile` function.
+     * has been updated. Additionally, the edit is persisted according to `persistenceMode`:
+     * either the model is marked dirty and the write-behind saver writes the JSON file once
+     * `saveDelay` has passed, or the edit is appended to the journal. Inside
+     * `beginBatch()`/`commitBatch()` both happen once for the whole batch.
      *
      * @param index The model index that identifies the item to modify.
      * @param value The new value to set at the specified index.
      * @param role The role for the data. This parameter is unused, but it is typically
      *             provided for compatibility with the Qt framework.
      *
-     * @return `true` if the data was successfully set, `false` if the index is invalid.
+     * @return `true` if the data was successfully set, `false` if the index is invalid, points
+     *         to an object or array, or the model is loading or read-only.
      *
      * @note The `role` parameter is not used in this implementation as we are directly
      *       modifying the value at the given index. The `Qt::EditRole` is emitted by the
      *       `dataChanged` signal for compatibility with Qt's model/view framework.
      *
-     * @see saveToJsonFile
+     * @see flush
      */
     bool setData(const QModelIndex &index, const QVariant &value, int role) override;
 
-private:
+    /**
+     * @brief Sets many leaf values in one pass.
+     *
+     * Each update is a map with the new `value` and either the `path` of the
+     * node or its `index` in this model (indexes of the filter proxy have to be
+     * mapped to the source first). All updates are validated before anything
+     * changes, so an invalid one leaves the whole tree untouched. The changes
+     * are announced with one `dataChanged` per run of adjacent rows and
+     * persisted once, see `beginBatch()`.
+     *
+     * @param updates The updates, e.g. `[{path: "/config/name", value: "x"}]`.
+     * @return True if all values were set, false if nothing was changed.
+     */
+    Q_INVOKABLE bool setValues(const QVariantList &updates);
+
+    /**
+     * @brief Starts collecting edits instead of announcing and persisting each one.
+     *
+     * Until the matching `commitBatch()`, `setData()` only changes the values.
+     * Batches nest, only the outermost commit takes effect.
+     */
+    Q_INVOKABLE void beginBatch();
+
+    /**
+     * @brief Announces and persists the edits collected since `beginBatch()`.
+     *
+     * `dataChanged` is emitted once per run of adjacent rows of the same parent.
+     * The edits are then appended to the journal in a single write, or the
+     * document is marked dirty once for the write-behind saver.
+     */
+    Q_INVOKABLE void commitBatch();
+
+    /**
+     * @brief Inserts empty leaves under an object or array.
+     *
+     * Elements of an array are unnamed, members of an object are named
+     * `newMember`, `newMember1` and so on. All rows are announced with a single
+     * begin/endInsertRows pair. Structural edits cannot be journaled, so the
+     * whole document is written in the background, in both persistence modes.
+     *
+     * @param row The row to insert at.
+     * @param count The number of leaves to insert.
+     * @param parent The object or array to insert into.
+     * @return True if the rows were inserted.
+     */
+    bool insertRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
+
+    /**
+     * @brief Removes a range of rows and everything below them.
+     *
+     * @param row The first row to remove.
+     * @param count The number of rows to remove.
+     * @param parent The parent of the rows.
+     * @return True if the rows were removed.
+     */
+    bool removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
 
     /**
-     * @brief Recursively traverses a JSON object and creates a tree structure of TreeNode objects.
+     * @brief Moves a range of rows, within their parent or to another one of the same type.
      *
-     * This function takes a JSON object and recursively traverses its contents to build
-     * a tree of `TreeNode` objects, starting from the given `rootNode`. It handles various
-     * data types in the JSON object, including strings, booleans, doubles, arrays, objects,
-     * and null values. The resulting tree structure is represented by `TreeNode` objects
-     * where each `TreeNode` corresponds to a key-value pair from the JSON object.
+     * A member cannot be moved into an object that already has a member of the
+     * same name, and no node can be moved below itself.
      *
-     * The function processes each JSON element based on its type:
-     * - Strings are stored as values in the tree.
-     * - Booleans are stored as values in the tree.
-     * - Doubles are stored as values in the tree.
-     * - Arrays are represented as parent nodes with their elements recursively added as children.
-     * - Objects are represented as parent nodes with their key-value pairs added recursively as child nodes.
-     * - Null values are represented by a `TreeNode` with an empty string value.
+     * @param sourceParent The current parent of the rows.
+     * @param sourceRow The first row to move.
+     * @param count The number of rows to move.
+     * @param destinationParent The new parent.
+     * @param destinationChild The row the first moved row is placed before.
+     * @return True if the rows were moved.
+     */
+    bool moveRows(const QModelIndex &sourceParent, int sourceRow, int count,
+                  const QModelIndex &destinationParent, int destinationChild) override;
+
+    /**
+     * @brief Inserts many elements into the array at the given path in one pass.
+     *
+     * Nested maps and lists become objects and arrays. Inserting any number of
+     * elements emits a single begin/endInsertRows pair and one save.
      *
-     * The function will output a warning if an "undefined" type is encountered in the JSON object.
+     * @param path The JSON Pointer path of the array.
+     * @param row The row to insert at, -1 to append.
+     * @param values The elements to insert.
+     * @return True if the elements were inserted.
+     */
+    Q_INVOKABLE bool insertValues(const QString &path, int row, const QVariantList &values);
+
+    /**
+     * @brief Appends many members to the object at the given path in one pass.
      *
-     * @param rootNode The root node of the tree to which new nodes will be appended.
-     * @param jsonObj The JSON object to be traversed.
+     * Nothing is inserted if any of the names already exists in the object.
      *
-     * @note This function assumes that the `TreeNode` class can handle different data types
-     *       (e.g., string, bool, double) and supports hierarchical relationships between nodes.
+     * @param path The JSON Pointer path of the object.
+     * @param members The members to append, by name.
+     * @return True if the members were inserted.
+     */
+    Q_INVOKABLE bool insertMembers(const QString &path, const QVariantMap &members);
+
+    /**
+     * @brief Removes the nodes at the given paths in one pass.
+     *
+     * All paths are resolved against the tree before anything is removed, so
+     * array indexes refer to the tree as it was. Adjacent rows of the same
+     * parent are removed with a single begin/endRemoveRows pair, and the
+     * document is saved once.
+     *
+     * @param paths The JSON Pointer paths of the nodes to remove.
+     * @return The number of removed nodes, not counting their descendants.
+     */
+    Q_INVOKABLE int removePaths(const QStringList &paths);
+
+    /**
+     * @brief Returns a report of the memory used by the tree.
      *
-     * @warning Undefined types in the JSON object are logged as warnings.
+     * The map contains:
+     * - `nodes`: the number of live nodes.
+     * - `nodeBytes`: the bytes reserved for nodes by the arena.
+     * - `nodeSize`: the size of one node, including its scalar value.
+     * - `stringValueBytes`: the bytes reserved for the slots of string values,
+     *   not counting their characters.
+     * - `aggregateBytes`: the bytes reserved for the aggregates blocks, 0 without
+     *   `LoadMode::Aggregates`.
+     * - `uniqueNames`: the number of distinct node names.
+     * - `nameLookups`: the number of names that went through the name pool.
+     * - `nameBytes`: the bytes used by the pooled names.
+     * - `nameBytesSaved`: the bytes per-node copies of the names would have used on top.
+     * - `searchIndexNodes`: the number of nodes in the search index, 0 until the first
+     *   `findNodes()`.
+     * - `pathIndexNodes`: the number of nodes in the path index, 0 until the first
+     *   `indexForPath()`.
+     * - `frozenNodes`: the number of nodes frozen for `snapshot()`, 0 until the first call.
+     * - `frozenNodeSize`: the size of a frozen copy, not counting its control block
+     *   and the pointer to it in its parent.
      *
-     * @see TreeNode
-     * */
-    void traverseJsonObject(TreeNode* rootNode, QJsonObject &jsonObj);
+     * @return The memory report.
+     */
+    Q_INVOKABLE QVariantMap memoryStats() const;
 
     /**
-     * @brief Recursively traverses a JSON array and processes its elements.
+     * @brief Returns the nodes whose name or value contains the given text.
      *
-     * This function iterates over each element in a given `QJsonArray`. Depending on the type of each
-     * element, it either calls another function to handle nested objects or creates new `TreeNode` objects
-     * to represent non-object values (such as strings, numbers, booleans, etc.) and appends them as children
-     * of the provided `TreeNode` object.
+     * Looked up in the search index. The index is built by the first call, e.g.
+     * the first filter text of a `TreeFilterProxyModel`, in O(nodes), and kept up
+     * to date by the edits and fetches from then on; a model that is never
+     * searched never builds it. In lazy mode, only nodes that have been built are
+     * found.
      *
-     * @param obj The parent `TreeNode` to which new nodes will be appended. The new nodes represent the
-     *            elements of the JSON array.
-     * @param jsonArray The `QJsonArray` to be traversed. It contains various elements that can be objects,
-     *                  arrays, or basic types.
+     * @param text The text to search for, matched case-insensitively.
+     * @return The matching nodes in tree order.
+     */
+    QVector<const TreeNode *> findNodes(const QString &text);
+
+    /**
+     * @brief Returns the index of the node at the given JSON Pointer path.
      *
-     * @note The function currently does not handle nested arrays (`value.isArray()` case). The code for
-     *       handling nested arrays needs to be implemented.
+     * Looked up in the path index, which the first call builds in O(nodes) and
+     * the edits and fetches keep up to date from then on, so this is a single
+     * hash lookup for built nodes. Of several members with the same name, the
+     * first one is found, like `JsonPointer::resolve()` does. A path that
+     * leads into children which are not built yet (lazy mode) is resolved level
+     * by level, fetching the pending children on the way.
      *
-     * @see TreeNode
-     * @see traverseJsonObject
+     * @param path The path, e.g. `/config/options/option3/2`; empty for the root.
+     * @return The index, invalid for the root and for paths that do not resolve.
      */
-    void traverseJsonArray(TreeNode* rootNode, QJsonArray &jsonArray);
+    Q_INVOKABLE QModelIndex indexForPath(const QString &path);
+
+    /**
+     * @brief Returns the JSON Pointer path of the node at the given index.
+     *
+     * @param index The model index.
+     * @return The path, empty for an invalid index (the root).
+     */
+    Q_INVOKABLE QString pathForIndex(const QModelIndex &index) const;
+
+    /**
+     * @brief Returns the value at the given JSON Pointer path.
+     *
+     * Objects and arrays are returned as QVariantMap/QVariantList.
+     *
+     * @param path The path.
+     * @return The value, invalid if the path does not resolve.
+     */
+    Q_INVOKABLE QVariant valueAt(const QString &path);
+
+    /**
+     * @brief Returns the node referenced by a valid index of this model.
+     *
+     * @param index The model index.
+     */
+    inline const TreeNode *nodeAt(const QModelIndex &index) const { return nodeForIndex(index); }
+
+    /**
+     * @brief Returns the index of a node of this model, the invalid index for the root.
+     *
+     * @param node A node of this model's tree.
+     */
+    inline QModelIndex indexOf(const TreeNode *node) const {
+        return node == _rootNode ? QModelIndex() : createIndex(node->row(), 0, node);
+    }
+
+public slots:
+    /**
+     * @brief Cancels a running background load.
+     *
+     * The worker stops at the next check point and discards what it has built;
+     * the model stays empty and refuses edits, as there is no document to
+     * apply them to. Does nothing if no load is running.
+     */
+    void cancelLoading();
+
+    /**
+     * @brief Starts writing pending edits right away instead of waiting for `saveDelay`.
+     *
+     * Does nothing for read-only models, which have no edits to write.
+     */
+    void flush();
+
+signals:
+    /**
+     * @brief Emitted when the `loading` property changes.
+     */
+    void loadingChanged();
+
+    /**
+     * @brief Emitted when the `progress` property changes.
+     */
+    void progressChanged();
+
+    /**
+     * @brief Emitted when the `dirty` property changes.
+     */
+    void dirtyChanged();
+
+    /**
+     * @brief Emitted when the `saving` property changes.
+     */
+    void savingChanged();
+
+    /**
+     * @brief Emitted when the `saveDelay` property changes.
+     */
+    void saveDelayChanged();
+
+    /**
+     * @brief Emitted when the `persistenceMode` property changes.
+     */
+    void persistenceModeChanged();
+
+    /**
+     * @brief Emitted when the `journalThreshold` property changes.
+     */
+    void journalThresholdChanged();
+
+    /**
+     * @brief Emitted when the `compressionLevel` property changes.
+     */
+    void compressionLevelChanged();
+
+    /**
+     * @brief Emitted when the `stats` property changes.
+     */
+    void statsChanged();
+
+    /**
+     * @brief Emitted when the `watchFile` property changes.
+     */
+    void watchFileChanged();
+
+private:
 
     /**
      * @brief Sets up the tree model data from a JSON file.
@@ -276,19 +886,369 @@ private:
      * with default values is returned. Otherwise, the function processes the JSON file
      * and builds a hierarchical structure of `TreeNode` objects.
      *
+     * The actual reading and traversal is done by `TreeLoader`; this function runs
+     * it synchronously on the calling thread.
+     *
      * @return A pointer to the root `TreeNode` representing the top-level structure of
      *         the parsed JSON data.
      *
      * @note The `_jsonFile` member variable is expected to contain the path to a valid
      *       JSON file.
      *
-     * @see traverseJson
+     * @see TreeLoader
      */
     TreeNode* setupJsonModelData();
 
+    /**
+     * @brief Starts loading `_jsonFile` on a worker thread.
+     *
+     * The model stays empty while the worker builds the tree; once it is done,
+     * `onLoadFinished()` swaps the new tree in with a model reset.
+     */
+    void startAsyncLoad();
+
+    /**
+     * @brief Swaps the tree built by the worker thread into the model.
+     *
+     * Called on the GUI thread when the load future finishes. A cancelled load
+     * leaves the (empty) current tree in place.
+     */
+    void onLoadFinished();
+
+    /**
+     * @brief Records the phase timings of the finished load in the stats.
+     */
+    void recordLoadPhases();
+
+    /**
+     * @brief Starts parsing the changed JSON file on a worker thread.
+     *
+     * Does nothing if the file is gone or unchanged since it was last loaded or
+     * saved. While a load or another reload is running, the reload is retried
+     * once that is done.
+     */
+    void startReload();
+
+    /**
+     * @brief Merges the tree parsed by `startReload()` into the model.
+     *
+     * Called on the GUI thread when the reload future finishes. A file that
+     * could not be parsed leaves the current tree in place.
+     */
+    void onReloadFinished();
+
+    /**
+     * @brief Updates a container to match its counterpart in the reloaded tree.
+     *
+     * @param oldNode The object, array or root of the current tree.
+     * @param newNode The node of the same type in the reloaded tree.
+     */
+    void diffNode(TreeNode *oldNode, TreeNode *newNode);
+
+    /**
+     * @brief Updates the child at the given row to match a node of the reloaded tree.
+     *
+     * @param parentNode The parent in the current tree.
+     * @param row The row of the child.
+     * @param newNode The node the child is to match.
+     */
+    void diffChild(TreeNode *parentNode, int row, TreeNode *newNode);
+
+    /**
+     * @brief Removes a range of children and drops them from the indexes.
+     *
+     * @param parentNode The parent node.
+     * @param first The first row to remove.
+     * @param last The last row to remove.
+     */
+    void removeChildRows(TreeNode *parentNode, int first, int last);
+
+    /**
+     * @brief Inserts copies of a range of children of a reloaded node.
+     *
+     * @param parentNode The parent in the current tree.
+     * @param row The row to insert at.
+     * @param sourceNode The parent in the reloaded tree.
+     * @param first The first child of `sourceNode` to copy.
+     * @param last The last child of `sourceNode` to copy.
+     */
+    void insertChildRows(TreeNode *parentNode, int row, const TreeNode *sourceNode, int first, int last);
+
+    /**
+     * @brief Changes a leaf value as part of the open batch.
+     *
+     * @param node The leaf node.
+     * @param value The new value.
+     */
+    void applyValue(TreeNode *node, const QVariant &value);
+
+    /**
+     * @brief Inserts detached nodes under a parent and adds them to the indexes.
+     *
+     * Refused while loading and after a cancelled load, when the tree is only a
+     * placeholder; the nodes are released then.
+     *
+     * @param parentNode The parent node.
+     * @param row The row to insert at.
+     * @param nodes The nodes, all rows are announced with one begin/endInsertRows pair.
+     * @return True if the nodes were inserted.
+     */
+    bool insertNodes(TreeNode *parentNode, int row, const QList<TreeNode *> &nodes);
+
+    /**
+     * @brief Builds detached nodes from the members or elements of a JSON value.
+     *
+     * The nodes are created in the model's arena, which owns the tree they go into.
+     *
+     * @param value An object or array.
+     * @return The new nodes, in order.
+     */
+    QList<TreeNode *> buildNodes(const QJsonValue &value);
+
+    /**
+     * @brief Returns the node at a JSON Pointer path, building pending children on the way.
+     *
+     * @param path The path, empty for the root.
+     * @return The node, or nullptr if the path does not resolve.
+     */
+    TreeNode *nodeForPath(const QString &path);
+
+    /**
+     * @brief Builds the pending children of a node so that rows can be inserted next to them.
+     *
+     * @param node The node.
+     */
+    void fetchAllChildren(TreeNode *node);
+
+    /**
+     * @brief Persists a structural edit by writing the whole document.
+     *
+     * The journal only holds value replacements, so it is folded into the
+     * write as well.
+     */
+    void persistStructure();
+
+    /**
+     * @brief Moves a child to an earlier row.
+     *
+     * @param parentNode The parent node.
+     * @param from The current row of the child.
+     * @param to The new row, lower than `from`.
+     */
+    void moveChildRow(TreeNode *parentNode, int from, int to);
+
+    /**
+     * @brief Copies a subtree of the reloaded tree into the model's arena.
+     *
+     * Pending children and hashes are carried over.
+     *
+     * @param sourceNode The root of the subtree to copy.
+     * @param parentNode The parent the copy is created for.
+     * @return The copy.
+     */
+    TreeNode *cloneSubtree(const TreeNode *sourceNode, TreeNode *parentNode);
+
+    /**
+     * @brief Drops a detached subtree from the indexes, the hashes and the loader.
+     *
+     * @param node The root of the subtree.
+     */
+    void forgetSubtree(TreeNode *node);
+
+    /**
+     * @brief Applies the journaled edits to a freshly loaded tree.
+     *
+     * Runs before the tree is shown, so no signals are emitted. Pending children
+     * along the journaled paths are built as needed.
+     *
+     * @param rootNode The root of the loaded tree.
+     */
+    void replayJournal(TreeNode *rootNode);
+
+    /**
+     * @brief Takes the version of the tree the saver writes, see `snapshot()`.
+     *
+     * Rotates the journal once the version is taken, as it covers every edit journaled
+     * so far. A null version (see `snapshot()`) leaves the journal alone.
+     *
+     * @return Writes the version in the file's format and compression, called on the
+     *         saver's worker thread; empty if there is nothing to save.
+     */
+    TreeSaver::WriteFunction saveSnapshot();
+
+    /**
+     * @brief Writes the tree in a format and compression, as a file holding it would.
+     *
+     * @param device The device to write to, must be open for writing.
+     * @param documentFormat JSON, CBOR or MessagePack.
+     * @param compression The compression, applied at `compressionLevel()`.
+     * @param format Indented or compact output, only used for JSON.
+     * @return False if compressing failed or the device refused any of the data.
+     */
+    bool writeDocument(QIODevice *device, DocumentFormat::Format documentFormat,
+                       DocumentFormat::Compression compression, QJsonDocument::JsonFormat format);
+
+    /**
+     * @brief Runs a write through a compressing device, or straight to the device if uncompressed.
+     *
+     * Uses nothing of the model, so that the saver's worker can call it.
+     *
+     * @param device The device to write to, must be open for writing.
+     * @param compression The compression.
+     * @param level The compression level, -1 for the codec's default.
+     * @param write Writes the uncompressed document.
+     * @return False if compressing failed or the device refused any of the data.
+     */
+    static bool writeCompressed(QIODevice *device, DocumentFormat::Compression compression, int level,
+                                const TreeSaver::WriteFunction &write);
+
+    /**
+     * @brief Returns the JSON value a node's unbuilt children are aggregated from, see `LoadMode::Aggregates`.
+     *
+     * Uses nothing of the model, so that the loading worker can call it. The
+     * records of a JSON Lines file would all have to be parsed, so they are
+     * only counted once built.
+     *
+     * @param loader The loader that built the node.
+     * @param node The node.
+     * @return The pending value, undefined if the children are built or counted once built.
+     */
+    static QJsonValue aggregatedPending(const TreeLoader &loader, const TreeNode *node);
+
+    /**
+     * @brief Serializes a node, taking the JSON value of unbuilt children from the given function.
+     *
+     * Uses nothing of the model, so that it also serializes the nodes of a reloaded
+     * tree, whose unbuilt children belong to `_reloadLoader`.
+     *
+     * @param node The root node of the tree to be serialized.
+     * @param pendingValue Returns the JSON value backing a node's unbuilt children,
+     *                     or an undefined value if the node has none.
+     * @return The serialized value, see `serializeTree(TreeNode*)`.
+     */
+    static QJsonValue serializeTree(const TreeNode *node, const std::function<QJsonValue(const TreeNode *)> &pendingValue);
+
+    /**
+     * @brief Starts writing the whole document and folding the journal into it.
+     *
+     * Does nothing unless the tree is editable, see `isEditable()`.
+     */
+    void compactJournal();
+
+    /**
+     * @brief Schedules a write-behind save of the document.
+     *
+     * Does nothing unless the tree is editable, see `isEditable()`.
+     */
+    void markDirty();
+
+    /**
+     * @brief Builds the pending children of a node and adds them to the indexes built so far.
+     *
+     * @param node The node with pending children.
+     */
+    void fetchPendingChildren(TreeNode *node);
+
+    /**
+     * @brief Removes the children of the least recently used JSON Lines records beyond `recordCacheSize()`.
+     */
+    void unloadRecords();
+
+    /**
+     * @brief Announces the changed aggregate columns of a node and its ancestors.
+     *
+     * Does nothing unless aggregates are maintained.
+     *
+     * @param node The lowest node whose aggregates changed.
+     */
+    void emitAggregatesChanged(TreeNode *node);
+
+    /**
+     * @brief Returns the JSON Pointer path of a node, empty for the root.
+     *
+     * @param node The node.
+     */
+    QString pathForNode(const TreeNode *node) const;
+
+    /**
+     * @brief Returns the index of a node, or an invalid index for the root node.
+     *
+     * @param node The node.
+     */
+    QModelIndex indexForNode(TreeNode *node) const;
+
+    /**
+     * @brief Returns the node referenced by the index, or the root node for an invalid index.
+     *
+     * @param index The model index.
+     */
+    TreeNode *nodeForIndex(const QModelIndex &index) const;
+
+    /**
+     * @brief Returns true if the tree can be edited: it is loaded, the load was
+     * not cancelled, and the model is not read-only.
+     */
+    inline bool isEditable() const { return !_loading && !_loadCanceled && !isReadOnly(); }
+
+    /**
+     * @brief Updates the load progress and notifies QML about the change.
+     *
+     * @param progress The progress in percent.
+     */
+    void setProgress(int progress);
+
+    /**
+     * @brief Updates the loading state and notifies QML about the change.
+     *
+     * @param loading True while a background load is running.
+     */
+    void setLoading(bool loading);
+
 private:
+    QSharedPointer<TreeNodeArena> _arena;
     TreeNode *_rootNode;
     QString _jsonFile;
+
+    QSharedPointer<TreeLoader> _loader;
+    QFutureWatcher<TreeNode *> _loadWatcher;
+    QSharedPointer<TreeSearchIndex> _searchIndex;       // null until the first findNodes()
+    QSharedPointer<TreePathIndex> _pathIndex;           // null until the first indexForPath()
+    TreeHash::Table _hashes;
+    QSharedPointer<TreeHash::Table> _loadingHashes;
+    TreeVersion::Table _versions;                       // frozen nodes shared by the versions, see snapshot()
+    bool _loading;
+    bool _loadCanceled;                                 // the tree is the empty placeholder for good
+    int _progress;
+
+    mutable TreeStats _stats;
+    QTimer _statsTimer;
+    QElapsedTimer _loadTimer;
+    QElapsedTimer _saveTimer;
+
+    TreeSaver _saver;
+    TreeJournal _journal;
+    PersistenceMode _persistenceMode;
+    qint64 _journalThreshold;
+    int _compressionLevel;
+
+    bool _watchFile;
+    bool _aggregates;                                   // see LoadMode::Aggregates
+    QFileSystemWatcher _watcher;
+    QTimer _watchTimer;
+    TreeSnapshot::SourceKey _fileKey;   // the version of the file the tree matches
+    QFutureWatcher<TreeNode *> _reloadWatcher;
+    QSharedPointer<TreeLoader> _reloadLoader;
+    QSharedPointer<TreeHash::Table> _reloadHashes;
+    TreeSnapshot::SourceKey _reloadKey;
+    QElapsedTimer _reloadTimer;
+    bool _reloadPending;
+
+    int _batchDepth;
+    QSet<TreeNode *> _batchNodes;                     // edited in the open batch
+    QVector<TreeJournal::Operation> _batchOperations; // journaled when the batch is committed
+    bool _batchDirty;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(TreeModel::LoadModes)
+
 #endif // __TREE_MODEL_H__
@@ -29,23 +29,120 @@
  *                                                                             *
  ******************************************************************************/
 
+#include <algorithm>
 #include "TreeNode.h"
 
-TreeNode::TreeNode(const QString &name, const QVariant &value, TreeNode *parent)
+TreeNode::TreeNode(const QString &name, TreeNode *parent)
     : _name{name},
-      _value{value},
-      _parentNode{parent} {}
+      _value{},
+      _parentNode{parent},
+      _aggregates{nullptr},
+      _row{0},
+      _type{Value},
+      _valueKind{NullValue} {}
 
-TreeNode::~TreeNode()
+QVariant TreeNode::value() const
 {
-    qDeleteAll(_children);
+    switch (_valueKind) {
+    case BoolValue:
+        return QVariant(_value.boolean);
+    case IntegerValue:
+        return QVariant(qlonglong(_value.integer));
+    case DoubleValue:
+        return QVariant(_value.number);
+    case StringValue:
+        return QVariant(*_value.string);
+    case NullValue:
+        break;
+    }
+    return QVariant(QString());
+}
+
+QJsonValue TreeNode::jsonValue() const
+{
+    switch (_valueKind) {
+    case BoolValue:
+        return QJsonValue(_value.boolean);
+    case IntegerValue:
+        return QJsonValue(_value.integer);
+    case DoubleValue:
+        return QJsonValue(_value.number);
+    case StringValue:
+        return QJsonValue(*_value.string);
+    case NullValue:
+        break;
+    }
+    return QJsonValue(QJsonValue::Null);
+}
+
+const QString &TreeNode::stringValue() const
+{
+    static const QString empty;
+    return _valueKind == StringValue ? *_value.string : empty;
 }
 
 void TreeNode::appendChild(TreeNode *child)
 {
+    child->_parentNode = this;
+    child->_row = _children.count();
     _children.append(child);
 }
 
+void TreeNode::insertChild(int row, TreeNode *child)
+{
+    row = qBound(0, row, _children.count());
+    child->_parentNode = this;
+    _children.insert(row, child);
+    renumberChildren(row);
+}
+
+TreeNode *TreeNode::takeChild(int row)
+{
+    if (row < 0 || row >= _children.count()) {
+        return nullptr;
+    }
+
+    TreeNode *child = _children.takeAt(row);
+    child->_parentNode = nullptr;
+    child->_row = 0;
+    renumberChildren(row);
+    return child;
+}
+
+void TreeNode::insertChildren(int row, const QList<TreeNode *> &children)
+{
+    row = qBound(0, row, _children.count());
+    for (TreeNode *child : children) {
+        child->_parentNode = this;
+    }
+    _children.insert(row, children.count(), nullptr);
+    std::copy(children.constBegin(), children.constEnd(), _children.begin() + row);
+    renumberChildren(row);
+}
+
+QList<TreeNode *> TreeNode::takeChildren(int row, int count)
+{
+    if (row < 0 || count <= 0 || row + count > _children.count()) {
+        return QList<TreeNode *>();
+    }
+
+    const QList<TreeNode *> children = _children.mid(row, count);
+    _children.remove(row, count);
+    for (TreeNode *child : children) {
+        child->_parentNode = nullptr;
+        child->_row = 0;
+    }
+    renumberChildren(row);
+    return children;
+}
+
+void TreeNode::renumberChildren(int from)
+{
+    for (int i = from; i < _children.count(); ++i) {
+        _children.at(i)->_row = i;
+    }
+}
+
 TreeNode *TreeNode::child(int row)
 {
     if (row < 0 || row >= _children.count()) {
@@ -61,23 +158,58 @@ int TreeNode::childCount() const
 
 int TreeNode::columnCount() const
 {
-    // Note - we are having 1 column at the moment,
-    // for more columns, we will return name.length() in future, if needed.
-    return 1;
+    // the tree itself plus the cached aggregates
+    return ColumnCount;
 }
 
 QVariant TreeNode::data(int column) const
 {
-    if (column != 1) {
+    switch (column) {
+    case NameColumn:
+        return _name;
+    case DescendantCountColumn:
+        return descendantCount();
+    case JsonSizeColumn:
+        return jsonSize();
+    case TypeColumn:
+        return typeName();
+    default:
         return QVariant();
     }
-    return _name.at(column);
 }
 
-int TreeNode::row() const
+QString TreeNode::typeName() const
 {
-    if (_parentNode) {
-        return _parentNode->children().indexOf(const_cast<TreeNode *>(this));
+    if (_type != Value) {
+        QString name = _type == Object ? QStringLiteral("object") : QStringLiteral("array");
+        QString separator = QStringLiteral(" of ");
+        const LeafCounts leaves = leafCounts();
+        for (int kind = NullValue; kind <= StringValue; ++kind) {
+            if (leaves[kind] == 0) {
+                continue;
+            }
+            name += separator + kindName(ValueKind(kind));
+            separator = QStringLiteral(", ");
+        }
+        return name;
     }
-    return 0;
+    return kindName(_valueKind);
 }
+
+QString TreeNode::kindName(ValueKind kind)
+{
+    switch (kind) {
+    case BoolValue:
+        return QStringLiteral("bool");
+    case IntegerValue:
+        return QStringLiteral("integer");
+    case DoubleValue:
+        return QStringLiteral("double");
+    case StringValue:
+        return QStringLiteral("string");
+    case NullValue:
+        break;
+    }
+    return QStringLiteral("null");
+}
+
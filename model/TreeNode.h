@@ -32,37 +32,153 @@
 #ifndef __TREE_NODE_H__
 #define __TREE_NODE_H__
 
+#include <array>
 #include <QVariant>
 #include <QString>
 #include <QList>
+#include <QJsonValue>
 
 class TreeNode
 {
 public:
     /**
-     * @brief Constructs a TreeNode with given data and optional parent node.
+     * @brief Enum for the kind of JSON value a node represents.
+     *
+     * - Value: a scalar (string, number, bool or null) stored in `value()`.
+     * - Object: a JSON object, its members are the named children.
+     * - Array: a JSON array, its elements are the unnamed children.
+     */
+    enum Type : quint8 {
+        Value,
+        Object,
+        Array
+    };
+
+    /**
+     * @brief Enum for the JSON type of the value a node holds.
+     *
+     * The value is stored in a tagged 8-byte payload rather than a QVariant.
+     * Strings live in slots of the owning `TreeNodeArena`, the payload only
+     * points to them. Objects and arrays hold no value (`NullValue`).
+     */
+    enum ValueKind : quint8 {
+        NullValue,
+        BoolValue,
+        IntegerValue,
+        DoubleValue,
+        StringValue
+    };
+
+    /**
+     * @brief The number of leaves of each `ValueKind` below a node, indexed by kind.
+     */
+    using LeafCounts = std::array<quint32, StringValue + 1>;
+
+    /**
+     * @brief The aggregates cached for a node, see `TreeAggregates`.
+     *
+     * Kept in a block of the owning `TreeNodeArena`, which is only allocated
+     * once the model maintains aggregates; the node just points to it.
+     */
+    struct Aggregates {
+        qint64 jsonSize = 0;
+        LeafCounts leafCounts{};
+        int descendantCount = 0;
+    };
+
+    /**
+     * @brief Enum for the columns of a node.
+     *
+     * - NameColumn: the node itself, shown as the tree.
+     * - DescendantCountColumn: the number of nodes below the node.
+     * - JsonSizeColumn: the size in bytes of the node's value written as compact JSON.
+     * - TypeColumn: the JSON type of the node, and for objects and arrays the
+     *   types of the leaves below it, see `typeName()` and `leafCounts()`.
+     *
+     * The counts and sizes are cached in the node's aggregates block (see
+     * `TreeAggregates`), so every column is read in O(1).
+     */
+    enum Column {
+        NameColumn,
+        DescendantCountColumn,
+        JsonSizeColumn,
+        TypeColumn,
+        ColumnCount
+    };
+
+    /**
+     * @brief Constructs a TreeNode with given name, a null value and optional parent node.
+     *
+     * Nodes are normally created through `TreeNodeArena::create()`, which owns
+     * them and sets their value.
      *
      * @param name The name of the node.
-     * @param value The value of the node.
      * @param parentItem The parent node (defaults to nullptr for leaf nodes).
      */
-    explicit TreeNode(const QString &name, const QVariant &value, TreeNode *parentItem = nullptr);
+    explicit TreeNode(const QString &name, TreeNode *parentItem = nullptr);
 
     /**
      * @brief Destructor for the TreeNode class.
      *
-     * This ensures proper cleanup of dynamically allocated memory, including
-     * child nodes.
+     * Child nodes are not deleted here: nodes are owned by the `TreeNodeArena`
+     * they were created in, which destroys the whole tree in one pass.
+     *
+     * @see TreeNodeArena
      */
-    ~TreeNode();
+    ~TreeNode() = default;
 
     /**
      * @brief Appends a child node to the current TreeNode.
      *
+     * The child is re-parented to this node and its cached row is set to
+     * its position in the child list.
+     *
      * @param child The child node to append.
      */
     void appendChild(TreeNode *child);
 
+    /**
+     * @brief Inserts a child node at the given row.
+     *
+     * The cached rows of the inserted node and of every sibling after it are
+     * updated, so `row()` stays O(1) for all children.
+     *
+     * @param row The position to insert at (clamped to [0, childCount()]).
+     * @param child The child node to insert.
+     */
+    void insertChild(int row, TreeNode *child);
+
+    /**
+     * @brief Detaches the child node at the given row without deleting it.
+     *
+     * The cached rows of the siblings after the removed node are updated.
+     * Ownership of the returned node passes to the caller.
+     *
+     * @param row The index of the child node to detach.
+     * @return The detached child node, or nullptr if the row is out of range.
+     */
+    TreeNode *takeChild(int row);
+
+    /**
+     * @brief Inserts several child nodes at the given row in one pass.
+     *
+     * The siblings after them are renumbered once, so inserting a range costs
+     * O(childCount()) instead of O(childCount()) per node.
+     *
+     * @param row The position to insert at (clamped to [0, childCount()]).
+     * @param children The child nodes to insert, in order.
+     */
+    void insertChildren(int row, const QList<TreeNode *> &children);
+
+    /**
+     * @brief Detaches a range of child nodes without deleting them.
+     *
+     * @param row The index of the first child node to detach.
+     * @param count The number of child nodes to detach.
+     * @return The detached child nodes in order, empty if the range is out of bounds.
+     */
+    QList<TreeNode *> takeChildren(int row, int count);
+
     /**
      * @brief Returns the child node at the specified row (index).
      *
@@ -81,60 +197,137 @@ public:
     /**
      * @brief Returns the number of columns (data elements) stored in the node.
      *
-     * @return The number of columns.
+     * @return The number of columns, see `Column`.
      */
     int columnCount() const;  // Fixed typo here: `coloumnCount()` -> `columnCount()`
 
     /**
      * @brief Returns the data at the specified column for this node.
      *
-     * @param column The column index.
-     * @return The data for the node at the specified column.
+     * @param column The column index, see `Column`.
+     * @return The name, the descendant count, the JSON size or the type name,
+     *         an invalid QVariant for other columns.
      */
     QVariant data(int column) const;
 
     /**
      * @brief Returns the row (index) of this node within its parent.
      *
+     * The row is cached on the node and kept up to date by `appendChild()`,
+     * `insertChild()` and `takeChild()`, so this is O(1) regardless of how many
+     * siblings the node has.
+     *
      * @return The index of this node in its parent's child list.
      */
-    int row() const;
+    inline int row() const { return _row; }
 
     /**
      * @brief Returns a list of child nodes.
      *
+     * The list is read-only; use `appendChild()`, `insertChild()` and
+     * `takeChild()` to modify it so the cached rows stay consistent.
+     *
      * @return A list of child nodes.
      */
-    inline QList<TreeNode *>& children() { return _children; }
+    inline const QList<TreeNode *>& children() const { return _children; }
 
     /**
      * @brief Returns the name of the node.
      *
+     * Names are interned by the owning `TreeNodeArena`, so the returned string
+     * shares its data with every other node of the same name.
+     *
      * @return The name of the node.
      */
-    inline QString name() const { return _name; }
+    inline const QString &name() const { return _name; }
 
     /**
      * @brief Returns the value assciated with the name of the node.
      *
+     * The QVariant is built on every call, for the views. Integers are returned
+     * as `qlonglong`, and null values as well as objects and arrays as an empty
+     * string, which is what the TreeView shows for them. Use `jsonValue()` to
+     * tell a null from an empty string.
+     *
      * @return The value of the node.
      */
-    inline QVariant value() const { return _value; }
+    QVariant value() const;
 
     /**
-     * @brief Sets the value of the node.
+     * @brief Returns the value of the node as the JSON value it was read from.
      *
-     * This function sets the value of the current `TreeNode` to the provided `value`.
-     * The `value` can be of any type supported by `QVariant`, and it is stored in the
-     * private member variable `_value`. This method allows updating the value stored
-     * in the node.
+     * @return The value, null for objects and arrays.
+     */
+    QJsonValue jsonValue() const;
+
+    /**
+     * @brief Returns the JSON type of the value.
+     */
+    inline ValueKind valueKind() const { return _valueKind; }
+
+    /**
+     * @brief Returns the value if it is a bool, false otherwise.
+     */
+    inline bool boolValue() const { return _valueKind == BoolValue && _value.boolean; }
+
+    /**
+     * @brief Returns the value if it is an integer, 0 otherwise.
+     */
+    inline qint64 integerValue() const { return _valueKind == IntegerValue ? _value.integer : 0; }
+
+    /**
+     * @brief Returns the value if it is a number, converting integers, 0 otherwise.
+     */
+    inline double doubleValue() const {
+        return _valueKind == DoubleValue ? _value.number
+                                         : (_valueKind == IntegerValue ? double(_value.integer) : 0.0);
+    }
+
+    /**
+     * @brief Returns the value if it is a string, an empty string otherwise.
+     */
+    const QString &stringValue() const;
+
+    /**
+     * @brief Returns the number of nodes below this node, whether they are built or not.
+     *
+     * Kept up to date by `TreeAggregates`; 0 unless the model maintains aggregates.
+     */
+    inline int descendantCount() const { return _aggregates ? _aggregates->descendantCount : 0; }
+
+    /**
+     * @brief Returns the size in bytes of the node's value written as compact JSON.
+     *
+     * For objects and arrays this covers the whole subtree, brackets, keys and
+     * separators included. Kept up to date by `TreeAggregates`; 0 unless the
+     * model maintains aggregates.
+     */
+    inline qint64 jsonSize() const { return _aggregates ? _aggregates->jsonSize : 0; }
+
+    /**
+     * @brief Returns the number of leaves of each kind below the node, whether they are built or not.
+     *
+     * All zero for a leaf itself. Kept up to date by `TreeAggregates`; all zero
+     * unless the model maintains aggregates.
+     */
+    inline LeafCounts leafCounts() const { return _aggregates ? _aggregates->leafCounts : LeafCounts{}; }
+
+    /**
+     * @brief Returns the JSON type of the node: "object", "array", "string",
+     * "integer", "double", "bool" or "null".
      *
-     * @param value The value to set for the current node. It can be any type that
-     *              `QVariant` supports (e.g., int, double, QString, etc.).
+     * An object or array with leaves below it lists their kinds as well, in
+     * `ValueKind` order, e.g. "array of integer, string".
+     */
+    QString typeName() const;
+
+    /**
+     * @brief Returns the JSON type name of a kind of value: "string", "integer",
+     * "double", "bool" or "null".
      *
-     * @see QVariant
+     * @param kind The kind of value.
      */
-    inline void setValue(QVariant value) { _value = value; }
+    static QString kindName(ValueKind kind);
 
     /**
      * @brief Returns the parent node of this TreeNode.
@@ -143,11 +336,43 @@ public:
      */
     inline TreeNode *parentNode() const { return _parentNode; }
 
+    /**
+     * @brief Returns the kind of JSON value the node represents.
+     */
+    inline Type type() const { return _type; }
+
+    /**
+     * @brief Sets the kind of JSON value the node represents.
+     *
+     * @param type The node type.
+     */
+    inline void setType(Type type) { _type = type; }
+
 private:
+    friend class TreeNodeArena;
+
+    /**
+     * @brief Re-numbers the cached rows of the children starting at `from`.
+     *
+     * @param from The first child whose row needs updating.
+     */
+    void renumberChildren(int from);
+
+    union Payload {
+        bool boolean;
+        qint64 integer;
+        double number;
+        QString *string;    // a slot of the owning arena
+    };
+
     QList<TreeNode *> _children;
     QString _name;
-    QVariant _value;
+    Payload _value;
     TreeNode *_parentNode;
+    Aggregates *_aggregates;    // a block of the owning arena, null without aggregates
+    int _row;
+    Type _type;
+    ValueKind _valueKind;
 };
 
 #endif // __TREE_NODE_H__
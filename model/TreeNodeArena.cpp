@@ -0,0 +1,291 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeNodeArena.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeNodeArena class, a slab allocator that owns the   *
+ * TreeNode objects of a tree and frees them all in one pass.                  *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <new>
+#include <limits>
+#include "TreeNodeArena.h"
+
+TreeNodeArena::TreeNodeArena()
+    : _used{SLAB_NODES},
+      _freeList{nullptr},
+      _freeCount{0},
+      _stringsUsed{SLAB_STRINGS},
+      _aggregatesUsed{SLAB_AGGREGATES} {}
+
+TreeNodeArena::~TreeNodeArena()
+{
+    for (int i = 0; i < _slabs.count(); ++i) {
+        TreeNode *slab = _slabs.at(i);
+        const int count = (i == _slabs.count() - 1) ? _used : SLAB_NODES;
+
+        // released nodes are still constructed (just emptied), so every slot
+        // up to `count` is destroyed
+        for (int j = 0; j < count; ++j) {
+            slab[j].~TreeNode();
+        }
+        ::operator delete(slab);
+    }
+
+    // the nodes no longer point to the string slots, so the slabs go as a whole
+    for (QString *slab : std::as_const(_stringSlabs)) {
+        delete[] slab;
+    }
+    for (TreeNode::Aggregates *slab : std::as_const(_aggregateSlabs)) {
+        delete[] slab;
+    }
+}
+
+TreeNode *TreeNodeArena::create(const QString &name, const QVariant &value, TreeNode *parentNode)
+{
+    if (_freeList) {
+        TreeNode *node = _freeList;
+        _freeList = node->_parentNode;
+        --_freeCount;
+
+        node->_name = _names.intern(name);
+        node->_parentNode = parentNode;
+        node->_row = 0;
+        node->_type = TreeNode::Value;
+        setValue(node, value);
+        return node;
+    }
+
+    if (_used == SLAB_NODES) {
+        _slabs.append(static_cast<TreeNode *>(::operator new(SLAB_NODES * sizeof(TreeNode))));
+        _used = 0;
+    }
+
+    TreeNode *node = new (_slabs.last() + _used) TreeNode(_names.intern(name), parentNode);
+    ++_used;
+    setValue(node, value);
+    return node;
+}
+
+void TreeNodeArena::setValue(TreeNode *node, const QVariant &value)
+{
+    switch (value.userType()) {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+        clearValue(node);
+        return;
+    case QMetaType::Bool:
+        clearValue(node);
+        node->_valueKind = TreeNode::BoolValue;
+        node->_value.boolean = value.toBool();
+        return;
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::LongLong:
+    case QMetaType::Char:       // C++ char types are numbers, unlike QChar, which is text
+    case QMetaType::SChar:
+    case QMetaType::UChar:
+        clearValue(node);
+        node->_valueKind = TreeNode::IntegerValue;
+        node->_value.integer = value.toLongLong();
+        return;
+    case QMetaType::Double:
+    case QMetaType::Float:
+        clearValue(node);
+        node->_valueKind = TreeNode::DoubleValue;
+        node->_value.number = value.toDouble();
+        return;
+    case QMetaType::ULong:
+    case QMetaType::ULongLong:
+        clearValue(node);
+        if (value.toULongLong() <= quint64(std::numeric_limits<qint64>::max())) {
+            node->_valueKind = TreeNode::IntegerValue;
+            node->_value.integer = value.toLongLong();
+        } else {
+            node->_valueKind = TreeNode::DoubleValue;
+            node->_value.number = value.toDouble();
+        }
+        return;
+    default:
+        break;
+    }
+
+    if (value.userType() == QMetaType::QJsonValue) {
+        setJsonValue(node, value.value<QJsonValue>());
+        return;
+    }
+
+    // QString, and anything else (e.g. a QUrl from QML), is kept as text
+    if (node->_valueKind != TreeNode::StringValue) {
+        clearValue(node);
+        node->_value.string = allocateString();
+        node->_valueKind = TreeNode::StringValue;
+    }
+    *node->_value.string = value.toString();
+}
+
+void TreeNodeArena::setJsonValue(TreeNode *node, const QJsonValue &value)
+{
+    switch (value.type()) {
+    case QJsonValue::Bool:
+        setValue(node, QVariant(value.toBool()));
+        break;
+    case QJsonValue::Double:
+        // toVariant() tells the integers QJsonDocument read from the doubles
+        setValue(node, value.toVariant());
+        break;
+    case QJsonValue::String:
+        setValue(node, QVariant(value.toString()));
+        break;
+    default:
+        clearValue(node);
+        break;
+    }
+}
+
+void TreeNodeArena::copyValue(TreeNode *node, const TreeNode *source)
+{
+    if (source->_valueKind == TreeNode::StringValue) {
+        setValue(node, QVariant(*source->_value.string));
+        return;
+    }
+    clearValue(node);
+    node->_valueKind = source->_valueKind;
+    node->_value = source->_value;
+}
+
+TreeNode::Aggregates &TreeNodeArena::aggregates(TreeNode *node)
+{
+    if (node->_aggregates) {
+        return *node->_aggregates;
+    }
+
+    if (!_freeAggregates.isEmpty()) {
+        node->_aggregates = _freeAggregates.takeLast();
+    } else {
+        if (_aggregatesUsed == SLAB_AGGREGATES) {
+            _aggregateSlabs.append(new TreeNode::Aggregates[SLAB_AGGREGATES]);
+            _aggregatesUsed = 0;
+        }
+        node->_aggregates = _aggregateSlabs.last() + _aggregatesUsed++;
+    }
+    return *node->_aggregates;
+}
+
+QString *TreeNodeArena::allocateString()
+{
+    if (!_freeStrings.isEmpty()) {
+        return _freeStrings.takeLast();
+    }
+
+    if (_stringsUsed == SLAB_STRINGS) {
+        _stringSlabs.append(new QString[SLAB_STRINGS]);
+        _stringsUsed = 0;
+    }
+    return _stringSlabs.last() + _stringsUsed++;
+}
+
+void TreeNodeArena::clearValue(TreeNode *node)
+{
+    // a slot may come from an adopted arena; it is reused here, and freed with
+    // that arena, which lives as long as this one
+    if (node->_valueKind == TreeNode::StringValue) {
+        node->_value.string->clear();
+        _freeStrings.append(node->_value.string);
+    }
+    node->_valueKind = TreeNode::NullValue;
+    node->_value.integer = 0;
+}
+
+void TreeNodeArena::release(TreeNode *node)
+{
+    QVector<TreeNode *> pending;
+    pending.append(node);
+
+    while (!pending.isEmpty()) {
+        TreeNode *current = pending.takeLast();
+        pending.append(current->_children);
+
+        current->_children.clear();
+        current->_name.clear();
+        clearValue(current);
+        if (current->_aggregates) {
+            // like string slots, a block of an adopted arena is reused here
+            *current->_aggregates = TreeNode::Aggregates();
+            _freeAggregates.append(current->_aggregates);
+            current->_aggregates = nullptr;
+        }
+        current->_row = 0;
+
+        current->_parentNode = _freeList;
+        _freeList = current;
+        ++_freeCount;
+    }
+}
+
+void TreeNodeArena::adopt(const QSharedPointer<TreeNodeArena> &other)
+{
+    _names.merge(other->_names);
+    _adopted.append(other);
+}
+
+int TreeNodeArena::nodeCount() const
+{
+    // released nodes of adopted arenas are counted in this arena's free list
+    int count = _slabs.isEmpty() ? 0 : (_slabs.count() - 1) * SLAB_NODES + _used;
+    for (const QSharedPointer<TreeNodeArena> &arena : _adopted) {
+        count += arena->nodeCount();
+    }
+    return count - _freeCount;
+}
+
+qint64 TreeNodeArena::bytesReserved() const
+{
+    qint64 bytes = qint64(_slabs.count()) * SLAB_NODES * qint64(sizeof(TreeNode));
+    for (const QSharedPointer<TreeNodeArena> &arena : _adopted) {
+        bytes += arena->bytesReserved();
+    }
+    return bytes;
+}
+
+qint64 TreeNodeArena::stringBytesReserved() const
+{
+    qint64 bytes = qint64(_stringSlabs.count()) * SLAB_STRINGS * qint64(sizeof(QString));
+    for (const QSharedPointer<TreeNodeArena> &arena : _adopted) {
+        bytes += arena->stringBytesReserved();
+    }
+    return bytes;
+}
+
+qint64 TreeNodeArena::aggregateBytesReserved() const
+{
+    qint64 bytes = qint64(_aggregateSlabs.count()) * SLAB_AGGREGATES * qint64(sizeof(TreeNode::Aggregates));
+    for (const QSharedPointer<TreeNodeArena> &arena : _adopted) {
+        bytes += arena->aggregateBytesReserved();
+    }
+    return bytes;
+}
@@ -0,0 +1,211 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeNodeArena.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeNodeArena class, a slab allocator that owns the     *
+ * TreeNode objects of a tree. Nodes are allocated contiguously in large       *
+ * slabs, keep a stable address for their whole lifetime and are all destroyed *
+ * in one linear pass when the arena goes away.                                *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_NODE_ARENA_H__
+#define __TREE_NODE_ARENA_H__
+
+#include <QVector>
+#include <QString>
+#include <QVariant>
+#include <QJsonValue>
+#include <QSharedPointer>
+
+#include "TreeNode.h"
+#include "NamePool.h"
+
+
+class TreeNodeArena
+{
+    Q_DISABLE_COPY(TreeNodeArena)
+
+public:
+    /**
+     * @brief Number of nodes allocated together in one slab.
+     */
+    static const int SLAB_NODES = 4096;
+
+    /**
+     * @brief Number of string values allocated together in one slab.
+     */
+    static const int SLAB_STRINGS = 1024;
+
+    /**
+     * @brief Number of aggregates blocks allocated together in one slab.
+     */
+    static const int SLAB_AGGREGATES = 1024;
+
+    /**
+     * @brief Constructs an empty arena, no memory is allocated until the first node.
+     */
+    TreeNodeArena();
+
+    /**
+     * @brief Destroys every node ever created in the arena and frees the slabs.
+     *
+     * The nodes are destroyed slab by slab in a single linear pass, without
+     * walking the tree, so tearing down a large tree costs one pass over
+     * contiguous memory plus one free per slab.
+     */
+    ~TreeNodeArena();
+
+    /**
+     * @brief Creates a new node in the arena.
+     *
+     * The node's address never changes for the lifetime of the arena, so it can
+     * be used as the internal pointer of model indexes. The node is not appended
+     * to `parentNode`; use `TreeNode::appendChild()` for that.
+     *
+     * The name is interned in the arena's `NamePool`, so nodes with the same
+     * key share one copy of it. The value is stored as described for `setValue()`.
+     *
+     * @param name The name of the node.
+     * @param value The value of the node, a null QVariant for objects, arrays and JSON null.
+     * @param parentNode The parent node (defaults to nullptr for the root node).
+     * @return The new node, owned by the arena.
+     */
+    TreeNode *create(const QString &name, const QVariant &value, TreeNode *parentNode = nullptr);
+
+    /**
+     * @brief Sets the value of a node.
+     *
+     * The value is stored in the node's tagged payload: a null QVariant as JSON
+     * null, bools as bools, integral types as 64-bit integers, floating point
+     * types as doubles and a QJsonValue as described for `setJsonValue()`.
+     * Anything else is stored as its string form. Strings are kept in a slot of
+     * the arena, which the node points to.
+     *
+     * @param node The node, created by this arena or an adopted one.
+     * @param value The new value.
+     */
+    void setValue(TreeNode *node, const QVariant &value);
+
+    /**
+     * @brief Sets the value of a node from a JSON value, keeping its type.
+     *
+     * Numbers that `QJsonDocument` read as integers stay 64-bit integers, all
+     * other numbers are doubles. Objects and arrays are stored as null; their
+     * members are child nodes.
+     *
+     * @param node The node, created by this arena or an adopted one.
+     * @param value The new value.
+     */
+    void setJsonValue(TreeNode *node, const QJsonValue &value);
+
+    /**
+     * @brief Copies the value of one node to another, without converting it.
+     *
+     * @param node The node to set, created by this arena or an adopted one.
+     * @param source The node to copy the value of.
+     */
+    void copyValue(TreeNode *node, const TreeNode *source);
+
+    /**
+     * @brief Returns the aggregates block of a node, allocating it on first use.
+     *
+     * Blocks are only allocated for models that maintain aggregates (see
+     * `TreeAggregates`); without one a node reports zero aggregates. A released
+     * node gives its block back for reuse.
+     *
+     * @param node The node, created by this arena or an adopted one.
+     * @return The block, zeroed when it was just allocated.
+     */
+    TreeNode::Aggregates &aggregates(TreeNode *node);
+
+    /**
+     * @brief Returns the node and its whole subtree to the arena for reuse.
+     *
+     * The nodes must already be detached from their parent (see
+     * `TreeNode::takeChild()`). Their contents are cleared right away, the
+     * memory is reused by later calls to `create()`.
+     *
+     * @param node The root of the subtree to release.
+     */
+    void release(TreeNode *node);
+
+    /**
+     * @brief Takes over the nodes of another arena.
+     *
+     * Used to combine the subtrees built by several threads into one tree.
+     * The other arena's slabs are kept as they are and freed together with this
+     * arena, and its names are merged into this arena's pool. Nodes of the
+     * adopted arena may be linked into this arena's tree and released to it.
+     *
+     * @param other The arena to adopt; it must not be used for new nodes afterwards.
+     */
+    void adopt(const QSharedPointer<TreeNodeArena> &other);
+
+    /**
+     * @brief Returns the number of live nodes in the arena, including adopted arenas.
+     */
+    int nodeCount() const;
+
+    /**
+     * @brief Returns the number of bytes reserved by the slabs, including adopted arenas.
+     */
+    qint64 bytesReserved() const;
+
+    /**
+     * @brief Returns the number of bytes reserved by the string value slots, including adopted arenas.
+     *
+     * This counts the slots only; the characters live in the strings' shared data.
+     */
+    qint64 stringBytesReserved() const;
+
+    /**
+     * @brief Returns the number of bytes reserved by the aggregates blocks, including adopted arenas.
+     */
+    qint64 aggregateBytesReserved() const;
+
+    /**
+     * @brief Returns the pool the node names are interned in.
+     */
+    inline const NamePool &names() const { return _names; }
+
+private:
+    QString *allocateString();
+    void clearValue(TreeNode *node);
+
+    NamePool _names;
+    QVector<TreeNode *> _slabs;
+    int _used;              // nodes constructed in the last slab
+    TreeNode *_freeList;    // released nodes, linked through their parent pointer
+    int _freeCount;
+    QVector<QString *> _stringSlabs;
+    int _stringsUsed;                   // slots handed out from the last string slab
+    QVector<QString *> _freeStrings;    // released slots, cleared
+    QVector<TreeNode::Aggregates *> _aggregateSlabs;
+    int _aggregatesUsed;                            // blocks handed out from the last aggregates slab
+    QVector<TreeNode::Aggregates *> _freeAggregates;    // released blocks
+    QVector<QSharedPointer<TreeNodeArena>> _adopted;
+};
+
+#endif // __TREE_NODE_ARENA_H__
@@ -0,0 +1,170 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreePathIndex.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreePathIndex class, a hash index between JSON        *
+ * Pointer paths and the nodes of a tree.                                      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include "TreePathIndex.h"
+#include "JsonPointer.h"
+
+TreePathIndex::TreePathIndex() {}
+
+void TreePathIndex::clear()
+{
+    _nodes.clear();
+    _paths.clear();
+    _shadowed.clear();
+}
+
+void TreePathIndex::addChildren(const TreeNode *parentNode)
+{
+    QVector<QPair<TreeNode *, QString>> stack;
+    const QString parentPath = path(parentNode);
+    const QList<TreeNode *> &children = parentNode->children();
+    for (int i = children.count() - 1; i >= 0; --i) {
+        stack.append(qMakePair(children.at(i), parentPath + QStringLiteral("/") + JsonPointer::segment(children.at(i))));
+    }
+    addAll(stack);
+}
+
+void TreePathIndex::addSubtree(const TreeNode *node)
+{
+    const TreeNode *parentNode = node->parentNode();
+    QVector<QPair<TreeNode *, QString>> stack{
+        qMakePair(parentNode->children().at(node->row()),
+                  path(parentNode) + QStringLiteral("/") + JsonPointer::segment(node))};
+    addAll(stack);
+}
+
+void TreePathIndex::removeSubtree(const TreeNode *subtreeRoot)
+{
+    QStringList freed;
+    QVector<const TreeNode *> stack{subtreeRoot};
+    while (!stack.isEmpty()) {
+        const TreeNode *node = stack.takeLast();
+        const QString nodePath = _paths.take(node);
+        if (!nodePath.isEmpty() && _nodes.value(nodePath) == node) {
+            _nodes.remove(nodePath);
+            if (_shadowed.contains(nodePath)) {
+                freed.append(nodePath);
+            }
+        } else {
+            _shadowed.remove(nodePath, const_cast<TreeNode *>(node));
+        }
+        for (const TreeNode *child : node->children()) {
+            stack.append(child);
+        }
+    }
+
+    // a member of the same name that the removed one shadowed takes its path over
+    for (const QString &freedPath : freed) {
+        if (_nodes.contains(freedPath)) {
+            continue;
+        }
+        TreeNode *next = nullptr;
+        for (TreeNode *candidate : _shadowed.values(freedPath)) {
+            if (ownsParentPath(candidate) && (!next || candidate->row() < next->row())) {
+                next = candidate;
+            }
+        }
+        if (next) {
+            promote(next);
+        }
+    }
+}
+
+void TreePathIndex::reindexChildren(const TreeNode *parentNode, int firstRow)
+{
+    const QList<TreeNode *> &children = parentNode->children();
+
+    // all old paths go first, a shifted node may now have a neighbour's old path
+    for (int row = firstRow; row < children.count(); ++row) {
+        removeSubtree(children.at(row));
+    }
+
+    QVector<QPair<TreeNode *, QString>> stack;
+    const QString parentPath = path(parentNode);
+    for (int row = children.count() - 1; row >= firstRow; --row) {
+        stack.append(qMakePair(children.at(row), parentPath + QStringLiteral("/") + JsonPointer::segment(children.at(row))));
+    }
+    addAll(stack);
+}
+
+void TreePathIndex::addAll(QVector<QPair<TreeNode *, QString>> &stack)
+{
+    while (!stack.isEmpty()) {
+        const QPair<TreeNode *, QString> item = stack.takeLast();
+
+        // like JsonPointer::child(), the first of several equally named members wins,
+        // and what lies below the others cannot be reached by path either
+        if (!_nodes.contains(item.second) && ownsParentPath(item.first)) {
+            _nodes.insert(item.second, item.first);
+        } else {
+            _shadowed.insert(item.second, item.first);
+        }
+        _paths.insert(item.first, item.second);
+
+        const QList<TreeNode *> &children = item.first->children();
+        for (int i = children.count() - 1; i >= 0; --i) {
+            stack.append(qMakePair(children.at(i), item.second + QStringLiteral("/") + JsonPointer::segment(children.at(i))));
+        }
+    }
+}
+
+bool TreePathIndex::ownsParentPath(const TreeNode *node) const
+{
+    const TreeNode *parentNode = node->parentNode();
+    auto parentPath = _paths.constFind(parentNode);
+    return parentPath == _paths.constEnd() || _nodes.value(*parentPath) == parentNode;
+}
+
+void TreePathIndex::promote(TreeNode *subtreeRoot)
+{
+    QVector<TreeNode *> stack{subtreeRoot};
+    while (!stack.isEmpty()) {
+        TreeNode *node = stack.takeLast();
+        const QString nodePath = _paths.value(node);
+        if (_nodes.contains(nodePath)) {
+            continue;
+        }
+        _shadowed.remove(nodePath, node);
+        _nodes.insert(nodePath, node);
+        for (TreeNode *child : node->children()) {
+            stack.append(child);
+        }
+    }
+}
+
+TreeNode *TreePathIndex::node(const QString &path) const
+{
+    return _nodes.value(path, nullptr);
+}
+
+QString TreePathIndex::path(const TreeNode *node) const
+{
+    return _paths.value(node);
+}
@@ -0,0 +1,150 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreePathIndex.h                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreePathIndex class, a hash index between JSON Pointer  *
+ * paths and the nodes of a tree.                                              *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_PATH_INDEX_H__
+#define __TREE_PATH_INDEX_H__
+
+#include <QHash>
+#include <QMultiHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "TreeNode.h"
+
+
+class TreePathIndex
+{
+public:
+    /**
+     * @brief Constructs an empty index.
+     */
+    TreePathIndex();
+
+    /**
+     * @brief Removes every node from the index.
+     */
+    void clear();
+
+    /**
+     * @brief Indexes the children of the given node and all their built descendants.
+     *
+     * The paths are built from the path of `parentNode`, which must be the root
+     * or already be indexed.
+     *
+     * @param parentNode The node whose children to index.
+     */
+    void addChildren(const TreeNode *parentNode);
+
+    /**
+     * @brief Indexes a node and all its built descendants.
+     *
+     * @param node The node, whose parent must be the root or already be indexed.
+     */
+    void addSubtree(const TreeNode *node);
+
+    /**
+     * @brief Removes a node and all its descendants from the index.
+     *
+     * If the node had a path that an equally named sibling shares, the path
+     * resolves to that sibling from then on, as it would with `JsonPointer::resolve()`.
+     *
+     * @param node The root of the subtree to remove.
+     */
+    void removeSubtree(const TreeNode *node);
+
+    /**
+     * @brief Re-indexes the children of a node from the given row on.
+     *
+     * Needed after array elements were inserted, removed or moved, which
+     * shifts the paths of every element after them.
+     *
+     * @param parentNode The node whose children changed.
+     * @param firstRow The first row whose path may have changed.
+     */
+    void reindexChildren(const TreeNode *parentNode, int firstRow);
+
+    /**
+     * @brief Returns the node at the given path.
+     *
+     * @param path The JSON Pointer path, e.g. `/config/options/option3/2`.
+     * @return The node, or nullptr if no built node has this path.
+     */
+    TreeNode *node(const QString &path) const;
+
+    /**
+     * @brief Returns the path of the given node.
+     *
+     * @param node The node.
+     * @return The path, empty for the root and for nodes that are not indexed.
+     */
+    QString path(const TreeNode *node) const;
+
+    /**
+     * @brief Returns true if the node is indexed.
+     *
+     * @param node The node.
+     */
+    inline bool contains(const TreeNode *node) const { return _paths.contains(node); }
+
+    /**
+     * @brief Returns the number of indexed nodes.
+     */
+    inline int nodeCount() const { return _paths.count(); }
+
+private:
+    /**
+     * @brief Indexes the given nodes and their built descendants.
+     *
+     * @param stack The nodes with their paths, the last one is indexed first.
+     */
+    void addAll(QVector<QPair<TreeNode *, QString>> &stack);
+
+    /**
+     * @brief Returns true if the parent of the node is the root or the node its path resolves to.
+     *
+     * @param node The node.
+     */
+    bool ownsParentPath(const TreeNode *node) const;
+
+    /**
+     * @brief Lets a shadowed node and its descendants take over the paths that are free.
+     *
+     * @param subtreeRoot The shadowed node.
+     */
+    void promote(TreeNode *subtreeRoot);
+
+    QHash<QString, TreeNode *> _nodes;
+    QHash<const TreeNode *, QString> _paths;   // shares the strings with _nodes
+    QMultiHash<QString, TreeNode *> _shadowed; // nodes whose path resolves to a namesake
+};
+
+#endif // __TREE_PATH_INDEX_H__
@@ -0,0 +1,182 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeSaver.cpp                                                     *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeSaver class, a write-behind saver that coalesces  *
+ * edits and writes the JSON file atomically on a worker thread.               *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QDebug>
+#include <QSaveFile>
+#include <QtConcurrent>
+#include <QElapsedTimer>
+#include "TreeSaver.h"
+#include "TreeStats.h"
+
+// default window in which edits are coalesced into one save
+static const int DEFAULT_SAVE_DELAY = 500;
+
+TreeSaver::TreeSaver(const QString &filePath, const SnapshotFunction &snapshot, QObject *parent)
+    : QObject(parent),
+      _filePath{filePath},
+      _snapshot{snapshot},
+      _dirty{false},
+      _saving{false}
+{
+    _timer.setSingleShot(true);
+    _timer.setInterval(DEFAULT_SAVE_DELAY);
+    connect(&_timer, &QTimer::timeout, this, &TreeSaver::startSave);
+    connect(&_saveWatcher, &QFutureWatcher<bool>::finished, this, &TreeSaver::onSaveFinished);
+}
+
+TreeSaver::~TreeSaver()
+{
+    _saveWatcher.waitForFinished();
+}
+
+void TreeSaver::setDelay(int delay)
+{
+    _timer.setInterval(qMax(0, delay));
+}
+
+void TreeSaver::markDirty()
+{
+    setDirty(true);
+
+    // the timer is not restarted on every edit, so a steady stream of edits
+    // is still written once per window
+    if (!_saving && !_timer.isActive()) {
+        _timer.start();
+    }
+}
+
+void TreeSaver::flush()
+{
+    _timer.stop();
+    if (_dirty && !_saving) {
+        startSave();
+    }
+}
+
+void TreeSaver::waitForSaved()
+{
+    _timer.stop();
+
+    // a running save may predate the latest edits, so it is awaited first
+    if (_saving) {
+        _saveWatcher.waitForFinished();
+        onSaveFinished();
+        _timer.stop();
+    }
+
+    if (_dirty) {
+        const WriteFunction write = _snapshot();
+        if (!write) {
+            return;
+        }
+        setDirty(false);
+        emit saved(writeAtomically(_filePath, write));
+    }
+}
+
+void TreeSaver::startSave()
+{
+    if (_saving || !_dirty) {
+        return;
+    }
+
+    // only the snapshot is taken on the GUI thread, serializing, compressing
+    // and writing it happen on the worker
+    QElapsedTimer timer;
+    timer.start();
+    const WriteFunction write = _snapshot();
+    if (!write) {
+        return;
+    }
+    const qint64 snapshot = timer.elapsed();
+    const QString filePath = _filePath;
+
+    setDirty(false);
+    setSaving(true);
+
+    _saveWatcher.setFuture(QtConcurrent::run([write, filePath, snapshot]() {
+        QElapsedTimer timer;
+        timer.start();
+        const bool success = writeAtomically(filePath, write);
+        qCDebug(lcTreeSave) << filePath << "snapshot took" << snapshot << "ms, serialize and write took" << timer.elapsed() << "ms";
+        return success;
+    }));
+}
+
+void TreeSaver::onSaveFinished()
+{
+    if (!_saving) {
+        return;
+    }
+
+    const bool success = _saveWatcher.result();
+    setSaving(false);
+
+    if (!success) {
+        qWarning() << "[WARNING] :: failed to save json file:" << _filePath;
+    }
+    emit saved(success);
+
+    // edits made while the worker was busy get their own save
+    if (_dirty && !_timer.isActive()) {
+        _timer.start();
+    }
+}
+
+bool TreeSaver::writeAtomically(const QString &filePath, const WriteFunction &write)
+{
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+    if (!write(&file)) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+void TreeSaver::setDirty(bool dirty)
+{
+    if (_dirty == dirty) {
+        return;
+    }
+    _dirty = dirty;
+    emit dirtyChanged();
+}
+
+void TreeSaver::setSaving(bool saving)
+{
+    if (_saving == saving) {
+        return;
+    }
+    _saving = saving;
+    emit savingChanged();
+}
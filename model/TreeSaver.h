@@ -0,0 +1,182 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeSaver.h                                                       *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeSaver class, a write-behind saver for the           *
+ * TreeModel. Edits mark the saver dirty, edits within the configured delay    *
+ * are coalesced into one save, and the JSON is serialized and written on a    *
+ * worker thread with an atomic temp file and rename.                          *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_SAVER_H__
+#define __TREE_SAVER_H__
+
+#include <functional>
+
+#include <QTimer>
+#include <QObject>
+#include <QString>
+#include <QIODevice>
+#include <QFutureWatcher>
+
+
+class TreeSaver : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * @brief Function writing the document to a device, returns false if it failed.
+     *
+     * Runs on the worker thread, so it may only use what it holds, e.g. an
+     * immutable `TreeVersion`, never the tree being edited.
+     */
+    using WriteFunction = std::function<bool(QIODevice *device)>;
+
+    /**
+     * @brief Function taking a snapshot of the tree to be saved.
+     *
+     * Called on the GUI thread, so it sees a consistent tree. The returned
+     * function serializes (and compresses) the snapshot on the worker thread
+     * while the tree is edited further. An empty function means there is
+     * nothing that may be saved right now, e.g. while the tree is loading; the
+     * file is left alone and the edits stay pending.
+     */
+    using SnapshotFunction = std::function<WriteFunction()>;
+
+    /**
+     * @brief Constructs a TreeSaver writing to the given file.
+     *
+     * @param filePath The path of the JSON file to write.
+     * @param snapshot The function returning the contents to save.
+     * @param parent The parent QObject, default is nullptr.
+     */
+    TreeSaver(const QString &filePath, const SnapshotFunction &snapshot, QObject *parent = nullptr);
+
+    /**
+     * @brief Destructor for the TreeSaver class.
+     *
+     * Waits for a save that is in flight; edits that were not saved yet are
+     * not written, call `waitForSaved()` first to keep them.
+     */
+    ~TreeSaver();
+
+    /**
+     * @brief Sets the window in which edits are coalesced into one save.
+     *
+     * @param delay The delay in milliseconds between the first unsaved edit
+     *              and the save (default 500).
+     */
+    void setDelay(int delay);
+
+    /**
+     * @brief Returns the window in which edits are coalesced, in milliseconds.
+     */
+    inline int delay() const { return _timer.interval(); }
+
+    /**
+     * @brief Returns true if there are edits that have not been written yet.
+     */
+    inline bool isDirty() const { return _dirty; }
+
+    /**
+     * @brief Returns true while a save is running on the worker thread.
+     */
+    inline bool isSaving() const { return _saving; }
+
+    /**
+     * @brief Records an edit; a save is scheduled after the configured delay.
+     *
+     * Further edits within the delay are written by the same save.
+     */
+    void markDirty();
+
+    /**
+     * @brief Starts saving pending edits right away instead of waiting for the delay.
+     *
+     * If a save is already running, the pending edits are saved as soon as it
+     * finishes.
+     */
+    void flush();
+
+    /**
+     * @brief Blocks until all edits recorded so far have been written.
+     */
+    void waitForSaved();
+
+    /**
+     * @brief Writes the file through a temporary file and a rename.
+     *
+     * Readers of the file either see the old or the new contents, never a
+     * partially written file.
+     *
+     * @param filePath The file to write.
+     * @param write Writes the contents to the temporary file.
+     * @return True if the file was written and renamed into place.
+     */
+    static bool writeAtomically(const QString &filePath, const WriteFunction &write);
+
+signals:
+    /**
+     * @brief Emitted when `isDirty()` changes.
+     */
+    void dirtyChanged();
+
+    /**
+     * @brief Emitted when `isSaving()` changes.
+     */
+    void savingChanged();
+
+    /**
+     * @brief Emitted after every save attempt.
+     *
+     * @param success True if the file was written.
+     */
+    void saved(bool success);
+
+private:
+    /**
+     * @brief Takes a snapshot and starts writing it on the worker thread.
+     */
+    void startSave();
+
+    /**
+     * @brief Handles the end of a save and starts the next one if edits arrived meanwhile.
+     */
+    void onSaveFinished();
+
+    void setDirty(bool dirty);
+    void setSaving(bool saving);
+
+private:
+    QString _filePath;
+    SnapshotFunction _snapshot;
+    QTimer _timer;
+    QFutureWatcher<bool> _saveWatcher;
+    bool _dirty;
+    bool _saving;
+};
+
+#endif // __TREE_SAVER_H__
@@ -0,0 +1,207 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeSearchIndex.cpp                                               *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeSearchIndex class, a trigram index over node      *
+ * names and values.                                                           *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <algorithm>
+#include <iterator>
+#include "TreeSearchIndex.h"
+
+// once this few candidates are left, comparing their text is cheaper than intersecting further
+static const int VERIFY_CANDIDATES = 256;
+
+TreeSearchIndex::TreeSearchIndex()
+    : _staleEntries{0} {}
+
+void TreeSearchIndex::clear()
+{
+    _entries.clear();
+    _nodeEntries.clear();
+    _postings.clear();
+    _staleEntries = 0;
+}
+
+void TreeSearchIndex::addChildren(const TreeNode *parentNode)
+{
+    for (const TreeNode *child : parentNode->children()) {
+        addSubtree(child);
+    }
+}
+
+void TreeSearchIndex::addSubtree(const TreeNode *subtreeRoot)
+{
+    QVector<const TreeNode *> stack{subtreeRoot};
+
+    // depth-first in document order, so results come out in the order of the tree
+    while (!stack.isEmpty()) {
+        const TreeNode *node = stack.takeLast();
+        add(node);
+
+        const QList<TreeNode *> &children = node->children();
+        for (int i = children.count() - 1; i >= 0; --i) {
+            stack.append(children.at(i));
+        }
+    }
+}
+
+void TreeSearchIndex::removeSubtree(const TreeNode *subtreeRoot)
+{
+    QVector<const TreeNode *> stack{subtreeRoot};
+    while (!stack.isEmpty()) {
+        const TreeNode *node = stack.takeLast();
+        removeEntry(node);
+        for (const TreeNode *child : node->children()) {
+            stack.append(child);
+        }
+    }
+    compactIfStale();
+}
+
+void TreeSearchIndex::update(const TreeNode *node)
+{
+    if (!removeEntry(node)) {
+        return;
+    }
+    add(node);
+    compactIfStale();
+}
+
+QVector<const TreeNode *> TreeSearchIndex::find(const QString &text) const
+{
+    const QString needle = text.toCaseFolded();
+    QVector<const TreeNode *> matches;
+
+    auto verify = [&](quint32 id) {
+        const Entry &entry = _entries.at(id);
+        if (entry.node && entry.text.contains(needle)) {
+            matches.append(entry.node);
+        }
+    };
+
+    if (needle.isEmpty()) {
+        return matches;
+    }
+
+    if (needle.size() < 3) {
+        for (quint32 id = 0; id < quint32(_entries.count()); ++id) {
+            verify(id);
+        }
+        return matches;
+    }
+
+    // every trigram of the text has to occur in a match
+    QVector<const QVector<quint32> *> postings;
+    for (int i = 0; i + 3 <= needle.size(); ++i) {
+        auto it = _postings.constFind(trigram(needle.constData() + i));
+        if (it == _postings.constEnd()) {
+            return matches;
+        }
+        postings.append(&*it);
+    }
+
+    std::sort(postings.begin(), postings.end(), [](const QVector<quint32> *a, const QVector<quint32> *b) {
+        return a->count() < b->count();
+    });
+
+    QVector<quint32> candidates = *postings.first();
+    for (int i = 1; i < postings.count() && candidates.count() > VERIFY_CANDIDATES; ++i) {
+        QVector<quint32> narrowed;
+        narrowed.reserve(candidates.count());
+        std::set_intersection(candidates.constBegin(), candidates.constEnd(),
+                              postings.at(i)->constBegin(), postings.at(i)->constEnd(),
+                              std::back_inserter(narrowed));
+        candidates.swap(narrowed);
+    }
+
+    for (quint32 id : candidates) {
+        verify(id);
+    }
+    return matches;
+}
+
+void TreeSearchIndex::add(const TreeNode *node)
+{
+    const quint32 id = quint32(_entries.count());
+    const QString text = searchText(node);
+
+    const QChar *chars = text.constData();
+    for (int i = 0; i + 3 <= text.size(); ++i) {
+        QVector<quint32> &posting = _postings[trigram(chars + i)];
+        // ids only grow, so a repeated trigram of the same entry is always last
+        if (posting.isEmpty() || posting.last() != id) {
+            posting.append(id);
+        }
+    }
+
+    _entries.append({node, text});
+    _nodeEntries.insert(node, id);
+}
+
+bool TreeSearchIndex::removeEntry(const TreeNode *node)
+{
+    auto it = _nodeEntries.find(node);
+    if (it == _nodeEntries.end()) {
+        return false;
+    }
+
+    Entry &stale = _entries[*it];
+    stale.node = nullptr;
+    stale.text.clear();
+    ++_staleEntries;
+    _nodeEntries.erase(it);
+    return true;
+}
+
+void TreeSearchIndex::compactIfStale()
+{
+    if (_staleEntries > _nodeEntries.count()) {
+        compact();
+    }
+}
+
+void TreeSearchIndex::compact()
+{
+    QVector<Entry> entries;
+    entries.swap(_entries);
+    clear();
+
+    for (const Entry &entry : entries) {
+        if (entry.node) {
+            add(entry.node);
+        }
+    }
+}
+
+QString TreeSearchIndex::searchText(const TreeNode *node)
+{
+    const QString value = node->valueKind() == TreeNode::StringValue ? node->stringValue()
+                                                                     : node->value().toString();
+
+    // the separator never occurs in a single-line search text, so matches cannot span both parts
+    return (node->name() + QLatin1Char('\n') + value).toCaseFolded();
+}
@@ -0,0 +1,160 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeSearchIndex.h                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeSearchIndex class, a trigram index over node names  *
+ * and values used to find nodes without walking the tree.                     *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_SEARCH_INDEX_H__
+#define __TREE_SEARCH_INDEX_H__
+
+#include <QHash>
+#include <QVector>
+#include <QString>
+
+#include "TreeNode.h"
+
+
+class TreeSearchIndex
+{
+public:
+    /**
+     * @brief Constructs an empty index.
+     */
+    TreeSearchIndex();
+
+    /**
+     * @brief Removes every node from the index.
+     */
+    void clear();
+
+    /**
+     * @brief Indexes the children of the given node and all their built descendants.
+     *
+     * The node itself is not indexed, so passing the (invisible) root indexes the
+     * whole tree, and passing a node after `fetchMore()` indexes its new children.
+     *
+     * @param parentNode The node whose children to index.
+     */
+    void addChildren(const TreeNode *parentNode);
+
+    /**
+     * @brief Indexes a node and all its built descendants.
+     *
+     * @param node The root of the subtree to index.
+     */
+    void addSubtree(const TreeNode *node);
+
+    /**
+     * @brief Removes a node and all its descendants from the index.
+     *
+     * Their entries are marked stale like in `update()`.
+     *
+     * @param node The root of the subtree to remove.
+     */
+    void removeSubtree(const TreeNode *node);
+
+    /**
+     * @brief Re-indexes a node after its value changed.
+     *
+     * The old entry is only marked stale; the postings are rebuilt once stale
+     * entries outnumber the live ones.
+     *
+     * @param node The changed node.
+     */
+    void update(const TreeNode *node);
+
+    /**
+     * @brief Returns the nodes whose name or value contains the given text.
+     *
+     * Matching is case-insensitive. Texts of three or more characters are looked
+     * up through their trigrams, only the candidates found there are compared;
+     * shorter texts are compared against every entry.
+     *
+     * @param text The text to search for.
+     * @return The matching nodes, in the order they were indexed.
+     */
+    QVector<const TreeNode *> find(const QString &text) const;
+
+    /**
+     * @brief Returns the number of indexed nodes.
+     */
+    inline int nodeCount() const { return _nodeEntries.count(); }
+
+private:
+    struct Entry {
+        const TreeNode *node;   // nullptr once the entry is stale
+        QString text;
+    };
+
+    /**
+     * @brief Adds an entry for a single node.
+     *
+     * @param node The node.
+     */
+    void add(const TreeNode *node);
+
+    /**
+     * @brief Marks the entry of a single node stale.
+     *
+     * @param node The node.
+     * @return True if the node was indexed.
+     */
+    bool removeEntry(const TreeNode *node);
+
+    /**
+     * @brief Rebuilds the entries and postings once stale entries outnumber the live ones.
+     */
+    void compactIfStale();
+
+    /**
+     * @brief Rebuilds the entries and postings without the stale entries.
+     */
+    void compact();
+
+    /**
+     * @brief Returns the case-folded text a node is matched against.
+     *
+     * @param node The node.
+     */
+    static QString searchText(const TreeNode *node);
+
+    /**
+     * @brief Packs the three characters starting at `chars` into a key.
+     *
+     * @param chars The first of the three characters.
+     */
+    static inline quint64 trigram(const QChar *chars) {
+        return (quint64(chars[0].unicode()) << 32) | (quint64(chars[1].unicode()) << 16) | chars[2].unicode();
+    }
+
+    QVector<Entry> _entries;
+    QHash<const TreeNode *, quint32> _nodeEntries;
+    QHash<quint64, QVector<quint32>> _postings;   // entry ids in ascending order
+    int _staleEntries;
+};
+
+#endif // __TREE_SEARCH_INDEX_H__
@@ -0,0 +1,497 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeSnapshot.cpp                                                  *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeSnapshot class, a memory-mapped binary snapshot   *
+ * of a built tree.                                                            *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QDebug>
+#include <QVector>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QtEndian>
+#include <QCryptographicHash>
+#include "TreeSnapshot.h"
+
+// identifies the file format, bumped whenever the layout changes
+static const char SNAPSHOT_MAGIC[8] = {'Q', 'T', 'V', 'S', 'N', 'A', 'P', '1'};
+static const quint32 SNAPSHOT_VERSION = 2;
+
+// string index of nodes without a name
+static const quint32 NO_STRING = 0xffffffff;
+
+// bytes hashed at the head and the tail of the JSON file for the source key
+static const qint64 HASH_SAMPLE_SIZE = 64 * 1024;
+
+struct TreeSnapshot::Header {
+    char magic[8];
+    quint32 version;
+    quint32 nodeCount;
+    qint64 sourceSize;
+    qint64 sourceModified;
+    quint64 sourceHash;
+    quint32 stringCount;
+    quint32 reserved;
+    quint64 recordsOffset;
+    quint64 stringOffsetsOffset;
+    quint64 stringDataOffset;
+    quint64 fileSize;
+};
+
+struct TreeSnapshot::Record {
+    quint32 parent;
+    quint32 firstChild;     // children are stored next to each other
+    quint32 childCount;
+    quint32 name;           // string index, NO_STRING for unnamed nodes
+    quint8 type;            // TreeNode::Type
+    quint8 tag;             // ValueTag
+    quint16 reserved0;
+    quint32 reserved1;
+    union {
+        double number;
+        qint64 integer;
+        quint64 bits;       // bool value or string index
+    } value;
+};
+
+static_assert(sizeof(TreeSnapshot::Record) == 32, "snapshot records are expected to be 32 bytes");
+
+namespace {
+
+// the same kinds as TreeNode::ValueKind; objects and arrays are NullValue
+enum ValueTag : quint8 {
+    NullValue,
+    BoolValue,
+    IntegerValue,
+    DoubleValue,
+    StringValue
+};
+
+/**
+ * @brief Collects the distinct strings of a snapshot.
+ */
+class StringTable
+{
+public:
+    quint32 add(const QString &string) {
+        auto it = _indexes.constFind(string);
+        if (it != _indexes.constEnd()) {
+            return *it;
+        }
+
+        const quint32 index = quint32(_offsets.count());
+        _offsets.append(quint32(_data.size()));
+        _data.append(string);
+        _indexes.insert(string, index);
+        return index;
+    }
+
+    QVector<quint32> offsets() const {
+        QVector<quint32> offsets = _offsets;
+        offsets.append(quint32(_data.size()));
+        return offsets;
+    }
+
+    inline const QString &data() const { return _data; }
+    inline quint32 count() const { return quint32(_offsets.count()); }
+
+private:
+    QHash<QString, quint32> _indexes;
+    QVector<quint32> _offsets;
+    QString _data;
+};
+
+void encodeJsonScalar(const QJsonValue &json, TreeSnapshot::Record &record, StringTable &strings)
+{
+    if (json.isBool()) {
+        record.tag = BoolValue;
+        record.value.bits = json.toBool() ? 1 : 0;
+    } else if (json.isDouble() && json.toVariant().userType() == QMetaType::LongLong) {
+        record.tag = IntegerValue;
+        record.value.integer = json.toInteger();
+    } else if (json.isDouble()) {
+        record.tag = DoubleValue;
+        record.value.number = json.toDouble();
+    } else if (json.isString()) {
+        record.tag = StringValue;
+        record.value.bits = strings.add(json.toString());
+    } else {
+        record.tag = NullValue;
+    }
+}
+
+void encodeNode(const TreeNode *node, TreeSnapshot::Record &record, StringTable &strings)
+{
+    switch (node->valueKind()) {
+    case TreeNode::BoolValue:
+        record.tag = BoolValue;
+        record.value.bits = node->boolValue() ? 1 : 0;
+        break;
+    case TreeNode::IntegerValue:
+        record.tag = IntegerValue;
+        record.value.integer = node->integerValue();
+        break;
+    case TreeNode::DoubleValue:
+        record.tag = DoubleValue;
+        record.value.number = node->doubleValue();
+        break;
+    case TreeNode::StringValue:
+        record.tag = StringValue;
+        record.value.bits = strings.add(node->stringValue());
+        break;
+    case TreeNode::NullValue:
+        record.tag = NullValue;
+        break;
+    }
+}
+
+} // namespace
+
+TreeSnapshot::SourceKey TreeSnapshot::SourceKey::of(const QString &filePath)
+{
+    SourceKey key{0, 0, 0};
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return key;
+    }
+
+    key.size = file.size();
+    key.modified = QFileInfo(file).lastModified().toMSecsSinceEpoch();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(file.read(HASH_SAMPLE_SIZE));
+    if (key.size > HASH_SAMPLE_SIZE) {
+        file.seek(qMax(HASH_SAMPLE_SIZE, key.size - HASH_SAMPLE_SIZE));
+        hash.addData(file.read(HASH_SAMPLE_SIZE));
+    }
+    key.hash = qFromLittleEndian<quint64>(hash.result().constData());
+    return key;
+}
+
+QString TreeSnapshot::snapshotPath(const QString &jsonFile)
+{
+    return jsonFile + QStringLiteral(".snapshot");
+}
+
+bool TreeSnapshot::write(const QString &filePath, const SourceKey &key, const TreeNode *rootNode,
+                         const PendingFunction &pending)
+{
+    // a node of the tree, or a value of a pending JSON subtree
+    struct Item {
+        const TreeNode *node;
+        QJsonValue json;
+        QString name;
+        quint32 parent;
+    };
+
+    QVector<Item> items;
+    QVector<Record> records;
+    StringTable strings;
+
+    items.append({rootNode, QJsonValue(), QString(), 0});
+
+    // breadth-first, so the children of every item are appended next to each other
+    for (int i = 0; i < items.count(); ++i) {
+        const Item item = items.at(i);
+        const quint32 index = quint32(i);
+
+        Record record;
+        memset(&record, 0, sizeof(record));
+        record.parent = item.parent;
+        record.firstChild = quint32(items.count());
+
+        QJsonValue children(QJsonValue::Undefined);
+
+        if (item.node) {
+            record.name = item.node->name().isEmpty() ? NO_STRING : strings.add(item.node->name());
+            record.type = item.node->type();
+            encodeNode(item.node, record, strings);
+
+            if (pending) {
+                children = pending(item.node);
+            }
+            if (children.isUndefined()) {
+                for (const TreeNode *child : item.node->children()) {
+                    items.append({child, QJsonValue(), QString(), index});
+                }
+            }
+        } else {
+            record.name = item.name.isEmpty() ? NO_STRING : strings.add(item.name);
+            if (item.json.isObject()) {
+                record.type = TreeNode::Object;
+                record.tag = NullValue;
+                children = item.json;
+            } else if (item.json.isArray()) {
+                record.type = TreeNode::Array;
+                record.tag = NullValue;
+                children = item.json;
+            } else {
+                record.type = TreeNode::Value;
+                encodeJsonScalar(item.json, record, strings);
+            }
+        }
+
+        if (children.isObject()) {
+            const QJsonObject jsonObj = children.toObject();
+            for (auto it = jsonObj.begin(); it != jsonObj.end(); ++it) {
+                items.append({nullptr, it.value(), it.key(), index});
+            }
+        } else if (children.isArray()) {
+            const QJsonArray jsonArray = children.toArray();
+            for (const QJsonValue &element : jsonArray) {
+                items.append({nullptr, element, QString(), index});
+            }
+        }
+
+        record.childCount = quint32(items.count()) - record.firstChild;
+        records.append(record);
+
+        // the item is fully described by its record now
+        items[i] = Item{nullptr, QJsonValue(), QString(), 0};
+    }
+
+    const QVector<quint32> stringOffsets = strings.offsets();
+
+    Header header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.nodeCount = quint32(records.count());
+    header.sourceSize = key.size;
+    header.sourceModified = key.modified;
+    header.sourceHash = key.hash;
+    header.stringCount = strings.count();
+    header.recordsOffset = sizeof(Header);
+    header.stringOffsetsOffset = header.recordsOffset + quint64(records.count()) * sizeof(Record);
+    header.stringDataOffset = header.stringOffsetsOffset + quint64(stringOffsets.count()) * sizeof(quint32);
+    header.fileSize = header.stringDataOffset + quint64(strings.data().size()) * sizeof(QChar);
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(records.constData()), records.count() * qint64(sizeof(Record)));
+    file.write(reinterpret_cast<const char *>(stringOffsets.constData()), stringOffsets.count() * qint64(sizeof(quint32)));
+    file.write(reinterpret_cast<const char *>(strings.data().constData()), strings.data().size() * qint64(sizeof(QChar)));
+    return file.commit();
+}
+
+QSharedPointer<TreeSnapshot> TreeSnapshot::open(const QString &filePath, const SourceKey &key)
+{
+    QSharedPointer<TreeSnapshot> snapshot(new TreeSnapshot());
+    snapshot->_file.setFileName(filePath);
+
+    if (!snapshot->_file.open(QIODevice::ReadOnly)) {
+        return QSharedPointer<TreeSnapshot>();
+    }
+
+    const qint64 size = snapshot->_file.size();
+    if (size < qint64(sizeof(Header))) {
+        return QSharedPointer<TreeSnapshot>();
+    }
+
+    snapshot->_data = snapshot->_file.map(0, size);
+    if (!snapshot->_data) {
+        return QSharedPointer<TreeSnapshot>();
+    }
+
+    const Header *header = reinterpret_cast<const Header *>(snapshot->_data);
+    if (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0
+        || header->version != SNAPSHOT_VERSION
+        || header->fileSize != quint64(size)
+        || header->nodeCount == 0
+        || header->sourceSize != key.size
+        || header->sourceModified != key.modified
+        || header->sourceHash != key.hash) {
+        return QSharedPointer<TreeSnapshot>();
+    }
+
+    // a partially written or corrupt file must not send reads past the mapping;
+    // counts are 32-bit, so none of the sums below overflows
+    if (header->recordsOffset < sizeof(Header)
+        || header->recordsOffset % alignof(Record) != 0
+        || header->stringOffsetsOffset % alignof(quint32) != 0
+        || header->stringDataOffset % alignof(QChar) != 0
+        || header->recordsOffset > header->fileSize
+        || header->stringOffsetsOffset > header->fileSize
+        || header->stringDataOffset > header->fileSize
+        || header->recordsOffset + quint64(header->nodeCount) * sizeof(Record) > header->stringOffsetsOffset
+        || header->stringOffsetsOffset + (quint64(header->stringCount) + 1) * sizeof(quint32) > header->stringDataOffset) {
+        qWarning() << "[WARNING] :: corrupt snapshot, sections out of bounds:" << filePath;
+        return QSharedPointer<TreeSnapshot>();
+    }
+
+    snapshot->_header = header;
+    snapshot->_records = reinterpret_cast<const Record *>(snapshot->_data + header->recordsOffset);
+    snapshot->_stringOffsets = reinterpret_cast<const quint32 *>(snapshot->_data + header->stringOffsetsOffset);
+    snapshot->_stringData = reinterpret_cast<const QChar *>(snapshot->_data + header->stringDataOffset);
+    return snapshot;
+}
+
+TreeSnapshot::TreeSnapshot()
+    : _data{nullptr},
+      _header{nullptr},
+      _records{nullptr},
+      _stringOffsets{nullptr},
+      _stringData{nullptr} {}
+
+TreeSnapshot::~TreeSnapshot()
+{
+    if (_data) {
+        _file.unmap(const_cast<uchar *>(_data));
+    }
+}
+
+int TreeSnapshot::childCount(quint32 record) const
+{
+    quint32 first = 0;
+    return int(childRange(record, &first) - first);
+}
+
+quint32 TreeSnapshot::childRange(quint32 record, quint32 *first) const
+{
+    // children are written after their parent, anything else would be a cycle
+    const Record &current = _records[record];
+    if (current.childCount == 0 || current.firstChild <= record || current.firstChild >= _header->nodeCount) {
+        *first = 0;
+        return 0;
+    }
+    *first = current.firstChild;
+    return quint32(qMin(quint64(current.firstChild) + current.childCount, quint64(_header->nodeCount)));
+}
+
+void TreeSnapshot::buildChildren(TreeNode *node, quint32 record, TreeNodeArena &arena,
+                                 QHash<const TreeNode *, quint32> &pending) const
+{
+    quint32 first = 0;
+    const quint32 end = childRange(record, &first);
+
+    for (quint32 i = first; i < end; ++i) {
+        const Record &childRecord = _records[i];
+        TreeNode *child = arena.create(string(childRecord.name), QVariant(), node);
+        arena.setJsonValue(child, value(childRecord));
+        child->setType(childRecord.type <= TreeNode::Array ? TreeNode::Type(childRecord.type) : TreeNode::Value);
+        node->appendChild(child);
+
+        if (childCount(i) > 0) {
+            pending.insert(child, i);
+        }
+    }
+}
+
+QJsonValue TreeSnapshot::toJson(quint32 record) const
+{
+    struct Frame {
+        quint32 record;
+        quint32 next;
+        quint32 end;
+        QJsonArray array;
+        QJsonObject object;
+    };
+
+    // opens a frame for an object or array, returns false with the value of anything else
+    QVector<Frame> stack;
+    const auto open = [this, &stack](quint32 index, QJsonValue &leaf) {
+        const Record &current = _records[index];
+        quint32 first = 0;
+        const quint32 end = childRange(index, &first);
+        if (current.type != TreeNode::Array && current.type != TreeNode::Object && end == first) {
+            leaf = value(current);
+            return false;
+        }
+        stack.append({index, first, end, QJsonArray(), QJsonObject()});
+        return true;
+    };
+
+    QJsonValue result;
+    if (!open(record, result)) {
+        return result;
+    }
+
+    // depth-first without recursion, deep documents must not overflow the stack
+    while (true) {
+        Frame &frame = stack.last();
+        quint32 child = 0;
+        if (frame.next < frame.end) {
+            child = frame.next++;
+            if (open(child, result)) {
+                continue;
+            }
+        } else {
+            child = frame.record;
+            result = _records[child].type == TreeNode::Array ? QJsonValue(frame.array) : QJsonValue(frame.object);
+            stack.removeLast();
+            if (stack.isEmpty()) {
+                return result;
+            }
+        }
+
+        Frame &parent = stack.last();
+        if (_records[parent.record].type == TreeNode::Array) {
+            parent.array.append(result);
+        } else {
+            parent.object.insert(string(_records[child].name), result);
+        }
+    }
+}
+
+QString TreeSnapshot::string(quint32 index) const
+{
+    if (index == NO_STRING || index >= _header->stringCount) {
+        return QString();
+    }
+
+    // the offsets are read as they are used, a bad one gives an empty string
+    const quint64 available = (_header->fileSize - _header->stringDataOffset) / sizeof(QChar);
+    const quint32 begin = _stringOffsets[index];
+    const quint32 end = _stringOffsets[index + 1];
+    if (begin > end || end > available) {
+        return QString();
+    }
+    return QString(_stringData + begin, int(end - begin));
+}
+
+QJsonValue TreeSnapshot::value(const Record &record) const
+{
+    switch (record.tag) {
+    case BoolValue:
+        return bool(record.value.bits);
+    case IntegerValue:
+        return record.value.integer;
+    case DoubleValue:
+        return record.value.number;
+    case StringValue:
+        return string(quint32(record.value.bits));
+    default:
+        return QJsonValue(QJsonValue::Null);
+    }
+}
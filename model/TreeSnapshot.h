@@ -0,0 +1,194 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeSnapshot.h                                                    *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeSnapshot class, a compact binary snapshot of a      *
+ * built tree (node table, string pool and values) stored next to the JSON     *
+ * file. The snapshot is memory-mapped on later starts, and nodes are built    *
+ * from the mapped pages on demand, so startup no longer depends on parsing    *
+ * the JSON.                                                                   *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_SNAPSHOT_H__
+#define __TREE_SNAPSHOT_H__
+
+#include <functional>
+
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QVariant>
+#include <QJsonValue>
+#include <QSharedPointer>
+
+#include "TreeNode.h"
+#include "TreeNodeArena.h"
+
+
+class TreeSnapshot
+{
+    Q_DISABLE_COPY(TreeSnapshot)
+
+public:
+    /**
+     * @brief Identifies the version of the JSON file a snapshot was built from.
+     */
+    struct SourceKey {
+        qint64 size;
+        qint64 modified;    // modification time in ms since the epoch
+        quint64 hash;       // hash of the first and last 64 KiB of the file
+
+        /**
+         * @brief Returns the key of the given file, all zero if it cannot be read.
+         *
+         * Only samples the head and the tail of the file, so computing the key
+         * costs O(1) regardless of the file size.
+         *
+         * @param filePath The JSON file.
+         */
+        static SourceKey of(const QString &filePath);
+
+        bool operator==(const SourceKey &other) const {
+            return size == other.size && modified == other.modified && hash == other.hash;
+        }
+    };
+
+    /**
+     * @brief Function returning the unparsed JSON value of a node whose children are not built.
+     *
+     * Returns an undefined QJsonValue for nodes whose children are all built.
+     */
+    using PendingFunction = std::function<QJsonValue(const TreeNode *)>;
+
+    /**
+     * @brief Returns the path of the snapshot belonging to a JSON file (`<jsonFile>.snapshot`).
+     *
+     * @param jsonFile The JSON file.
+     */
+    static QString snapshotPath(const QString &jsonFile);
+
+    /**
+     * @brief Writes a snapshot of the tree.
+     *
+     * The tree is written in breadth-first order, so the children of every node
+     * are stored next to each other. Children that are not built yet are taken
+     * from their pending JSON value.
+     *
+     * @param filePath The snapshot file to write (atomically).
+     * @param key The key of the JSON file the tree was built from.
+     * @param rootNode The root of the tree.
+     * @param pending Returns the pending JSON value of a node, may be empty.
+     * @return True if the snapshot was written.
+     */
+    static bool write(const QString &filePath, const SourceKey &key, const TreeNode *rootNode,
+                      const PendingFunction &pending = PendingFunction());
+
+    /**
+     * @brief Maps a snapshot if it exists and matches the key.
+     *
+     * @param filePath The snapshot file.
+     * @param key The key of the current JSON file.
+     * @return The mapped snapshot, or nullptr if there is no valid snapshot for the key.
+     */
+    static QSharedPointer<TreeSnapshot> open(const QString &filePath, const SourceKey &key);
+
+    /**
+     * @brief Destructor for the TreeSnapshot class, unmaps the file.
+     */
+    ~TreeSnapshot();
+
+    /**
+     * @brief Returns the record index of the root node.
+     */
+    static quint32 rootRecord() { return 0; }
+
+    /**
+     * @brief Returns the number of children of a record.
+     *
+     * @param record The record index.
+     */
+    int childCount(quint32 record) const;
+
+    /**
+     * @brief Builds the children of a record as children of `node`.
+     *
+     * Children that have children themselves are recorded in `pending`, so they
+     * can be built when they are expanded.
+     *
+     * @param node The node to append the children to.
+     * @param record The record index of `node`.
+     * @param arena The arena to create the nodes in.
+     * @param pending Receives the record index of every new node with children.
+     */
+    void buildChildren(TreeNode *node, quint32 record, TreeNodeArena &arena,
+                       QHash<const TreeNode *, quint32> &pending) const;
+
+    /**
+     * @brief Converts the subtree of a record back to JSON.
+     *
+     * @param record The record index.
+     */
+    QJsonValue toJson(quint32 record) const;
+
+    /**
+     * @brief On-disk layout of the file header and of one node record (see TreeSnapshot.cpp).
+     */
+    struct Header;
+    struct Record;
+
+private:
+    TreeSnapshot();
+
+    /**
+     * @brief Returns the string with the given index from the string pool.
+     */
+    QString string(quint32 index) const;
+
+    /**
+     * @brief Returns the range of a record's children, clamped to the records in the file.
+     *
+     * A range that does not start after the record itself is treated as empty,
+     * so a corrupt file cannot make the tree walks loop or read past the mapping.
+     *
+     * @param record The record index, must be below the node count.
+     * @param first Receives the first child's index.
+     * @return The index after the last child, equal to `*first` if there are none.
+     */
+    quint32 childRange(quint32 record, quint32 *first) const;
+
+    /**
+     * @brief Returns the value stored in a record, null for objects and arrays.
+     */
+    QJsonValue value(const Record &record) const;
+
+    QFile _file;
+    const uchar *_data;
+    const Header *_header;
+    const Record *_records;
+    const quint32 *_stringOffsets;
+    const QChar *_stringData;
+};
+
+#endif // __TREE_SNAPSHOT_H__
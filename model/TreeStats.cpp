@@ -0,0 +1,159 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeStats.cpp                                                     *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeStats class, call counters and latency            *
+ * histograms for the TreeModel hot paths.                                     *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <cstring>
+#include <QVariantList>
+#include <QtAlgorithms>
+#include "TreeStats.h"
+
+Q_LOGGING_CATEGORY(lcTreeModel, "treeview.model")
+Q_LOGGING_CATEGORY(lcTreeLoad, "treeview.load")
+Q_LOGGING_CATEGORY(lcTreeSave, "treeview.save")
+
+TreeStats::TreeStats()
+{
+    reset();
+}
+
+void TreeStats::record(Call call, qint64 nsecs)
+{
+    Histogram &histogram = _calls[call];
+    const quint64 latency = quint64(qMax<qint64>(0, nsecs));
+
+    ++histogram.calls;
+    histogram.totalNsecs += latency;
+    histogram.maxNsecs = qMax(histogram.maxNsecs, latency);
+
+    const int bucket = 64 - qCountLeadingZeroBits(latency);
+    ++histogram.buckets[qMin(bucket, BUCKETS - 1)];
+}
+
+void TreeStats::recordPhase(const QString &phase, qint64 msecs)
+{
+    _phases[phase] = msecs;
+    qCDebug(lcTreeModel) << "phase" << phase << "took" << msecs << "ms";
+}
+
+void TreeStats::reset()
+{
+    std::memset(_calls, 0, sizeof(_calls));
+    _phases.clear();
+}
+
+QVariantMap TreeStats::toVariantMap() const
+{
+    QVariantMap stats;
+    stats["phases"] = _phases;
+
+    // phases are cheap enough to be timed always, calls only with instrumentation
+    if (!isCompiledIn()) {
+        return stats;
+    }
+
+    for (int call = 0; call < CallCount; ++call) {
+        const Histogram &histogram = _calls[call];
+
+        QVariantList buckets;
+        for (int i = 0; i < BUCKETS; ++i) {
+            buckets.append(histogram.buckets[i]);
+        }
+
+        QVariantMap entry;
+        entry["calls"] = histogram.calls;
+        entry["totalNs"] = histogram.totalNsecs;
+        entry["maxNs"] = histogram.maxNsecs;
+        entry["p50Ns"] = percentile(histogram, 0.5);
+        entry["p99Ns"] = percentile(histogram, 0.99);
+        entry["histogram"] = buckets;
+        stats[callName(Call(call))] = entry;
+    }
+    return stats;
+}
+
+void TreeStats::log() const
+{
+    if (!lcTreeModel().isDebugEnabled()) {
+        return;
+    }
+
+    for (int call = 0; call < CallCount; ++call) {
+        const Histogram &histogram = _calls[call];
+        if (histogram.calls == 0) {
+            continue;
+        }
+        qCDebug(lcTreeModel, "%s: %llu calls, avg %llu ns, p50 < %llu ns, p99 < %llu ns, max %llu ns",
+                callName(Call(call)), histogram.calls, histogram.totalNsecs / histogram.calls,
+                percentile(histogram, 0.5), percentile(histogram, 0.99), histogram.maxNsecs);
+    }
+}
+
+quint64 TreeStats::percentile(const Histogram &histogram, double fraction)
+{
+    if (histogram.calls == 0) {
+        return 0;
+    }
+
+    const quint64 rank = quint64(fraction * histogram.calls);
+    quint64 seen = 0;
+    for (int i = 0; i < BUCKETS; ++i) {
+        seen += histogram.buckets[i];
+        if (seen > rank) {
+            return quint64(1) << i;
+        }
+    }
+    return histogram.maxNsecs;
+}
+
+const char *TreeStats::callName(Call call)
+{
+    switch (call) {
+    case Data:
+        return "data";
+    case Index:
+        return "index";
+    case Parent:
+        return "parent";
+    case RowCount:
+        return "rowCount";
+    case ColumnCount:
+        return "columnCount";
+    case HasChildren:
+        return "hasChildren";
+    case CanFetchMore:
+        return "canFetchMore";
+    case FetchMore:
+        return "fetchMore";
+    case SetData:
+        return "setData";
+    case CallCount:
+        break;
+    }
+    return "";
+}
@@ -0,0 +1,165 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeStats.h                                                       *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeStats class, call counters and latency histograms   *
+ * for the TreeModel hot paths, plus load and save phase timings.              *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_STATS_H__
+#define __TREE_STATS_H__
+
+#include <QString>
+#include <QVariant>
+#include <QElapsedTimer>
+#include <QLoggingCategory>
+
+Q_DECLARE_LOGGING_CATEGORY(lcTreeModel)
+Q_DECLARE_LOGGING_CATEGORY(lcTreeLoad)
+Q_DECLARE_LOGGING_CATEGORY(lcTreeSave)
+
+/**
+ * @brief Times the rest of the enclosing scope as one call.
+ *
+ * Expands to nothing unless the model is built with `qmake CONFIG+=instrumentation`
+ * (which defines TREEVIEW_INSTRUMENTATION), so the hot paths pay nothing by default.
+ */
+#ifdef TREEVIEW_INSTRUMENTATION
+#define TREE_STATS_SCOPE(stats, call) TreeStats::Scope treeStatsScope_(stats, call)
+#else
+#define TREE_STATS_SCOPE(stats, call) do {} while (false)
+#endif
+
+
+class TreeStats
+{
+public:
+    /**
+     * @brief Enum for the instrumented QAbstractItemModel overrides.
+     */
+    enum Call {
+        Data,
+        Index,
+        Parent,
+        RowCount,
+        ColumnCount,
+        HasChildren,
+        CanFetchMore,
+        FetchMore,
+        SetData,
+        CallCount
+    };
+
+    /**
+     * @brief Records the time from its construction to its destruction as one call.
+     */
+    class Scope
+    {
+    public:
+        inline Scope(TreeStats &stats, Call call) : _stats(stats), _call(call) { _timer.start(); }
+        inline ~Scope() { _stats.record(_call, _timer.nsecsElapsed()); }
+
+    private:
+        TreeStats &_stats;
+        Call _call;
+        QElapsedTimer _timer;
+    };
+
+    /**
+     * @brief Constructs empty stats.
+     */
+    TreeStats();
+
+    /**
+     * @brief Returns true if the model is built with instrumentation.
+     */
+    static constexpr bool isCompiledIn() {
+#ifdef TREEVIEW_INSTRUMENTATION
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Records one call and its latency.
+     *
+     * Latencies go into power-of-two buckets, so recording is a few additions.
+     *
+     * @param call The call.
+     * @param nsecs The latency in nanoseconds.
+     */
+    void record(Call call, qint64 nsecs);
+
+    /**
+     * @brief Records the duration of a load or save phase and logs it.
+     *
+     * @param phase The phase, e.g. "load" or "save".
+     * @param msecs The duration in milliseconds.
+     */
+    void recordPhase(const QString &phase, qint64 msecs);
+
+    /**
+     * @brief Clears all counters, histograms and phase timings.
+     */
+    void reset();
+
+    /**
+     * @brief Returns the stats for QML.
+     *
+     * The map has a `phases` map with the last duration of each phase in
+     * milliseconds. With instrumentation compiled in, it also has an entry per
+     * call with `calls`, `totalNs`, `maxNs`, `p50Ns`, `p99Ns` and `histogram`
+     * (call counts per power-of-two nanosecond bucket).
+     */
+    QVariantMap toVariantMap() const;
+
+    /**
+     * @brief Writes a one-line summary per called method to the `treeview.model` category.
+     */
+    void log() const;
+
+private:
+    static const int BUCKETS = 32;
+
+    struct Histogram {
+        quint64 calls;
+        quint64 totalNsecs;
+        quint64 maxNsecs;
+        quint64 buckets[BUCKETS];   // bucket i holds latencies below 2^i ns
+    };
+
+    /**
+     * @brief Returns the upper bound of the bucket holding the given percentile, in nanoseconds.
+     */
+    static quint64 percentile(const Histogram &histogram, double fraction);
+
+    static const char *callName(Call call);
+
+    Histogram _calls[CallCount];
+    QVariantMap _phases;
+};
+
+#endif // __TREE_STATS_H__
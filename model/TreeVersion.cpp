@@ -0,0 +1,283 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeVersion.cpp                                                   *
+ *                                                                             *
+ * Description:                                                                *
+ * Implementation of the TreeVersion class: freezing the tree into immutable,  *
+ * shared nodes, invalidating them along the path of an edit, and reading and  *
+ * writing frozen trees on any thread.                                         *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QJsonArray>
+#include <QJsonObject>
+#include "TreeVersion.h"
+#include "TreeWriter.h"
+#include "JsonPointer.h"
+#include "JsonStreamWriter.h"
+#include "CborDocumentWriter.h"
+#include "MsgPackWriter.h"
+
+TreeVersionNode::TreeVersionNode(const TreeNode *source, Pending &&pending, QVector<Pointer> &&children)
+    : _children(std::move(children)),
+      _name(source->name()),
+      _pending(pending.isNull() ? nullptr : new Pending(std::move(pending))),
+      _type(source->type()),
+      _valueKind(source->valueKind())
+{
+    // the string is shared with the arena's slot, not copied
+    switch (_valueKind) {
+    case TreeNode::BoolValue:
+        _value.boolean = source->boolValue();
+        break;
+    case TreeNode::IntegerValue:
+        _value.integer = source->integerValue();
+        break;
+    case TreeNode::DoubleValue:
+        _value.number = source->doubleValue();
+        break;
+    case TreeNode::StringValue:
+        _string = source->stringValue();
+        _value.integer = 0;
+        break;
+    case TreeNode::NullValue:
+        _value.integer = 0;
+        break;
+    }
+}
+
+QJsonValue TreeVersionNode::pendingValue() const
+{
+    if (!_pending) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+    return _pending->snapshot ? _pending->snapshot->toJson(_pending->record) : _pending->value;
+}
+
+QJsonValue TreeVersionNode::toJson() const
+{
+    struct Frame {
+        const TreeVersionNode *node;
+        int next;
+        QJsonArray array;
+        QJsonObject object;
+    };
+
+    const auto isContainer = [](const TreeVersionNode *node) {
+        return !node->_pending && (node->_type == TreeNode::Array || node->_type == TreeNode::Object);
+    };
+    if (!isContainer(this)) {
+        return leafValue();
+    }
+
+    // depth-first without recursion, like freeze(), deep versions must not overflow the stack
+    QVector<Frame> stack{{this, 0, QJsonArray(), QJsonObject()}};
+    while (true) {
+        Frame &frame = stack.last();
+        const TreeVersionNode *child = nullptr;
+        QJsonValue value;
+        if (frame.next < frame.node->_children.count()) {
+            child = frame.node->_children.at(frame.next++).data();
+            if (isContainer(child)) {
+                stack.append({child, 0, QJsonArray(), QJsonObject()});
+                continue;
+            }
+            value = child->leafValue();
+        } else {
+            child = frame.node;
+            value = child->_type == TreeNode::Array ? QJsonValue(frame.array) : QJsonValue(frame.object);
+            stack.removeLast();
+            if (stack.isEmpty()) {
+                return value;
+            }
+        }
+
+        Frame &parent = stack.last();
+        if (parent.node->_type == TreeNode::Array) {
+            parent.array.append(value);
+        } else {
+            parent.object.insert(child->_name, value);
+        }
+    }
+}
+
+QJsonValue TreeVersionNode::leafValue() const
+{
+    if (_pending) {
+        return pendingValue();
+    }
+
+    switch (_valueKind) {
+    case TreeNode::BoolValue:
+        return QJsonValue(_value.boolean);
+    case TreeNode::IntegerValue:
+        return QJsonValue(_value.integer);
+    case TreeNode::DoubleValue:
+        return QJsonValue(_value.number);
+    case TreeNode::StringValue:
+        return QJsonValue(_string);
+    case TreeNode::NullValue:
+        break;
+    }
+    return QJsonValue(QJsonValue::Null);
+}
+
+TreeVersion::TreeVersion(const Node::Pointer &root)
+    : _root(root)
+{
+}
+
+TreeVersion TreeVersion::freeze(const TreeNode *root, const PendingFunction &pending, Table &table)
+{
+    auto cached = table.constFind(root);
+    if (cached != table.constEnd()) {
+        Node::Pointer shared = cached->toStrongRef();
+        if (shared) {
+            return TreeVersion(shared);
+        }
+        // no version of the tree is left, so no other entry can be shared either
+        table.clear();
+    }
+
+    struct Frame {
+        const TreeNode *node;
+        QVector<Node::Pointer> children;
+        int next;
+    };
+
+    // children first and without recursion, a frozen subtree is reused as a whole
+    QVector<Frame> stack{{root, {}, 0}};
+    stack.last().children.reserve(root->childCount());
+    Node::Pointer frozen;
+
+    while (!stack.isEmpty()) {
+        Frame &frame = stack.last();
+        const QList<TreeNode *> &children = frame.node->children();
+
+        if (frame.next < children.count()) {
+            const TreeNode *child = children.at(frame.next++);
+            Node::Pointer shared = table.value(child).toStrongRef();
+            if (shared) {
+                frame.children.append(std::move(shared));
+            } else {
+                stack.append({child, {}, 0});
+                stack.last().children.reserve(child->childCount());
+            }
+            continue;
+        }
+
+        // allocated apart from its control block, which the table's weak entry keeps
+        frozen = Node::Pointer(new Node(frame.node, pending(frame.node), std::move(frame.children)));
+        table.insert(frame.node, frozen);
+        stack.removeLast();
+        if (!stack.isEmpty()) {
+            stack.last().children.append(frozen);
+        }
+    }
+
+    return TreeVersion(frozen);
+}
+
+void TreeVersion::invalidate(const TreeNode *node, Table &table)
+{
+    for (const TreeNode *ancestor = node; ancestor; ancestor = ancestor->parentNode()) {
+        if (!table.remove(ancestor)) {
+            break;
+        }
+    }
+}
+
+QJsonValue TreeVersion::valueAt(const QString &path) const
+{
+    bool ok = false;
+    const QStringList segments = JsonPointer::split(path, &ok);
+    if (!ok || isNull()) {
+        return QJsonValue(QJsonValue::Undefined);
+    }
+
+    const Node *node = root();
+    int i = 0;
+    for (; i < segments.count() && !node->hasPendingChildren(); ++i) {
+        const QString &segment = segments.at(i);
+        const Node *next = nullptr;
+        if (node->type() == TreeNode::Array) {
+            bool isIndex = false;
+            const int row = segment.toInt(&isIndex);
+            next = isIndex ? node->child(row) : nullptr;
+        } else {
+            // the first member of that name wins, as in JsonPointer::child()
+            for (const Node::Pointer &child : node->children()) {
+                if (child->name() == segment) {
+                    next = child.data();
+                    break;
+                }
+            }
+        }
+        if (!next) {
+            return QJsonValue(QJsonValue::Undefined);
+        }
+        node = next;
+    }
+
+    // the rest of the path leads into children that were not built
+    QJsonValue value = node->toJson();
+    for (; i < segments.count() && !value.isUndefined(); ++i) {
+        const QString &segment = segments.at(i);
+        if (value.isArray()) {
+            bool isIndex = false;
+            const int row = segment.toInt(&isIndex);
+            value = isIndex ? value.toArray().at(row) : QJsonValue(QJsonValue::Undefined);
+        } else if (value.isObject()) {
+            value = value.toObject().value(segment);
+        } else {
+            value = QJsonValue(QJsonValue::Undefined);
+        }
+    }
+    return value;
+}
+
+bool TreeVersion::write(QIODevice *device, DocumentFormat::Format documentFormat, QJsonDocument::JsonFormat format) const
+{
+    if (isNull()) {
+        return false;
+    }
+
+    const auto pendingValue = [](const Node *node) {
+        return node->pendingValue();
+    };
+
+    switch (documentFormat) {
+    case DocumentFormat::Cbor: {
+        CborDocumentWriter writer(device);
+        return TreeWriter::writeNodes(writer, root(), pendingValue);
+    }
+    case DocumentFormat::MessagePack: {
+        MsgPackWriter writer(device);
+        return TreeWriter::writeNodes(writer, root(), pendingValue);
+    }
+    case DocumentFormat::Json:
+        break;
+    }
+    JsonStreamWriter writer(device, format);
+    return TreeWriter::writeNodes(writer, root(), pendingValue);
+}
@@ -0,0 +1,283 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeVersion.h                                                     *
+ *                                                                             *
+ * Description:                                                                *
+ * Header file for the TreeVersion class, an immutable version of the tree     *
+ * that worker threads can read and serialize while the model is edited.       *
+ * Versions share the subtrees that did not change between them, an edit only  *
+ * invalidates the path from the edited node to the root.                      *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_VERSION_H__
+#define __TREE_VERSION_H__
+
+#include <memory>
+#include <functional>
+
+#include <QHash>
+#include <QVector>
+#include <QString>
+#include <QIODevice>
+#include <QJsonValue>
+#include <QJsonDocument>
+#include <QSharedPointer>
+
+#include "TreeNode.h"
+#include "TreeSnapshot.h"
+#include "DocumentFormat.h"
+
+
+/**
+ * @brief A node of a frozen tree.
+ *
+ * Holds a copy of the name and value of the `TreeNode` it was frozen from and
+ * shared pointers to its frozen children. Nothing changes a node once it is
+ * built, so any number of threads can read it without locking, and it stays
+ * valid after the `TreeNode` is edited, removed or its arena released.
+ */
+class TreeVersionNode
+{
+public:
+    using Pointer = QSharedPointer<const TreeVersionNode>;
+
+    /**
+     * @brief The children a node had not built when it was frozen.
+     *
+     * Either the JSON value backing them, or a record of the memory-mapped snapshot
+     * they would be built from, which is only read when the version is.
+     */
+    struct Pending {
+        QJsonValue value = QJsonValue(QJsonValue::Undefined);
+        QSharedPointer<const TreeSnapshot> snapshot;
+        quint32 record = 0;
+
+        /**
+         * @brief Returns true if there are no unbuilt children.
+         */
+        inline bool isNull() const { return value.isUndefined() && !snapshot; }
+    };
+
+    /**
+     * @brief Freezes the name and value of a node with the given children.
+     *
+     * @param source The node to copy.
+     * @param pending The node's unbuilt children, null if it has none.
+     * @param children The frozen children of the node, in order.
+     */
+    TreeVersionNode(const TreeNode *source, Pending &&pending, QVector<Pointer> &&children);
+
+    /**
+     * @brief Returns the name of the node, empty for array elements.
+     */
+    inline const QString &name() const { return _name; }
+
+    /**
+     * @brief Returns the kind of JSON value the node represents.
+     */
+    inline TreeNode::Type type() const { return _type; }
+
+    /**
+     * @brief Returns the JSON type of the value.
+     */
+    inline TreeNode::ValueKind valueKind() const { return _valueKind; }
+
+    /**
+     * @brief Returns the value if it is a bool, false otherwise.
+     */
+    inline bool boolValue() const { return _valueKind == TreeNode::BoolValue && _value.boolean; }
+
+    /**
+     * @brief Returns the value if it is an integer, 0 otherwise.
+     */
+    inline qint64 integerValue() const { return _valueKind == TreeNode::IntegerValue ? _value.integer : 0; }
+
+    /**
+     * @brief Returns the value if it is a number, converting integers, 0 otherwise.
+     */
+    inline double doubleValue() const {
+        return _valueKind == TreeNode::DoubleValue ? _value.number
+                                                   : (_valueKind == TreeNode::IntegerValue ? double(_value.integer) : 0.0);
+    }
+
+    /**
+     * @brief Returns the value if it is a string, an empty string otherwise.
+     */
+    inline const QString &stringValue() const { return _string; }
+
+    /**
+     * @brief Returns the value of the node as a JSON value, the whole subtree for objects and arrays.
+     */
+    QJsonValue toJson() const;
+
+    /**
+     * @brief Returns true if the node had children that were not built when it was frozen.
+     */
+    inline bool hasPendingChildren() const { return bool(_pending); }
+
+    /**
+     * @brief Returns the JSON value backing the children that were not built when
+     * the node was frozen, or an undefined value if they were built.
+     *
+     * Children kept in a memory-mapped snapshot are read from it on every call.
+     */
+    QJsonValue pendingValue() const;
+
+    /**
+     * @brief Returns the frozen children of the node.
+     */
+    inline const QVector<Pointer> &children() const { return _children; }
+
+    /**
+     * @brief Returns the number of frozen children.
+     */
+    inline int childCount() const { return int(_children.count()); }
+
+    /**
+     * @brief Returns the child at the given row, or nullptr if the row is out of range.
+     */
+    inline const TreeVersionNode *child(int row) const { return _children.value(row).data(); }
+
+private:
+    /**
+     * @brief Returns the value of a node that is not written as an object or array:
+     * the JSON backing its unbuilt children, or its scalar value.
+     */
+    QJsonValue leafValue() const;
+
+    union Payload {
+        bool boolean;
+        qint64 integer;
+        double number;
+    };
+
+    QVector<Pointer> _children;
+    QString _name;
+    QString _string;
+    std::unique_ptr<const Pending> _pending;    // only for the few nodes with unbuilt children
+    Payload _value;
+    TreeNode::Type _type;
+    TreeNode::ValueKind _valueKind;
+};
+
+
+class TreeVersion
+{
+public:
+    using Node = TreeVersionNode;
+
+    /**
+     * @brief Frozen nodes of the current tree, keyed by the node they were frozen from.
+     *
+     * The entries are weak: a frozen node lives only as long as a version holds it,
+     * so a tree nobody took a version of keeps no copies. An entry is only valid
+     * while its node and everything below it are unchanged, so whenever a node has
+     * an entry, all of its built descendants have one too.
+     */
+    using Table = QHash<const TreeNode *, QWeakPointer<const Node>>;
+
+    /**
+     * @brief Function returning the unbuilt children of a node, a null `Pending` if it has none.
+     */
+    using PendingFunction = std::function<Node::Pending(const TreeNode *)>;
+
+    /**
+     * @brief Constructs a null version, which has no root.
+     */
+    TreeVersion() = default;
+
+    /**
+     * @brief Returns the version of the tree below `root`.
+     *
+     * Only the nodes without a live entry in `table` are frozen, the others are
+     * shared with the versions still held. While a version is alive, a call copies
+     * the paths to the nodes edited since and, without edits in between, is a single
+     * lookup. Once every version of the tree is gone, the whole tree is frozen again,
+     * O(nodes), and the stale entries are dropped. Must be called on the thread that
+     * owns the tree.
+     *
+     * @param root The root of the tree.
+     * @param pending Returns the unbuilt children of a node.
+     * @param table The frozen nodes of the tree, extended with the new ones.
+     */
+    static TreeVersion freeze(const TreeNode *root, const PendingFunction &pending, Table &table);
+
+    /**
+     * @brief Removes the frozen nodes of a node and its ancestors after the node was edited.
+     *
+     * Stops at the first node without an entry, as its ancestors have none either,
+     * so repeated edits below the same node cost O(1).
+     *
+     * @param node The edited node, or the parent of inserted, removed or moved nodes.
+     * @param table The frozen nodes of its tree.
+     */
+    static void invalidate(const TreeNode *node, Table &table);
+
+    /**
+     * @brief Returns true if the version has no tree, e.g. a default-constructed one.
+     */
+    inline bool isNull() const { return _root.isNull(); }
+
+    /**
+     * @brief Returns the root of the frozen tree, nullptr for a null version.
+     */
+    inline const Node *root() const { return _root.data(); }
+
+    /**
+     * @brief Returns true if both versions share their root, which means they hold the same tree.
+     */
+    inline bool operator==(const TreeVersion &other) const { return _root == other._root; }
+    inline bool operator!=(const TreeVersion &other) const { return _root != other._root; }
+
+    /**
+     * @brief Returns the value addressed by a JSON Pointer path.
+     *
+     * Paths leading into children that were not built when the version was taken
+     * are resolved in the JSON value backing them.
+     *
+     * @param path The path, empty for the whole document.
+     * @return The value, undefined if the path does not resolve.
+     */
+    QJsonValue valueAt(const QString &path) const;
+
+    /**
+     * @brief Writes the version to a device, the same way `TreeModel::writeTree()` writes the tree.
+     *
+     * Can be called on any thread, while the model goes on being edited.
+     *
+     * @param device The device to write to, must be open for writing.
+     * @param documentFormat JSON, CBOR or MessagePack.
+     * @param format Indented or compact output, only used for JSON.
+     * @return False for a null version or if the device refused any of the data.
+     */
+    bool write(QIODevice *device, DocumentFormat::Format documentFormat = DocumentFormat::Json,
+               QJsonDocument::JsonFormat format = QJsonDocument::Indented) const;
+
+private:
+    explicit TreeVersion(const Node::Pointer &root);
+
+    Node::Pointer _root;
+};
+
+#endif // __TREE_VERSION_H__
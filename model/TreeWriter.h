@@ -0,0 +1,148 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: TreeWriter.h                                                      *
+ *                                                                             *
+ * Description:                                                                *
+ * Header-only walk writing a tree of nodes as a document through any of the   *
+ * stream writers (JSON, CBOR, MessagePack), shared by the TreeModel and the   *
+ * immutable tree versions.                                                    *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#ifndef __TREE_WRITER_H__
+#define __TREE_WRITER_H__
+
+#include <QVector>
+#include <QJsonValue>
+
+#include "TreeNode.h"
+#include "JsonStreamWriter.h"
+
+
+namespace TreeWriter
+{
+    /**
+     * @brief Starts an object or array in JSON, which does not need its size.
+     */
+    inline void startContainer(JsonStreamWriter &writer, bool isArray, qsizetype) {
+        if (isArray) {
+            writer.startArray();
+        } else {
+            writer.startObject();
+        }
+    }
+
+    /**
+     * @brief Starts an object or array in a binary format, which writes its size up front.
+     */
+    template <typename Writer>
+    inline void startContainer(Writer &writer, bool isArray, qsizetype size) {
+        if (isArray) {
+            writer.startArray(size);
+        } else {
+            writer.startObject(size);
+        }
+    }
+
+    /**
+     * @brief Writes the tree below `rootNode` as a document through any of the stream writers.
+     *
+     * `Node` is a `TreeNode` or a `TreeVersion::Node`: anything with the name, type
+     * and value accessors of `TreeNode` and a `children()` list of pointers.
+     *
+     * @param pendingValue Returns the JSON value backing a node's unbuilt children,
+     *                     or an undefined value if the node has none.
+     */
+    template <typename Writer, typename Node, typename PendingValue>
+    bool writeNodes(Writer &writer, const Node *rootNode, const PendingValue &pendingValue) {
+        // writes a node, returns true if it was opened as an object or array
+        const auto open = [&writer, &pendingValue](const Node *node) {
+            const QJsonValue pending = pendingValue(node);
+            if (!pending.isUndefined()) {
+                // children were never built, the original JSON value is still up to date
+                writer.jsonValue(pending);
+                return false;
+            }
+            if (node->type() == TreeNode::Value && node->children().isEmpty()) {
+                switch (node->valueKind()) {
+                case TreeNode::BoolValue:
+                    writer.boolValue(node->boolValue());
+                    break;
+                case TreeNode::IntegerValue:
+                    writer.integerValue(node->integerValue());
+                    break;
+                case TreeNode::DoubleValue:
+                    writer.doubleValue(node->doubleValue());
+                    break;
+                case TreeNode::StringValue:
+                    writer.stringValue(node->stringValue());
+                    break;
+                case TreeNode::NullValue:
+                    writer.nullValue();
+                    break;
+                }
+                return false;
+            }
+            startContainer(writer, node->type() == TreeNode::Array, node->children().count());
+            return true;
+        };
+
+        struct Frame {
+            const Node *node;
+            int next;
+        };
+
+        // depth-first without recursion, deep documents must not overflow the stack
+        QVector<Frame> stack;
+        startContainer(writer, rootNode->type() == TreeNode::Array, rootNode->children().count());
+        stack.append({rootNode, 0});
+
+        while (!stack.isEmpty()) {
+            Frame &frame = stack.last();
+            const auto &children = frame.node->children();
+
+            if (frame.next == children.count()) {
+                if (frame.node->type() == TreeNode::Array) {
+                    writer.endArray();
+                } else {
+                    writer.endObject();
+                }
+                stack.removeLast();
+                continue;
+            }
+
+            // a raw pointer or a shared pointer, depending on the kind of node
+            const Node *child = &*children.at(frame.next++);
+            if (frame.node->type() != TreeNode::Array) {
+                writer.key(child->name());
+            }
+            if (open(child)) {
+                stack.append({child, 0});
+            }
+        }
+
+        return writer.finish();
+    }
+}
+
+#endif // __TREE_WRITER_H__
@@ -0,0 +1,79 @@
+# The tree model, shared by the app and the benchmarks
+
+QT += concurrent
+
+INCLUDEPATH += $$PWD
+
+# call counters and latency histograms for the model, enabled with `qmake CONFIG+=instrumentation`
+instrumentation: DEFINES += TREEVIEW_INSTRUMENTATION
+
+# warnings as errors for the model and whatever includes it, with `qmake CONFIG+=werror`
+werror {
+    msvc: QMAKE_CXXFLAGS_WARN_ON += -WX
+    else: QMAKE_CXXFLAGS_WARN_ON += -Wextra -Werror
+}
+
+# gzip support for *.gz documents; Zstandard for *.zst documents where pkg-config finds libzstd
+LIBS += -lz
+packagesExist(libzstd) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += libzstd
+    DEFINES += TREEVIEW_ZSTD
+}
+
+SOURCES += \
+        $$PWD/CborDocumentReader.cpp \
+        $$PWD/CborDocumentWriter.cpp \
+        $$PWD/CompressedDevice.cpp \
+        $$PWD/DocumentFormat.cpp \
+        $$PWD/JsonLinesFile.cpp \
+        $$PWD/JsonPointer.cpp \
+        $$PWD/JsonStreamReader.cpp \
+        $$PWD/JsonStreamWriter.cpp \
+        $$PWD/MsgPackReader.cpp \
+        $$PWD/MsgPackWriter.cpp \
+        $$PWD/NamePool.cpp \
+        $$PWD/TreeAggregates.cpp \
+        $$PWD/TreeFilterProxyModel.cpp \
+        $$PWD/TreeHash.cpp \
+        $$PWD/TreeJournal.cpp \
+        $$PWD/TreeListModel.cpp \
+        $$PWD/TreeLoader.cpp \
+        $$PWD/TreeModel.cpp \
+        $$PWD/TreeNode.cpp \
+        $$PWD/TreeNodeArena.cpp \
+        $$PWD/TreePathIndex.cpp \
+        $$PWD/TreeSaver.cpp \
+        $$PWD/TreeSearchIndex.cpp \
+        $$PWD/TreeSnapshot.cpp \
+        $$PWD/TreeStats.cpp \
+        $$PWD/TreeVersion.cpp
+
+HEADERS += \
+    $$PWD/CborDocumentReader.h \
+    $$PWD/CborDocumentWriter.h \
+    $$PWD/CompressedDevice.h \
+    $$PWD/DocumentFormat.h \
+    $$PWD/JsonLinesFile.h \
+    $$PWD/JsonPointer.h \
+    $$PWD/JsonStreamReader.h \
+    $$PWD/JsonStreamWriter.h \
+    $$PWD/MsgPackReader.h \
+    $$PWD/MsgPackWriter.h \
+    $$PWD/NamePool.h \
+    $$PWD/TreeAggregates.h \
+    $$PWD/TreeFilterProxyModel.h \
+    $$PWD/TreeHash.h \
+    $$PWD/TreeJournal.h \
+    $$PWD/TreeListModel.h \
+    $$PWD/TreeLoader.h \
+    $$PWD/TreeModel.h \
+    $$PWD/TreeNode.h \
+    $$PWD/TreeNodeArena.h \
+    $$PWD/TreePathIndex.h \
+    $$PWD/TreeSaver.h \
+    $$PWD/TreeSearchIndex.h \
+    $$PWD/TreeSnapshot.h \
+    $$PWD/TreeStats.h \
+    $$PWD/TreeVersion.h \
+    $$PWD/TreeWriter.h
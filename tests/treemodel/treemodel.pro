@@ -0,0 +1,11 @@
+QT += testlib gui concurrent
+
+CONFIG += c++11 testcase
+CONFIG -= app_bundle
+
+TARGET = tst_treemodel
+
+include(../../model/model.pri)
+
+SOURCES += \
+        tst_treemodel.cpp
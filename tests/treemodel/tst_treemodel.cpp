@@ -0,0 +1,740 @@
+/*******************************************************************************
+ *                                                                             *
+ * Project: QtQmlTreeView Demo using a custom json to populate the tree        *
+ * Filename: tst_treemodel.cpp                                                 *
+ *                                                                             *
+ * Description:                                                                *
+ * Correctness tests for TreeModel and TreeListModel, one group per feature,   *
+ * run headless by make check.                                                 *
+ *                                                                             *
+ * Author(s): Navi Singh                                                       *
+ * License: GPL-3.0 License                                                    *
+ * Copyright (c) 2025 Navi Singh                                               *
+ *                                                                             *
+ * This file is part of QtQmlTreeView Demo.                                    *
+ *                                                                             *
+ * QtQmlTreeView Demo is free software: you can redistribute it and/or modify  *
+ * it under the terms of the GNU General Public License as published by        *
+ * the Free Software Foundation, either version 3 of the License, or           *
+ * (at your option) any later version.                                         *
+ *                                                                             *
+ * QtQmlTreeView Demo is distributed in the hope that it will be useful,       *
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ * GNU General Public License for more details.                                *
+ *                                                                             *
+ * You should have received a copy of the GNU General Public License           *
+ * along with QtQmlTreeView Demo. If not, see <https://www.gnu.org/licenses/>. *
+ *                                                                             *
+ ******************************************************************************/
+
+#include <QtTest>
+#include <QFile>
+#include <QBuffer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <QTemporaryDir>
+#include <QGuiApplication>
+#include "TreeListModel.h"
+#include "TreeModel.h"
+
+// how long a watched model may take to notice and merge a change of its file
+static const int RELOAD_TIMEOUT = 5000;
+
+namespace {
+
+/**
+ * @brief Returns the nodes a flat list shows when the given nodes are expanded,
+ * in row order.
+ */
+QVector<const TreeNode *> visibleNodes(const TreeModel &model, const QSet<const TreeNode *> &expanded,
+                                       const QModelIndex &parent = QModelIndex())
+{
+    QVector<const TreeNode *> nodes;
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        const QModelIndex index = model.index(row, 0, parent);
+        const TreeNode *node = model.nodeAt(index);
+        nodes.append(node);
+        if (expanded.contains(node)) {
+            nodes += visibleNodes(model, expanded, index);
+        }
+    }
+    return nodes;
+}
+
+/**
+ * @brief Returns the number of ancestors of a node below the root.
+ */
+int depthOf(const TreeNode *node)
+{
+    int depth = 0;
+    for (const TreeNode *current = node->parentNode(); current && current->parentNode(); current = current->parentNode()) {
+        ++depth;
+    }
+    return depth;
+}
+
+} // namespace
+
+class tst_TreeModel : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void journalReplay();
+    void compactWhileLoading();
+    void snapshotWhileLoading();
+    void versions();
+    void typeColumn();
+    void lazyAggregates();
+    void searchIndex();
+    void pathIndex();
+    void duplicateNames();
+    void reload();
+    void reloadOverJournal();
+    void reloadArray();
+    void serializeArrayRoot();
+    void numbers();
+    void insertAfterCancel();
+    void moveRows();
+    void listRows();
+
+private:
+    /**
+     * @brief Writes a document to a file of the temporary directory and returns its path.
+     */
+    QString writeDocument(const QString &name, const QByteArray &json);
+
+    /**
+     * @brief Compares every row of the list with the rows expected for the expanded nodes.
+     */
+    void compareRows(const TreeModel &model, const TreeListModel &list, const QSet<const TreeNode *> &expanded);
+
+    /**
+     * @brief Returns the sorted paths of the given nodes.
+     */
+    static QStringList pathsOf(const TreeModel &model, const QVector<const TreeNode *> &nodes);
+
+    QTemporaryDir _dir;
+};
+
+void tst_TreeModel::initTestCase()
+{
+    QVERIFY(_dir.isValid());
+}
+
+QString tst_TreeModel::writeDocument(const QString &name, const QByteArray &json)
+{
+    const QString path = _dir.filePath(name);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) || file.write(json) != json.size()) {
+        return QString();
+    }
+    return path;
+}
+
+void tst_TreeModel::compareRows(const TreeModel &model, const TreeListModel &list, const QSet<const TreeNode *> &expanded)
+{
+    const QVector<const TreeNode *> expected = visibleNodes(model, expanded);
+    QCOMPARE(list.rowCount(), expected.count());
+    for (int row = 0; row < expected.count(); ++row) {
+        QCOMPARE(list.nodeAt(row), expected.at(row));
+        QCOMPARE(list.rowOf(expected.at(row)), row);
+        QCOMPARE(list.data(list.index(row), TreeListModel::DepthRole).toInt(), depthOf(expected.at(row)));
+        QCOMPARE(list.isExpanded(row), expanded.contains(expected.at(row)));
+    }
+    QVERIFY(!list.nodeAt(expected.count()));
+}
+
+QStringList tst_TreeModel::pathsOf(const TreeModel &model, const QVector<const TreeNode *> &nodes)
+{
+    QStringList paths;
+    for (const TreeNode *node : nodes) {
+        paths.append(model.pathForIndex(model.indexOf(node)));
+    }
+    paths.sort();
+    return paths;
+}
+
+void tst_TreeModel::journalReplay()
+{
+    const QByteArray json = R"({"a": [1, 2, 3], "b": {"c": "text"}})";
+    const QString path = writeDocument(QStringLiteral("journal.json"), json);
+    QVERIFY(!path.isEmpty());
+
+    {
+        TreeModel model(path);
+        model.setPersistenceMode(TreeModel::Journal);
+        QVERIFY(model.setData(model.indexForPath(QStringLiteral("/a/1")), 20, Qt::EditRole));
+        QVERIFY(model.setData(model.indexForPath(QStringLiteral("/b/c")), QStringLiteral("edited"), Qt::EditRole));
+        QVERIFY(model.setData(model.indexForPath(QStringLiteral("/a/1")), 200, Qt::EditRole));
+
+        // the edits went to the journal, the document is untouched
+        QVERIFY(QFile::exists(path + QStringLiteral(".journal")));
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadOnly));
+        QCOMPARE(file.readAll(), json);
+    }
+
+    // the last edit of each path wins when the journal is replayed
+    TreeModel model(path);
+    QCOMPARE(model.valueAt(QStringLiteral("/a/1")).toLongLong(), qint64(200));
+    QCOMPARE(model.valueAt(QStringLiteral("/b/c")).toString(), QStringLiteral("edited"));
+    QCOMPARE(model.valueAt(QStringLiteral("/a/0")).toLongLong(), qint64(1));
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("edited"))), QStringList({QStringLiteral("/b/c")}));
+}
+
+void tst_TreeModel::compactWhileLoading()
+{
+    const QByteArray json = R"({"a": 1})";
+    const QString path = writeDocument(QStringLiteral("loading.json"), json);
+    QVERIFY(!path.isEmpty());
+    const QString journalPath = path + QStringLiteral(".journal");
+
+    {
+        TreeModel model(path);
+        model.setPersistenceMode(TreeModel::Journal);
+        QVERIFY(model.setData(model.indexForPath(QStringLiteral("/a")), 2, Qt::EditRole));
+    }
+    QVERIFY(QFile::exists(journalPath));
+
+    const auto fileContents = [&path]() {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    };
+
+    // switching to write-behind compacts, which must wait for the real tree;
+    // the loading flag only drops once the event loop delivers the result
+    {
+        TreeModel model(path, TreeModel::Asynchronous);
+        QVERIFY(model.isLoading());
+        model.setPersistenceMode(TreeModel::Journal);
+        model.setPersistenceMode(TreeModel::WriteBehind);
+        model.flush();
+        QVERIFY(!model.isDirty());
+        QVERIFY(!model.isSaving());
+    }
+    QCOMPARE(fileContents(), json);
+    QVERIFY(QFile::exists(journalPath));
+
+    // and the journal is still there to be replayed once the load is done
+    TreeModel model(path, TreeModel::Asynchronous);
+    model.setPersistenceMode(TreeModel::Journal);
+    model.setPersistenceMode(TreeModel::WriteBehind);
+    QTRY_VERIFY(!model.isLoading());
+    QCOMPARE(fileContents(), json);
+    QCOMPARE(model.valueAt(QStringLiteral("/a")).toLongLong(), qint64(2));
+}
+
+void tst_TreeModel::snapshotWhileLoading()
+{
+    const QString path = writeDocument(QStringLiteral("versioned.json"), R"({"a": 1})");
+    QVERIFY(!path.isEmpty());
+
+    // the empty tree shown while loading is not the document
+    TreeModel model(path, TreeModel::Asynchronous);
+    QVERIFY(model.isLoading());
+    QVERIFY(model.snapshot().isNull());
+
+    QTRY_VERIFY(!model.isLoading());
+    const TreeVersion version = model.snapshot();
+    QVERIFY(!version.isNull());
+    QCOMPARE(version.valueAt(QStringLiteral("/a")).toInt(), 1);
+}
+
+void tst_TreeModel::versions()
+{
+    const QByteArray json = R"({"list": ["one", "two"], "count": 2})";
+    const QString path = writeDocument(QStringLiteral("versions.json"), json);
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+
+    // nothing is frozen before the first version is asked for
+    QCOMPARE(model.memoryStats()["frozenNodes"].toInt(), 0);
+    const TreeVersion first = model.snapshot();
+    QVERIFY(!first.isNull());
+    QVERIFY(model.snapshot() == first);
+
+    QVERIFY(model.setData(model.indexForPath(QStringLiteral("/list/1")), QStringLiteral("changed"), Qt::EditRole));
+    QVERIFY(model.removeRows(0, 1, model.indexForPath(QStringLiteral("/list"))));
+    const TreeVersion second = model.snapshot();
+    QVERIFY(second != first);
+
+    // a version keeps the tree as it was taken, whatever the model does later
+    QCOMPARE(first.valueAt(QStringLiteral("/list/1")), QJsonValue(QStringLiteral("two")));
+    QCOMPARE(second.valueAt(QStringLiteral("/list/0")), QJsonValue(QStringLiteral("changed")));
+    QVERIFY(second.valueAt(QStringLiteral("/list/1")).isUndefined());
+
+    QByteArray written;
+    QBuffer buffer(&written);
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(first.write(&buffer));
+    QCOMPARE(QJsonDocument::fromJson(written), QJsonDocument::fromJson(json));
+
+    // untouched subtrees are shared between the versions
+    QCOMPARE(first.valueAt(QStringLiteral("/count")), second.valueAt(QStringLiteral("/count")));
+
+    // once no version is held the copies are gone, and the next one is frozen afresh
+    TreeModel other(writeDocument(QStringLiteral("dropped.json"), json));
+    QVERIFY(!other.snapshot().isNull());
+    QVERIFY(other.setData(other.indexForPath(QStringLiteral("/count")), 3, Qt::EditRole));
+    const TreeVersion fresh = other.snapshot();
+    QCOMPARE(fresh.valueAt(QStringLiteral("/count")).toInt(), 3);
+    QCOMPARE(fresh.valueAt(QStringLiteral("/list/1")), QJsonValue(QStringLiteral("two")));
+}
+
+void tst_TreeModel::typeColumn()
+{
+    const QString path = writeDocument(QStringLiteral("types.json"),
+                                       R"({"mixed": [1, "a", [true]], "ints": [1, 2], "empty": {}})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path, TreeModel::Aggregates);
+
+    const auto typeAt = [&model](const QString &pointer) {
+        const QModelIndex index = model.indexForPath(pointer);
+        return model.data(index.siblingAtColumn(TreeNode::TypeColumn), Qt::DisplayRole).toString();
+    };
+    QCOMPARE(typeAt(QStringLiteral("/mixed")), QStringLiteral("array of bool, integer, string"));
+    QCOMPARE(typeAt(QStringLiteral("/ints")), QStringLiteral("array of integer"));
+    QCOMPARE(typeAt(QStringLiteral("/empty")), QStringLiteral("object"));
+    QCOMPARE(typeAt(QStringLiteral("/mixed/1")), QStringLiteral("string"));
+
+    // edits move a leaf from one kind to another, and the change is announced
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QVERIFY(model.setData(model.indexForPath(QStringLiteral("/ints/0")), QStringLiteral("s"), Qt::EditRole));
+    QCOMPARE(typeAt(QStringLiteral("/ints")), QStringLiteral("array of integer, string"));
+    QVERIFY(model.setData(model.indexForPath(QStringLiteral("/ints/1")), QStringLiteral("t"), Qt::EditRole));
+    QCOMPARE(typeAt(QStringLiteral("/ints")), QStringLiteral("array of string"));
+    const QModelIndex ints = model.indexForPath(QStringLiteral("/ints")).siblingAtColumn(TreeNode::TypeColumn);
+    bool announced = false;
+    for (const QList<QVariant> &arguments : std::as_const(changed)) {
+        const QModelIndex topLeft = arguments.at(0).toModelIndex();
+        const QModelIndex bottomRight = arguments.at(1).toModelIndex();
+        announced |= topLeft.parent() == ints.parent() && topLeft.row() <= ints.row() && bottomRight.row() >= ints.row()
+                     && topLeft.column() <= ints.column() && bottomRight.column() >= ints.column();
+    }
+    QVERIFY(announced);
+
+    // so do structural edits, below nested containers too
+    QVERIFY(model.removeRows(2, 1, model.indexForPath(QStringLiteral("/mixed"))));
+    QCOMPARE(typeAt(QStringLiteral("/mixed")), QStringLiteral("array of integer, string"));
+    QVERIFY(model.insertMembers(QStringLiteral("/empty"), {{QStringLiteral("n"), QVariantList{QVariant(), 1.5}}}));
+    QCOMPARE(typeAt(QStringLiteral("/empty")), QStringLiteral("object of null, double"));
+    QCOMPARE(model.data(model.indexForPath(QStringLiteral("/empty")).siblingAtColumn(TreeNode::DescendantCountColumn),
+                        Qt::DisplayRole).toInt(), 3);
+
+    // the blocks only exist in this mode
+    QVERIFY(model.memoryStats()["aggregateBytes"].toLongLong() > 0);
+    TreeModel plain(path);
+    QCOMPARE(plain.memoryStats()["aggregateBytes"].toLongLong(), qint64(0));
+}
+
+void tst_TreeModel::lazyAggregates()
+{
+    const QByteArray json = R"({"a": {"b": [1, "x", {"c": true}], "d": null}, "e": [[2], []]})";
+    const QString path = writeDocument(QStringLiteral("lazy-aggregates.json"), json);
+    QVERIFY(!path.isEmpty());
+
+    TreeModel built(path, TreeModel::Aggregates);
+    TreeModel lazy(path, TreeModel::Lazy | TreeModel::Aggregates);
+
+    const auto columnAt = [](TreeModel &model, const QString &pointer, int column) {
+        return model.data(model.indexForPath(pointer).siblingAtColumn(column), Qt::DisplayRole);
+    };
+
+    // the unbuilt children are counted from their JSON value, as if they were built
+    const QJsonObject a = QJsonDocument::fromJson(json).object().value(QStringLiteral("a")).toObject();
+    const QByteArray compact = QJsonDocument(a).toJson(QJsonDocument::Compact);
+    for (const QString &pointer : {QStringLiteral("/a"), QStringLiteral("/e")}) {
+        QVERIFY(lazy.canFetchMore(lazy.indexForPath(pointer)));
+        for (int column = TreeNode::DescendantCountColumn; column <= TreeNode::TypeColumn; ++column) {
+            QCOMPARE(columnAt(lazy, pointer, column), columnAt(built, pointer, column));
+        }
+    }
+    QCOMPARE(columnAt(lazy, QStringLiteral("/a"), TreeNode::JsonSizeColumn).toLongLong(), qint64(compact.size()));
+
+    // fetching builds what was counted already, nothing changes
+    lazy.fetchMore(lazy.indexForPath(QStringLiteral("/a")));
+    QCOMPARE(columnAt(lazy, QStringLiteral("/a"), TreeNode::DescendantCountColumn).toInt(), 6);
+    QCOMPARE(columnAt(lazy, QStringLiteral("/a"), TreeNode::TypeColumn),
+             columnAt(built, QStringLiteral("/a"), TreeNode::TypeColumn));
+}
+
+void tst_TreeModel::searchIndex()
+{
+    const QString path = writeDocument(QStringLiteral("search.json"),
+                                       R"({"list": ["needle one", "hay", "NEEDLE two"], "needleKey": 1})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+
+    // nothing is indexed until the first search
+    QCOMPARE(model.memoryStats()["searchIndexNodes"].toInt(), 0);
+
+    // names and values match, case-insensitively
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("needle"))),
+             QStringList({QStringLiteral("/list/0"), QStringLiteral("/list/2"), QStringLiteral("/needleKey")}));
+    QVERIFY(model.findNodes(QStringLiteral("straw")).isEmpty());
+
+    // edits replace the old value in the index
+    QVERIFY(model.setData(model.indexForPath(QStringLiteral("/list/1")), QStringLiteral("more needles"), Qt::EditRole));
+    QVERIFY(model.setData(model.indexForPath(QStringLiteral("/list/0")), QStringLiteral("straw"), Qt::EditRole));
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("needle"))),
+             QStringList({QStringLiteral("/list/1"), QStringLiteral("/list/2"), QStringLiteral("/needleKey")}));
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("straw"))), QStringList({QStringLiteral("/list/0")}));
+
+    // removed subtrees are gone from it, inserted ones are found
+    QVERIFY(model.removeRows(0, 3, model.indexForPath(QStringLiteral("/list"))));
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("needle"))), QStringList({QStringLiteral("/needleKey")}));
+    QVERIFY(model.insertValues(QStringLiteral("/list"), 0, {QStringLiteral("a needle")}));
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("needle"))),
+             QStringList({QStringLiteral("/list/0"), QStringLiteral("/needleKey")}));
+}
+
+void tst_TreeModel::pathIndex()
+{
+    const QString path = writeDocument(QStringLiteral("paths.json"),
+                                       R"({"a": {"b/c": [1, {"d~e": true}]}, "f": []})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+
+    // nothing is indexed until the first lookup
+    QCOMPARE(model.memoryStats()["pathIndexNodes"].toInt(), 0);
+
+    // escaped names resolve both ways
+    const QPersistentModelIndex nested = model.indexForPath(QStringLiteral("/a/b~1c/1/d~0e"));
+    QVERIFY(nested.isValid());
+    QCOMPARE(model.data(nested, TreeModel::NameRole).toString(), QStringLiteral("d~e"));
+    QCOMPARE(model.pathForIndex(nested), QStringLiteral("/a/b~1c/1/d~0e"));
+    QVERIFY(!model.indexForPath(QStringLiteral("/a/missing")).isValid());
+    QVERIFY(!model.indexForPath(QStringLiteral("/a/b~1c/2")).isValid());
+    QVERIFY(!model.indexForPath(QString()).isValid());
+
+    // every index maps to a path that leads back to it
+    QVector<QModelIndex> stack{QModelIndex()};
+    while (!stack.isEmpty()) {
+        const QModelIndex parent = stack.takeLast();
+        for (int row = 0; row < model.rowCount(parent); ++row) {
+            const QModelIndex index = model.index(row, 0, parent);
+            QCOMPARE(model.indexForPath(model.pathForIndex(index)), index);
+            stack.append(index);
+        }
+    }
+
+    // inserted and removed nodes come and go from the index
+    QVERIFY(model.insertValues(QStringLiteral("/f"), -1, {1, 2}));
+    QCOMPARE(model.valueAt(QStringLiteral("/f/1")).toInt(), 2);
+    QVERIFY(model.insertMembers(QStringLiteral("/a"), {{QStringLiteral("g"), QStringLiteral("h")}}));
+    QCOMPARE(model.valueAt(QStringLiteral("/a/g")).toString(), QStringLiteral("h"));
+    QCOMPARE(model.removePaths({QStringLiteral("/a/b~1c/0")}), 1);
+    QCOMPARE(model.pathForIndex(nested), QStringLiteral("/a/b~1c/0/d~0e"));
+    QCOMPARE(model.indexForPath(QStringLiteral("/a/b~1c/0/d~0e")), QModelIndex(nested));
+    QVERIFY(!model.indexForPath(QStringLiteral("/a/b~1c/1")).isValid());
+}
+
+void tst_TreeModel::duplicateNames()
+{
+    const QString path = writeDocument(QStringLiteral("duplicates.json"),
+                                       R"({"a": {"x": 1}, "a": {"x": 2, "y": 3}, "b": 4, "b": 5})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+
+    // the first of the repeated names is found, and nothing below the others
+    QCOMPARE(model.valueAt(QStringLiteral("/a/x")).toInt(), 1);
+    QVERIFY(!model.indexForPath(QStringLiteral("/a/y")).isValid());
+    QCOMPARE(model.valueAt(QStringLiteral("/b")).toInt(), 4);
+
+    // once it is removed, the next one takes over its path and those below it
+    QCOMPARE(model.removePaths({QStringLiteral("/a")}), 1);
+    QCOMPARE(model.valueAt(QStringLiteral("/a/x")).toInt(), 2);
+    QCOMPARE(model.valueAt(QStringLiteral("/a/y")).toInt(), 3);
+    const QModelIndex b = model.indexForPath(QStringLiteral("/b"));
+    QVERIFY(model.removeRows(b.row(), 1, QModelIndex()));
+    QCOMPARE(model.valueAt(QStringLiteral("/b")).toInt(), 5);
+    QCOMPARE(model.pathForIndex(model.indexForPath(QStringLiteral("/b"))), QStringLiteral("/b"));
+}
+
+void tst_TreeModel::reload()
+{
+    const QString path = writeDocument(QStringLiteral("reload.json"),
+                                       R"({"keep": {"a": 1, "b": [1, 2, 3]}, "edit": "old", "gone": true})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path, TreeModel::Watched);
+
+    const QPersistentModelIndex kept = model.indexForPath(QStringLiteral("/keep/b/2"));
+    QVERIFY(kept.isValid());
+    QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    QVERIFY(!writeDocument(QStringLiteral("reload.json"),
+                           R"({"keep": {"a": 1, "b": [1, 2, 3]}, "edit": "new value", "added": [4]})").isEmpty());
+    QTRY_COMPARE_WITH_TIMEOUT(model.valueAt(QStringLiteral("/edit")).toString(), QStringLiteral("new value"), RELOAD_TIMEOUT);
+
+    // only what differs was updated, the rest of the tree and its indexes stay
+    QCOMPARE(reset.count(), 0);
+    QVERIFY(removed.count() > 0);
+    QVERIFY(inserted.count() > 0);
+    QVERIFY(kept.isValid());
+    QCOMPARE(model.pathForIndex(kept), QStringLiteral("/keep/b/2"));
+    QVERIFY(!model.valueAt(QStringLiteral("/gone")).isValid());
+    QCOMPARE(model.valueAt(QStringLiteral("/added/0")).toInt(), 4);
+    QVERIFY(model.indexForPath(QStringLiteral("/added")).isValid());
+    QCOMPARE(pathsOf(model, model.findNodes(QStringLiteral("new value"))), QStringList({QStringLiteral("/edit")}));
+    QVERIFY(model.findNodes(QStringLiteral("gone")).isEmpty());
+    QVERIFY(!model.isDirty());
+}
+
+void tst_TreeModel::reloadOverJournal()
+{
+    const QString path = writeDocument(QStringLiteral("reloadjournal.json"), R"({"a": 1, "b": 2})");
+    QVERIFY(!path.isEmpty());
+
+    {
+        TreeModel model(path, TreeModel::Watched);
+        model.setPersistenceMode(TreeModel::Journal);
+        QVERIFY(model.setData(model.indexForPath(QStringLiteral("/a")), 10, Qt::EditRole));
+        QVERIFY(QFile::exists(path + QStringLiteral(".journal")));
+
+        // the file wins, and the journaled edit it replaced is dropped
+        QVERIFY(!writeDocument(QStringLiteral("reloadjournal.json"), R"({"a": 3, "b": 40})").isEmpty());
+        QTRY_COMPARE_WITH_TIMEOUT(model.valueAt(QStringLiteral("/b")).toInt(), 40, RELOAD_TIMEOUT);
+        QCOMPARE(model.valueAt(QStringLiteral("/a")).toInt(), 3);
+        QVERIFY(!QFile::exists(path + QStringLiteral(".journal")));
+    }
+
+    // nothing is replayed over the file on the next load
+    TreeModel reopened(path);
+    QCOMPARE(reopened.valueAt(QStringLiteral("/a")).toInt(), 3);
+    QCOMPARE(reopened.valueAt(QStringLiteral("/b")).toInt(), 40);
+}
+
+void tst_TreeModel::reloadArray()
+{
+    const QString path = writeDocument(QStringLiteral("reloadarray.json"),
+                                       R"({"list": [{"a": 1}, 2, 3, [4, 5]], "n": 1})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path, TreeModel::Watched);
+
+    const QPersistentModelIndex object = model.indexForPath(QStringLiteral("/list/0"));
+    QVERIFY(object.isValid());
+    QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+    QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+    QVERIFY(!writeDocument(QStringLiteral("reloadarray.json"),
+                           R"({"list": [0, {"a": 1}, 2, 3, [4, 5]], "n": 2})").isEmpty());
+    QTRY_COMPARE_WITH_TIMEOUT(model.valueAt(QStringLiteral("/n")).toInt(), 2, RELOAD_TIMEOUT);
+
+    // the new element is inserted in front, the others are kept and move down
+    QCOMPARE(inserted.count(), 1);
+    QCOMPARE(removed.count(), 0);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(model.pathForIndex(object), QStringLiteral("/list/1"));
+    QCOMPARE(model.valueAt(QStringLiteral("/list/0")).toInt(), 0);
+    QCOMPARE(model.valueAt(QStringLiteral("/list/4/1")).toInt(), 5);
+    QCOMPARE(model.rowCount(model.indexForPath(QStringLiteral("/list"))), 5);
+}
+
+void tst_TreeModel::serializeArrayRoot()
+{
+    // the records of a JSON Lines file are the elements of an array root
+    const QString path = writeDocument(QStringLiteral("records.jsonl"), "{\"a\": 1}\n[2, 3]\n\"text\"\n");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+
+    const QJsonDocument expected = QJsonDocument::fromJson(R"([{"a": 1}, [2, 3], "text"])");
+    QCOMPARE(model.serializeTreeToJson(), expected);
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(model.writeTree(&buffer));
+    QCOMPARE(QJsonDocument::fromJson(buffer.data()), expected);
+}
+
+void tst_TreeModel::numbers()
+{
+    // integers beyond 2^53 stay exact, unlike with QJsonDocument
+    const QString path = writeDocument(QStringLiteral("numbers.json"),
+                                       R"({"big": 9007199254740993, "zero": 0, "real": -0.5e-3})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+    QCOMPARE(model.valueAt(QStringLiteral("/big")).toLongLong(), Q_INT64_C(9007199254740993));
+    QCOMPARE(model.valueAt(QStringLiteral("/zero")).toLongLong(), Q_INT64_C(0));
+    QCOMPARE(model.valueAt(QStringLiteral("/real")).toDouble(), -0.0005);
+
+    // numbers outside the JSON grammar make the document malformed, which loads as an empty tree
+    const QList<QByteArray> malformed = {R"({"a": 01})", R"({"a": -})", R"({"a": 1.})", R"({"a": .5})",
+                                         R"({"a": +1})", R"({"a": 1e})", R"({"a": 1-2})"};
+    for (const QByteArray &json : malformed) {
+        const QString malformedPath = writeDocument(QStringLiteral("malformed.json"), json);
+        QVERIFY(!malformedPath.isEmpty());
+        TreeModel malformedModel(malformedPath);
+        QVERIFY2(malformedModel.rowCount() == 0, json.constData());
+    }
+}
+
+void tst_TreeModel::insertAfterCancel()
+{
+    // large enough that the worker is still busy when the cancel arrives
+    QByteArray json = "{\"items\": [0";
+    for (int i = 1; i < 200000; ++i) {
+        json += ", " + QByteArray::number(i);
+    }
+    json += "]}";
+    const QString path = writeDocument(QStringLiteral("cancel.json"), json);
+    QVERIFY(!path.isEmpty());
+
+    TreeModel model(path, TreeModel::Asynchronous);
+    QVERIFY(model.isLoading());
+    model.cancelLoading();
+    QTRY_VERIFY(!model.isLoading());
+    if (model.rowCount() > 0) {
+        QSKIP("the load finished before it could be cancelled");
+    }
+
+    // the placeholder is not the document, nothing may be added to it
+    QVERIFY(!model.insertMembers(QString(), {{QStringLiteral("added"), 1}}));
+    QVERIFY(!model.insertValues(QStringLiteral("/items"), -1, {1}));
+    QVERIFY(!model.insertRows(0, 1));
+    QCOMPARE(model.rowCount(), 0);
+}
+
+void tst_TreeModel::moveRows()
+{
+    const QString path = writeDocument(QStringLiteral("move.json"),
+                                       R"({"items": [10, 20, 30, 40], "a": {"x": 1}, "b": {"y": 2, "x": 3}, "c": {"d": {}}})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+
+    // within a parent, the rows land before the destination row
+    const QModelIndex items = model.indexForPath(QStringLiteral("/items"));
+    QVERIFY(model.moveRows(items, 0, 1, items, 3));
+    QCOMPARE(model.valueAt(QStringLiteral("/items")).toList(), QVariantList({20, 30, 10, 40}));
+    QVERIFY(model.moveRows(items, 2, 2, items, 0));
+    QCOMPARE(model.valueAt(QStringLiteral("/items")).toList(), QVariantList({10, 40, 20, 30}));
+    for (int row = 0; row < model.rowCount(items); ++row) {
+        const QModelIndex index = model.index(row, 0, items);
+        QCOMPARE(model.indexForPath(model.pathForIndex(index)), index);
+    }
+
+    // to another object, unless a member of the same name is there
+    const QModelIndex a = model.indexForPath(QStringLiteral("/a"));
+    const QModelIndex b = model.indexForPath(QStringLiteral("/b"));
+    QVERIFY(!model.moveRows(a, 0, 1, b, 0));
+    const int y = model.indexForPath(QStringLiteral("/b/y")).row();
+    QVERIFY(model.moveRows(b, y, 1, a, 1));
+    QCOMPARE(model.valueAt(QStringLiteral("/a/y")).toInt(), 2);
+    QVERIFY(!model.indexForPath(QStringLiteral("/b/y")).isValid());
+    QCOMPARE(model.rowCount(b), 1);
+
+    // never below itself, nor between objects and arrays
+    const QModelIndex c = model.indexForPath(QStringLiteral("/c"));
+    QVERIFY(!model.moveRows(QModelIndex(), c.row(), 1, model.indexForPath(QStringLiteral("/c/d")), 0));
+    QVERIFY(!model.moveRows(a, 0, 1, items, 0));
+    QCOMPARE(model.valueAt(QStringLiteral("/items")).toList(), QVariantList({10, 40, 20, 30}));
+}
+
+void tst_TreeModel::listRows()
+{
+    const QString path = writeDocument(QStringLiteral("list.json"),
+                                       R"({"a": [[1, 2], [3, [4, 5]]], "b": {"c": {"d": 1}}, "e": 3})");
+    QVERIFY(!path.isEmpty());
+    TreeModel model(path);
+    TreeListModel list(&model);
+    QSet<const TreeNode *> expanded;
+
+    const auto expand = [&](const QString &pointer) {
+        const TreeNode *node = model.nodeAt(model.indexForPath(pointer));
+        list.expand(list.rowOf(node));
+        expanded.insert(node);
+    };
+    const auto collapse = [&](const QString &pointer) {
+        const TreeNode *node = model.nodeAt(model.indexForPath(pointer));
+        list.collapse(list.rowOf(node));
+        expanded.remove(node);
+    };
+
+    compareRows(model, list, expanded);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // nested expansions, and a collapsed node shows its expanded descendants again
+    const QStringList steps = {QStringLiteral("+/a"), QStringLiteral("+/a/1"), QStringLiteral("+/a/1/1"),
+                               QStringLiteral("-/a"), QStringLiteral("+/a"), QStringLiteral("+/b"),
+                               QStringLiteral("+/b/c"), QStringLiteral("-/b"), QStringLiteral("+/a/0")};
+    for (const QString &step : steps) {
+        if (step.startsWith(QLatin1Char('+'))) {
+            expand(step.mid(1));
+        } else {
+            collapse(step.mid(1));
+        }
+        compareRows(model, list, expanded);
+        if (QTest::currentTestFailed()) {
+            qWarning() << "[WARNING] :: rows differ after" << step;
+            return;
+        }
+    }
+
+    // the counts follow the edits of the tree model
+    QVERIFY(model.insertValues(QStringLiteral("/a/1/1"), -1, {6, 7}));
+    compareRows(model, list, expanded);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    expanded.remove(model.nodeAt(model.indexForPath(QStringLiteral("/a/0"))));
+    QVERIFY(model.removeRows(0, 1, model.indexForPath(QStringLiteral("/a"))));
+    compareRows(model, list, expanded);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QVERIFY(model.moveRows(QModelIndex(), model.indexForPath(QStringLiteral("/e")).row(), 1, QModelIndex(), 0));
+    compareRows(model, list, expanded);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+    QVERIFY(model.setData(model.indexForPath(QStringLiteral("/a/0/1/0")), 40, Qt::EditRole));
+    compareRows(model, list, expanded);
+    if (QTest::currentTestFailed()) {
+        return;
+    }
+
+    // everything, then nothing
+    list.expandRecursively();
+    int nodes = 0;
+    QVector<QModelIndex> stack{QModelIndex()};
+    while (!stack.isEmpty()) {
+        const QModelIndex parent = stack.takeLast();
+        for (int row = 0; row < model.rowCount(parent); ++row) {
+            const QModelIndex index = model.index(row, 0, parent);
+            ++nodes;
+            if (model.rowCount(index) > 0) {
+                expanded.insert(model.nodeAt(index));
+            }
+            stack.append(index);
+        }
+    }
+    QCOMPARE(list.rowCount(), nodes);
+    for (int row = 0; row < nodes; ++row) {
+        QCOMPARE(list.rowOf(list.nodeAt(row)), row);
+    }
+    list.collapseAll();
+    compareRows(model, list, QSet<const TreeNode *>());
+}
+
+int main(int argc, char *argv[])
+{
+    // the model needs no display, so the tests also run on machines without one
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
+    QGuiApplication app(argc, argv);
+    tst_TreeModel test;
+    QTEST_SET_MAIN_SOURCE_PATH
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_treemodel.moc"